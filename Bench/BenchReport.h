@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Tech3C/Tech3CJson.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tech3c {
+namespace bench {
+
+    using Clock = std::chrono::steady_clock;
+
+    inline int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    // Samples of one measurement, summarised as percentiles in the report
+    struct Result {
+        std::string name;
+        std::string unit;
+        std::vector<std::pair<std::string, int64_t>> params;
+        std::vector<double> samples;
+
+        Result(std::string n, std::string u = "ns") : name(std::move(n)), unit(std::move(u)) {}
+
+        Result& param(const std::string& key, int64_t value) {
+            params.emplace_back(key, value);
+            return *this;
+        }
+    };
+
+    // Collects results and writes them as JSON, one result per line so releases diff cleanly
+    class Report {
+    public:
+        void setMeta(const std::string& key, const std::string& value) { m_meta.emplace_back(key, value); }
+        void add(Result&& result) { m_results.push_back(std::move(result)); }
+        const std::vector<Result>& getResults() const { return m_results; }
+
+        std::string toJson() const {
+            std::string out = "{\n  \"meta\": {";
+            std::string meta = "{";
+            for (const auto& entry : m_meta) {
+                json::appendField(meta, entry.first, entry.second);
+            }
+            out += meta.substr(1);
+            out += "},\n  \"results\": [\n";
+
+            for (size_t i = 0; i < m_results.size(); ++i) {
+                out += "    " + resultToJson(m_results[i]);
+                out += (i + 1 < m_results.size()) ? ",\n" : "\n";
+            }
+            out += "  ]\n}\n";
+            return out;
+        }
+
+        bool write(const std::string& path) const {
+            std::string text = toJson();
+            if (path.empty() || path == "-") {
+                std::fwrite(text.data(), 1, text.size(), stdout);
+                return true;
+            }
+            FILE* file = std::fopen(path.c_str(), "wb");
+            if (!file) {
+                return false;
+            }
+            bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+            return std::fclose(file) == 0 && ok;
+        }
+
+    private:
+        static double percentile(const std::vector<double>& sorted, double p) {
+            if (sorted.empty()) {
+                return 0.0;
+            }
+            size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+            return sorted[std::min(index, sorted.size() - 1)];
+        }
+
+        static void appendNumber(std::string& out, const char* key, double value) {
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), ",\"%s\":%.1f", key, value);
+            out += buffer;
+        }
+
+        static std::string resultToJson(const Result& result) {
+            std::vector<double> sorted = result.samples;
+            std::sort(sorted.begin(), sorted.end());
+            double sum = 0.0;
+            for (double sample : sorted) {
+                sum += sample;
+            }
+
+            std::string out = "{";
+            json::appendField(out, "name", result.name);
+            json::appendField(out, "unit", result.unit);
+            for (const auto& param : result.params) {
+                json::appendInt(out, param.first, param.second);
+            }
+            json::appendInt(out, "samples", static_cast<int64_t>(sorted.size()));
+            appendNumber(out, "min", sorted.empty() ? 0.0 : sorted.front());
+            appendNumber(out, "p50", percentile(sorted, 0.50));
+            appendNumber(out, "p90", percentile(sorted, 0.90));
+            appendNumber(out, "p99", percentile(sorted, 0.99));
+            appendNumber(out, "max", sorted.empty() ? 0.0 : sorted.back());
+            appendNumber(out, "mean", sorted.empty() ? 0.0 : sum / static_cast<double>(sorted.size()));
+            out += "}";
+            return out;
+        }
+
+        std::vector<std::pair<std::string, std::string>> m_meta;
+        std::vector<Result> m_results;
+    };
+
+    // Runs op batchSize times per sample and records the mean cost of one call in ns,
+    // so calls cheaper than the clock resolution still get a meaningful distribution
+    template<typename Op>
+    void timeBatches(Result& result, size_t batches, size_t batchSize, Op&& op) {
+        result.param("batchSize", static_cast<int64_t>(batchSize));
+        result.samples.reserve(result.samples.size() + batches);
+        size_t counter = 0;
+        for (size_t b = 0; b < batches; ++b) {
+            int64_t start = nowNs();
+            for (size_t i = 0; i < batchSize; ++i) {
+                op(counter++);
+            }
+            result.samples.push_back(static_cast<double>(nowNs() - start) / static_cast<double>(batchSize));
+        }
+    }
+}
+}
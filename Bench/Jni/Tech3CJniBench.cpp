@@ -0,0 +1,414 @@
+// tech3c_jni_bench: the Android JNI bridge against a desktop JVM, what tech3c_bench cannot time.
+//
+//   tech3c_jni_bench [--classpath dir-or-jar] [--out results.json] [--filter substring] [--quick]
+//
+// Starts a JVM through the invocation API on Tech3CChannel.java and Tech3CJniBenchTarget.java (a
+// stand-in for Tech3CHelper, which needs the Android SDK) and registers the natives the game
+// registers on Android. Results use tech3c_bench's JSON format:
+//
+//   jni.call.lookup, jni.call.cached        one bridge call, resolving class and method per call
+//                                           (JniHelper::getStaticMethodInfo) or through the IDs
+//                                           JniMethodRegistry caches
+//   jni.configBurst.lookup, .cached         the startup config burst, one call per setter
+//   jni.event.perCall, jni.event.channel    a login event per native call with three jstrings,
+//                                           or through the Tech3CChannel ring read once a frame
+//
+// On a device getStaticMethodInfo also goes through the app class loader, so the lookup numbers
+// here are a lower bound of what the cache saves there.
+
+#include "../BenchReport.h"
+#include "Tech3C/Tech3CSession.h"
+#include "Tech3C/Tech3CBridgeChannel.h"
+#include <jni.h>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+
+using namespace tech3c;
+using namespace tech3c::bench;
+
+#ifndef TECH3C_JNI_BENCH_CLASSPATH
+#define TECH3C_JNI_BENCH_CLASSPATH "tech3c_jni_bench_classes.jar"
+#endif
+
+namespace {
+
+    struct Options {
+        std::string classpath = TECH3C_JNI_BENCH_CLASSPATH;
+        std::string outPath;
+        std::string filter;
+        bool quick = false;
+    };
+
+    struct Context {
+        Options options;
+        Report report;
+        bool failed = false;     // The harness could not run a benchmark
+
+        bool enabled(const std::string& name) const {
+            return options.filter.empty() || name.find(options.filter) != std::string::npos;
+        }
+
+        size_t scaled(size_t count) const {
+            return options.quick ? std::max<size_t>(count / 10, 1) : count;
+        }
+    };
+
+    const char* TARGET_CLASS_NAME = "dev/axmol/lib/Tech3CJniBenchTarget";
+    const char* CHANNEL_CLASS_NAME = "dev/axmol/lib/Tech3CChannel";
+
+    // Token sizes in the range the SDK hands back for real accounts, as in tech3c_bench
+    const std::string BENCH_USER_ID = "bench-user-0000000001";
+    const std::string BENCH_ACCESS_TOKEN(900, 'a');
+    const std::string BENCH_REFRESH_TOKEN(300, 'r');
+
+    // Receives the events the natives below hand over, dispatched by hand
+    Tech3CSession* s_session = nullptr;
+    jclass s_channelClass = nullptr;
+    jfieldID s_eventTail = nullptr;
+    jfieldID s_eventHead = nullptr;
+
+    bool checkException(JNIEnv* env, const char* what) {
+        if (!env->ExceptionCheck()) {
+            return true;
+        }
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        std::fprintf(stderr, "tech3c_jni_bench: %s threw\n", what);
+        return false;
+    }
+
+    //--------------------------------------------------------------------
+    // The natives, as Tech3CManager.cpp and Tech3CSession::readChannelEvents() implement them
+
+    std::string toString(JNIEnv* env, jstring value) {
+        if (!value) {
+            return std::string();
+        }
+        const char* chars = env->GetStringUTFChars(value, nullptr);
+        std::string result(chars ? chars : "");
+        env->ReleaseStringUTFChars(value, chars);
+        return result;
+    }
+
+    void JNICALL nativeOnLoginSuccess(JNIEnv* env, jclass, jstring userId, jstring accessToken, jstring refreshToken,
+                                      jint loginType, jlong expiryTime) {
+        std::string userIdStr = toString(env, userId);
+        std::string accessTokenStr = toString(env, accessToken);
+        std::string refreshTokenStr = toString(env, refreshToken);
+        s_session->onLoginSuccess(userIdStr, accessTokenStr, refreshTokenStr, loginType, expiryTime);
+    }
+
+    void JNICALL nativeDispatch(JNIEnv*, jclass) {
+        s_session->dispatchPendingEvents();
+    }
+
+    jboolean JNICALL nativeAttach(JNIEnv* env, jclass, jobject events, jobject commands) {
+        void* eventData = env->GetDirectBufferAddress(events);
+        void* commandData = env->GetDirectBufferAddress(commands);
+        const jlong eventCapacity = env->GetDirectBufferCapacity(events);
+        const jlong commandCapacity = env->GetDirectBufferCapacity(commands);
+        if (!eventData || !commandData || eventCapacity <= 0 || commandCapacity <= 0) {
+            return JNI_FALSE;
+        }
+        return BridgeChannel::getInstance().attach(eventData, static_cast<size_t>(eventCapacity),
+                                                   commandData, static_cast<size_t>(commandCapacity))
+                ? JNI_TRUE : JNI_FALSE;
+    }
+
+    void JNICALL nativeFlushEvents(JNIEnv* env, jclass) {
+        ChannelReader& events = BridgeChannel::getInstance().getEvents();
+        const jlong tail = env->GetStaticLongField(s_channelClass, s_eventTail);
+        if (static_cast<uint64_t>(tail) == events.getHead()) {
+            return;
+        }
+        const uint64_t head = events.read(static_cast<uint64_t>(tail),
+                                          [](ChannelFields& fields) { s_session->onChannelEvent(fields); });
+        env->SetStaticLongField(s_channelClass, s_eventHead, static_cast<jlong>(head));
+    }
+
+    bool registerNatives(JNIEnv* env, jclass target) {
+        const JNINativeMethod targetMethods[] = {
+            { const_cast<char*>("nativeOnLoginSuccess"),
+              const_cast<char*>("(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;IJ)V"),
+              reinterpret_cast<void*>(nativeOnLoginSuccess) },
+            { const_cast<char*>("nativeDispatch"), const_cast<char*>("()V"), reinterpret_cast<void*>(nativeDispatch) },
+        };
+        const JNINativeMethod channelMethods[] = {
+            { const_cast<char*>("nativeAttach"), const_cast<char*>("(Ljava/nio/ByteBuffer;Ljava/nio/ByteBuffer;)Z"),
+              reinterpret_cast<void*>(nativeAttach) },
+            { const_cast<char*>("nativeFlushEvents"), const_cast<char*>("()V"), reinterpret_cast<void*>(nativeFlushEvents) },
+        };
+        return env->RegisterNatives(target, targetMethods, 2) == JNI_OK
+                && env->RegisterNatives(s_channelClass, channelMethods, 2) == JNI_OK
+                && checkException(env, "RegisterNatives");
+    }
+
+    //--------------------------------------------------------------------
+    // Bridge calls: native -> Java
+
+    // The startup burst, in the order pushConfigLocked() makes the calls
+    struct SetterCall {
+        const char* name;
+        const char* signature;
+    };
+
+    const SetterCall CONFIG_BURST[] = {
+        { "setDebugMode", "(Z)V" },
+        { "setUiMode", "(I)V" },
+        { "setLanguage", "(I)V" },
+        { "setOrientation", "(I)V" },
+        { "setEnableGuestLogin", "(Z)V" },
+        { "setDisableExitLogin", "(Z)V" },
+        { "setRequireOtp", "(Z)V" },
+        { "setEnableMaintenanceCheck", "(Z)V" },
+        { "setIpMaintenanceCheck", "(Ljava/lang/String;)V" },
+        { "setEnableRequireBOD", "(Z)V" },
+    };
+    constexpr size_t CONFIG_BURST_SIZE = sizeof(CONFIG_BURST) / sizeof(CONFIG_BURST[0]);
+
+    // One setter call with an argument of its signature; ip is passed to the string one
+    void callSetter(JNIEnv* env, jclass clazz, jmethodID method, const SetterCall& setter, jstring ip) {
+        switch (setter.signature[1]) {
+            case 'Z':
+                env->CallStaticVoidMethod(clazz, method, static_cast<jboolean>(JNI_TRUE));
+                break;
+            case 'I':
+                env->CallStaticVoidMethod(clazz, method, static_cast<jint>(1));
+                break;
+            default:
+                env->CallStaticVoidMethod(clazz, method, ip);
+                break;
+        }
+    }
+
+    // Per call: what every setter did before JniMethodRegistry (FindClass, GetStaticMethodID, the
+    // call, DeleteLocalRef), against the call alone through the cached global ref and method ID
+    void benchBridgeCalls(Context& ctx, JNIEnv* env, jclass target) {
+        const size_t batches = ctx.scaled(200);
+        const size_t batchSize = 100;
+        const SetterCall showAuth = { "showAuth", "()V" };
+        const jmethodID showAuthMethod = env->GetStaticMethodID(target, showAuth.name, showAuth.signature);
+        jmethodID burstMethods[CONFIG_BURST_SIZE];
+        for (size_t i = 0; i < CONFIG_BURST_SIZE; ++i) {
+            burstMethods[i] = env->GetStaticMethodID(target, CONFIG_BURST[i].name, CONFIG_BURST[i].signature);
+        }
+        const jmethodID callsMethod = env->GetStaticMethodID(target, "calls", "()I");
+        if (!checkException(env, "GetStaticMethodID")) {
+            ctx.failed = true;
+            return;
+        }
+        jstring ip = env->NewStringUTF("127.0.0.1");
+
+        auto lookupCall = [&]() {
+            jclass clazz = env->FindClass(TARGET_CLASS_NAME);
+            jmethodID method = env->GetStaticMethodID(clazz, showAuth.name, showAuth.signature);
+            env->CallStaticVoidMethod(clazz, method);
+            env->DeleteLocalRef(clazz);
+        };
+        auto cachedCall = [&]() { env->CallStaticVoidMethod(target, showAuthMethod); };
+        auto lookupBurst = [&]() {
+            for (const SetterCall& setter : CONFIG_BURST) {
+                jclass clazz = env->FindClass(TARGET_CLASS_NAME);
+                jmethodID method = env->GetStaticMethodID(clazz, setter.name, setter.signature);
+                callSetter(env, clazz, method, setter, ip);
+                env->DeleteLocalRef(clazz);
+            }
+        };
+        auto cachedBurst = [&]() {
+            for (size_t i = 0; i < CONFIG_BURST_SIZE; ++i) {
+                callSetter(env, target, burstMethods[i], CONFIG_BURST[i], ip);
+            }
+        };
+
+        // Let the JIT settle on both paths before anything is timed
+        for (size_t i = 0; i < 20000; ++i) {
+            lookupCall();
+            cachedCall();
+        }
+
+        struct CallCase {
+            const char* name;
+            size_t callsPerOp;
+            std::function<void()> op;
+        };
+        const CallCase cases[] = {
+            { "jni.call.lookup", 1, lookupCall },
+            { "jni.call.cached", 1, cachedCall },
+            { "jni.configBurst.lookup", CONFIG_BURST_SIZE, lookupBurst },
+            { "jni.configBurst.cached", CONFIG_BURST_SIZE, cachedBurst },
+        };
+        for (const CallCase& callCase : cases) {
+            if (!ctx.enabled(callCase.name)) {
+                continue;
+            }
+            const jint before = env->CallStaticIntMethod(target, callsMethod);
+            Result result(callCase.name);
+            timeBatches(result, batches, batchSize, [&](size_t) { callCase.op(); });
+            const jint calls = env->CallStaticIntMethod(target, callsMethod) - before;
+            if (!checkException(env, callCase.name)
+                    || static_cast<size_t>(calls) != batches * batchSize * callCase.callsPerOp) {
+                std::fprintf(stderr, "tech3c_jni_bench: %s made %d of its Java calls\n", callCase.name, (int)calls);
+                ctx.failed = true;
+                continue;
+            }
+            ctx.report.add(std::move(result.param("javaCallsPerOp", (int64_t)callCase.callsPerOp)));
+        }
+        env->DeleteLocalRef(ip);
+    }
+
+    //--------------------------------------------------------------------
+    // SDK events: Java -> native
+
+    // Java loops over the events and times them (Tech3CJniBenchTarget.perCallEvents / channelEvents),
+    // a few per frame like an auth flow produces them; samples are ns per event
+    void benchEvents(Context& ctx, JNIEnv* env, jclass target) {
+        const size_t frames = ctx.scaled(2000);
+        const jint eventsPerFrame = 8;
+        const char* signature = "(ILjava/lang/String;Ljava/lang/String;Ljava/lang/String;)J";
+        const jmethodID perCall = env->GetStaticMethodID(target, "perCallEvents", signature);
+        const jmethodID channel = env->GetStaticMethodID(target, "channelEvents", signature);
+        const jmethodID attach = env->GetStaticMethodID(s_channelClass, "attach", "()Z");
+        if (!checkException(env, "GetStaticMethodID")) {
+            ctx.failed = true;
+            return;
+        }
+        if (!env->CallStaticBooleanMethod(s_channelClass, attach) || !checkException(env, "Tech3CChannel.attach")) {
+            std::fprintf(stderr, "tech3c_jni_bench: Tech3CChannel did not attach\n");
+            ctx.failed = true;
+            return;
+        }
+
+        jstring userId = env->NewStringUTF(BENCH_USER_ID.c_str());
+        jstring accessToken = env->NewStringUTF(BENCH_ACCESS_TOKEN.c_str());
+        jstring refreshToken = env->NewStringUTF(BENCH_REFRESH_TOKEN.c_str());
+
+        size_t delivered = 0;
+        s_session->setLoginSuccessCallback([&delivered](const UserInfo& user) {
+            delivered += user.getAccessToken().size() == BENCH_ACCESS_TOKEN.size();
+        });
+
+        // Warm up both paths, then time them
+        for (size_t i = 0; i < 2000; ++i) {
+            env->CallStaticLongMethod(target, perCall, eventsPerFrame, userId, accessToken, refreshToken);
+            env->CallStaticLongMethod(target, channel, eventsPerFrame, userId, accessToken, refreshToken);
+        }
+        for (const char* name : { "jni.event.perCall", "jni.event.channel" }) {
+            if (!ctx.enabled(name)) {
+                continue;
+            }
+            const jmethodID method = std::strcmp(name, "jni.event.perCall") == 0 ? perCall : channel;
+            Result result(name);
+            result.samples.reserve(frames);
+            delivered = 0;
+            for (size_t frame = 0; frame < frames; ++frame) {
+                const jlong elapsed = env->CallStaticLongMethod(target, method, eventsPerFrame, userId, accessToken,
+                                                                refreshToken);
+                result.samples.push_back(static_cast<double>(elapsed) / eventsPerFrame);
+            }
+            if (!checkException(env, name) || delivered != frames * eventsPerFrame) {
+                std::fprintf(stderr, "tech3c_jni_bench: %s delivered %zu of %zu logins\n", name, delivered,
+                             frames * eventsPerFrame);
+                ctx.failed = true;
+                continue;
+            }
+            ctx.report.add(std::move(result.param("eventsPerFrame", eventsPerFrame)
+                    .param("accessTokenBytes", (int64_t)BENCH_ACCESS_TOKEN.size())));
+        }
+        s_session->setLoginSuccessCallback(nullptr);
+
+        env->DeleteLocalRef(userId);
+        env->DeleteLocalRef(accessToken);
+        env->DeleteLocalRef(refreshToken);
+    }
+
+    bool parseArgs(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--classpath" && i + 1 < argc) {
+                options.classpath = argv[++i];
+            } else if (arg == "--out" && i + 1 < argc) {
+                options.outPath = argv[++i];
+            } else if (arg == "--filter" && i + 1 < argc) {
+                options.filter = argv[++i];
+            } else if (arg == "--quick") {
+                options.quick = true;
+            } else {
+                std::fprintf(stderr, "usage: %s [--classpath dir-or-jar] [--out results.json] [--filter substring] [--quick]\n",
+                             argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    Context ctx;
+    if (!parseArgs(argc, argv, ctx.options)) {
+        return 2;
+    }
+
+    std::string classpathOption = "-Djava.class.path=" + ctx.options.classpath;
+    JavaVMOption vmOptions[] = { { const_cast<char*>(classpathOption.c_str()), nullptr } };
+    JavaVMInitArgs vmArgs;
+    vmArgs.version = JNI_VERSION_1_8;
+    vmArgs.nOptions = 1;
+    vmArgs.options = vmOptions;
+    vmArgs.ignoreUnrecognized = JNI_FALSE;
+    JavaVM* vm = nullptr;
+    JNIEnv* env = nullptr;
+    if (JNI_CreateJavaVM(&vm, reinterpret_cast<void**>(&env), &vmArgs) != JNI_OK) {
+        std::fprintf(stderr, "tech3c_jni_bench: cannot start a JVM\n");
+        return 1;
+    }
+
+    jclass target = static_cast<jclass>(env->NewGlobalRef(env->FindClass(TARGET_CLASS_NAME)));
+    s_channelClass = static_cast<jclass>(env->NewGlobalRef(env->FindClass(CHANNEL_CLASS_NAME)));
+    if (!checkException(env, "FindClass") || !target || !s_channelClass) {
+        std::fprintf(stderr, "tech3c_jni_bench: Tech3CJniBenchTarget / Tech3CChannel not on %s\n",
+                     ctx.options.classpath.c_str());
+        return 1;
+    }
+    s_eventTail = env->GetStaticFieldID(s_channelClass, "sEventTail", "J");
+    s_eventHead = env->GetStaticFieldID(s_channelClass, "sEventHead", "J");
+    if (!checkException(env, "GetStaticFieldID") || !registerNatives(env, target)) {
+        return 1;
+    }
+
+    ctx.report.setMeta("suite", "tech3c_jni_bench");
+    ctx.report.setMeta("schemaVersion", "1");
+    ctx.report.setMeta("jniVersion", std::to_string(env->GetVersion()));
+    ctx.report.setMeta("quick", ctx.options.quick ? "true" : "false");
+
+    // A session of its own, dispatched by the Java loops through nativeDispatch
+#if TECH3C_DESKTOP_BACKEND
+    SessionHost::setStandInServerEnabled(true);
+#endif
+    SessionOptions options;
+    options.dispatchOnFrame = false;
+    std::unique_ptr<Tech3CSession> session(new Tech3CSession(options));
+    session->applyConfig(ConfigBuilder().debugMode(false).enableMaintenanceCheck(false).build());
+    if (!session->initialize("3cgame", "bench-secret")) {
+        std::fprintf(stderr, "tech3c_jni_bench: initialize failed\n");
+        return 1;
+    }
+    s_session = session.get();
+
+    benchBridgeCalls(ctx, env, target);
+    benchEvents(ctx, env, target);
+
+    session->cleanup();
+    s_session = nullptr;
+    env->DeleteGlobalRef(target);
+    env->DeleteGlobalRef(s_channelClass);
+    vm->DestroyJavaVM();
+
+    if (!ctx.report.write(ctx.options.outPath)) {
+        std::fprintf(stderr, "tech3c_jni_bench: failed to write %s\n", ctx.options.outPath.c_str());
+        return 1;
+    }
+    return ctx.failed ? 3 : 0;
+}
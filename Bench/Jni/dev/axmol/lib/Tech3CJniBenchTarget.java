@@ -0,0 +1,69 @@
+package dev.axmol.lib;
+
+/**
+ * Stand-in for Tech3CHelper on a desktop JVM, driven by tech3c_jni_bench (Tech3CJniBench.cpp).
+ * Tech3CHelper needs the Android SDK; this has the signatures of its bridge methods with empty
+ * bodies, so the bench times the JNI call alone, and the SDK callback side handing login events
+ * to native code, per call or through Tech3CChannel like Tech3CHelper does.
+ */
+public final class Tech3CJniBenchTarget {
+    // Bridge calls made, the bench checks every one arrived
+    static int sCalls = 0;
+
+    // Registered by tech3c_jni_bench: Tech3CHelper.nativeOnLoginSuccess, and the frame drain
+    private static native void nativeOnLoginSuccess(String userId, String accessToken, String refreshToken,
+                                                    int loginType, long expiryTime);
+    private static native void nativeDispatch();
+
+    private Tech3CJniBenchTarget() {
+    }
+
+    public static void setDebugMode(boolean debug) { ++sCalls; }
+    public static void setUiMode(int mode) { ++sCalls; }
+    public static void setLanguage(int language) { ++sCalls; }
+    public static void setOrientation(int orientation) { ++sCalls; }
+    public static void setEnableGuestLogin(boolean enable) { ++sCalls; }
+    public static void setDisableExitLogin(boolean disable) { ++sCalls; }
+    public static void setRequireOtp(boolean require) { ++sCalls; }
+    public static void setEnableMaintenanceCheck(boolean enable) { ++sCalls; }
+    public static void setIpMaintenanceCheck(String ip) { ++sCalls; }
+    public static void setEnableRequireBOD(boolean enable) { ++sCalls; }
+    public static void showAuth() { ++sCalls; }
+
+    static int calls() {
+        return sCalls;
+    }
+
+    /**
+     * count login events through the per-event native method, then one dispatch outside the time.
+     * @return nanoseconds spent handing the events over
+     */
+    static long perCallEvents(int count, String userId, String accessToken, String refreshToken) {
+        final long start = System.nanoTime();
+        for (int i = 0; i < count; ++i) {
+            nativeOnLoginSuccess(userId, accessToken, refreshToken, 1, 0);
+        }
+        final long elapsed = System.nanoTime() - start;
+        nativeDispatch();
+        return elapsed;
+    }
+
+    /**
+     * The same events through Tech3CChannel, as Tech3CHelper posts them, and the read native code
+     * makes once per frame (flush() here), then one dispatch outside the time.
+     * @return nanoseconds spent handing the events over
+     */
+    static long channelEvents(int count, String userId, String accessToken, String refreshToken) {
+        final long start = System.nanoTime();
+        for (int i = 0; i < count; ++i) {
+            if (!Tech3CChannel.postLoginSuccess(userId, accessToken, refreshToken, 1, 0)) {
+                Tech3CChannel.flush();
+                nativeOnLoginSuccess(userId, accessToken, refreshToken, 1, 0);
+            }
+        }
+        Tech3CChannel.flush();
+        final long elapsed = System.nanoTime() - start;
+        nativeDispatch();
+        return elapsed;
+    }
+}
@@ -0,0 +1,1316 @@
+// tech3c_bench: micro benchmarks for the Tech3C bridge and callback path.
+//
+//   tech3c_bench [--out results.json] [--filter substring] [--quick]
+//
+// Results are written as JSON (stdout by default) so runs from two SDK releases can be diffed.
+// The bench runs on sessions of its own (dispatchOnFrame off, a temporary session file) and drains
+// SDK events itself through Tech3CSession::dispatchPendingEvents() exactly like the per-frame
+// drain does, so the axmol scheduler and the game's tech3c_session.bin are never touched.
+
+#include "axmol.h"
+#include "BenchReport.h"
+#include "Tech3C/Tech3CManager.h"
+#include "Tech3C/Tech3CBridgeChannel.h"
+#include "Tech3C/Tech3CDesktopBackend.h"
+#include "Tech3C/Tech3CSessionStore.h"
+#include <array>
+#include <cstring>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <new>
+#include <thread>
+
+using namespace tech3c;
+using namespace tech3c::bench;
+
+//------------------------------------------------------------------------
+// Allocation counting: every allocation goes through these, only the thread inside an
+// AllocationCounter scope is counted so SDK threads do not add noise
+
+namespace {
+    thread_local bool t_countAllocations = false;
+    thread_local uint64_t t_allocations = 0;
+
+    void* countedAlloc(size_t size) {
+        if (t_countAllocations) {
+            ++t_allocations;
+        }
+        if (void* p = std::malloc(size ? size : 1)) {
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+    struct Options {
+        std::string outPath;
+        std::string filter;
+        bool quick = false;
+    };
+
+    struct Context {
+        Options options;
+        Report report;
+        bool failed = false;     // A benchmark that doubles as a check did not hold
+
+        bool enabled(const std::string& name) const {
+            return options.filter.empty() || name.find(options.filter) != std::string::npos;
+        }
+
+        size_t scaled(size_t count) const {
+            return options.quick ? std::max<size_t>(count / 10, 1) : count;
+        }
+    };
+
+    const char* CLIENT_ID = "3cgame";
+    const char* CLIENT_SECRET = "bench-secret";
+
+    // Token sizes in the range the SDK hands back for real accounts
+    const std::string BENCH_USER_ID = "bench-user-0000000001";
+    const std::string BENCH_ACCESS_TOKEN(900, 'a');
+    const std::string BENCH_REFRESH_TOKEN(300, 'r');
+
+    const char* platformName() {
+#if AX_TARGET_PLATFORM == AX_PLATFORM_LINUX
+        return "linux";
+#elif AX_TARGET_PLATFORM == AX_PLATFORM_MAC
+        return "mac";
+#elif AX_TARGET_PLATFORM == AX_PLATFORM_WIN32
+        return "win32";
+#else
+        return "other";
+#endif
+    }
+
+    const char* compilerName() {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc";
+#else
+        return "unknown";
+#endif
+    }
+
+    // Quiet, known-good state shared by every benchmark
+    void resetSession(Tech3CSession* session) {
+        session->cleanup();
+        session->applyConfig(ConfigBuilder().debugMode(false).enableMaintenanceCheck(false).build());
+        session->setLoginSuccessCallback(nullptr);
+        session->setRegisterSuccessCallback(nullptr);
+        session->setErrorCallback(nullptr);
+        session->setCancelCallback(nullptr);
+        session->setAuthScreenOpenedCallback(nullptr);
+    }
+
+    // resetSession() and initialize(); SDK callbacks are only accepted once initialized
+    bool startSession(Tech3CSession* session, const char* name) {
+        resetSession(session);
+        if (!session->initialize(CLIENT_ID, CLIENT_SECRET)) {
+            AXLOGWARN("tech3c_bench: initialize failed, skipping %s", name);
+            return false;
+        }
+        return true;
+    }
+
+    // Allocations made by the calling thread while alive
+    class AllocationCounter {
+    public:
+        AllocationCounter() : m_start(t_allocations) { t_countAllocations = true; }
+        ~AllocationCounter() { t_countAllocations = false; }
+        uint64_t count() const { return t_allocations - m_start; }
+
+    private:
+        uint64_t m_start;
+    };
+
+    //--------------------------------------------------------------------
+    // Setters
+
+    struct SetterCase {
+        const char* name;
+        std::function<void(Tech3CSession*, size_t)> call;
+    };
+
+    std::vector<SetterCase> setterCases() {
+        // Alternate values so every call changes the config and reaches the bridge once initialized
+        return {
+            // Debug mode stays off, turning it on would measure logging instead of the bridge
+            { "setDebugMode",              [](Tech3CSession* s, size_t) { s->setDebugMode(false); } },
+            { "setUiMode",                 [](Tech3CSession* s, size_t i) { s->setUiMode((i & 1) ? UiMode::FULLSCREEN : UiMode::DIALOG); } },
+            { "setLanguage",               [](Tech3CSession* s, size_t i) { s->setLanguage((i & 1) ? Language::VIETNAMESE : Language::ENGLISH); } },
+            { "setOrientation",            [](Tech3CSession* s, size_t i) { s->setOrientation((i & 1) ? OrientationMode::LANDSCAPE : OrientationMode::AUTO); } },
+            { "setEnableGuestLogin",       [](Tech3CSession* s, size_t i) { s->setEnableGuestLogin(i & 1); } },
+            { "setDisableExitLogin",       [](Tech3CSession* s, size_t i) { s->setDisableExitLogin(i & 1); } },
+            { "setRequireOtp",             [](Tech3CSession* s, size_t i) { s->setRequireOtp(i & 1); } },
+            { "setEnableMaintenanceCheck", [](Tech3CSession* s, size_t i) { s->setEnableMaintenanceCheck(i & 1); } },
+            { "setIpMaintenanceCheck",     [](Tech3CSession* s, size_t i) { s->setIpMaintenanceCheck((i & 1) ? "103.51.120.202" : "10.0.0.1"); } },
+            { "setEnableRequireBOD",       [](Tech3CSession* s, size_t i) { s->setEnableRequireBOD(i & 1); } },
+            { "applyConfig",               [](Tech3CSession* s, size_t i) {
+                s->applyConfig(ConfigBuilder().enableMaintenanceCheck(false)
+                               .language((i & 1) ? Language::THAI : Language::ENGLISH)
+                               .requireOtp(i & 1).build());
+            } },
+        };
+    }
+
+    void benchSetters(Context& ctx, Tech3CSession* session) {
+        const size_t batches = ctx.scaled(200);
+        const size_t batchSize = 100;
+
+        for (int initialized = 0; initialized <= 1; ++initialized) {
+            resetSession(session);
+            if (initialized && !session->initialize(CLIENT_ID, CLIENT_SECRET)) {
+                AXLOGWARN("tech3c_bench: initialize failed, skipping initialized setter benchmarks");
+                return;
+            }
+
+            for (const SetterCase& setter : setterCases()) {
+                std::string name = std::string("setter.") + setter.name + (initialized ? ".initialized" : ".buffered");
+                if (!ctx.enabled(name)) {
+                    continue;
+                }
+                Result result(name);
+                timeBatches(result, batches, batchSize, [&](size_t i) { setter.call(session, i); });
+                ctx.report.add(std::move(result));
+            }
+
+            // The setters above only queue the bridge call; this waits for the SDK worker to make it
+            if (initialized && ctx.enabled("setter.roundtrip")) {
+                Result result("setter.roundtrip");
+                timeBatches(result, ctx.scaled(20), 10, [&](size_t i) {
+                    session->setLanguage((i & 1) ? Language::VIETNAMESE : Language::ENGLISH);
+                    session->flushBridgeCalls();
+                });
+                ctx.report.add(std::move(result));
+            }
+        }
+        resetSession(session);
+    }
+
+    //--------------------------------------------------------------------
+    // initialize / cleanup
+
+    void benchLifecycle(Context& ctx, Tech3CSession* session) {
+        const size_t cycles = ctx.scaled(100);
+        Result initResult("lifecycle.initialize");
+        Result cleanupResult("lifecycle.cleanup");
+        Result cycleResult("lifecycle.cycle");
+        if (!ctx.enabled(initResult.name) && !ctx.enabled(cleanupResult.name) && !ctx.enabled(cycleResult.name)) {
+            return;
+        }
+
+        resetSession(session);
+        for (size_t i = 0; i < cycles; ++i) {
+            int64_t start = nowNs();
+            if (!session->initialize(CLIENT_ID, CLIENT_SECRET)) {
+                AXLOGWARN("tech3c_bench: initialize failed on cycle %d", (int)i);
+                break;
+            }
+            int64_t initialized = nowNs();
+            session->cleanup();
+            int64_t end = nowNs();
+
+            initResult.samples.push_back(static_cast<double>(initialized - start));
+            cleanupResult.samples.push_back(static_cast<double>(end - initialized));
+            cycleResult.samples.push_back(static_cast<double>(end - start));
+        }
+
+        for (Result* result : { &initResult, &cleanupResult, &cycleResult }) {
+            if (ctx.enabled(result->name)) {
+                ctx.report.add(std::move(*result));
+            }
+        }
+        resetSession(session);
+    }
+
+    //--------------------------------------------------------------------
+    // onLoginSuccess -> callback on the main thread
+
+    // One login in flight at a time: the SDK thread calls onLoginSuccess, the main thread
+    // drains either as fast as it can (queue latency) or once per frame (what a game sees).
+    void benchLoginLatency(Context& ctx, Tech3CSession* session, const char* name, size_t logins,
+                           std::chrono::microseconds framePeriod) {
+        if (!ctx.enabled(name)) {
+            return;
+        }
+
+        if (!startSession(session, name)) {
+            return;
+        }
+        std::atomic<int64_t> postedAt(0);
+        std::atomic<size_t> delivered(0);
+        std::atomic<bool> producerDone(false);
+        Result result(name);
+        result.param("framePeriodUs", framePeriod.count());
+        result.samples.reserve(logins);
+
+        session->setLoginSuccessCallback([&](const UserInfo&) {
+            result.samples.push_back(static_cast<double>(nowNs() - postedAt.load(std::memory_order_acquire)));
+            delivered.fetch_add(1, std::memory_order_release);
+        });
+
+        std::thread sdkThread([&]() {
+            for (size_t i = 0; i < logins; ++i) {
+                postedAt.store(nowNs(), std::memory_order_release);
+                session->onLoginSuccess(BENCH_USER_ID, BENCH_ACCESS_TOKEN, BENCH_REFRESH_TOKEN,
+                                        (int)LoginType::ACCOUNT, 0);
+                while (delivered.load(std::memory_order_acquire) <= i) {
+                    std::this_thread::yield();
+                }
+            }
+            producerDone.store(true, std::memory_order_release);
+        });
+
+        Clock::time_point nextFrame = Clock::now();
+        while (!producerDone.load(std::memory_order_acquire)) {
+            if (framePeriod.count() > 0) {
+                nextFrame += framePeriod;
+                std::this_thread::sleep_until(nextFrame);
+            }
+            session->dispatchPendingEvents();
+        }
+        sdkThread.join();
+
+        ctx.report.add(std::move(result));
+        resetSession(session);
+    }
+
+    // Many SDK threads posting at once, then one drain: cost per dispatched event
+    void benchDispatchBurst(Context& ctx, Tech3CSession* session) {
+        const char* name = "dispatch.burst";
+        if (!ctx.enabled(name)) {
+            return;
+        }
+
+        if (!startSession(session, name)) {
+            return;
+        }
+        const size_t producers = 4;
+        const size_t perProducer = DEFAULT_EVENT_QUEUE_CAPACITY / producers;
+        const size_t rounds = ctx.scaled(200);
+        size_t callbacks = 0;
+        session->setLoginSuccessCallback([&callbacks](const UserInfo&) { ++callbacks; });
+        session->setEventDispatchBudget(std::chrono::seconds(1));
+
+        Result result(name);
+        result.param("producers", (int64_t)producers).param("eventsPerRound", (int64_t)(producers * perProducer));
+        for (size_t round = 0; round < rounds; ++round) {
+            std::vector<std::thread> threads;
+            for (size_t p = 0; p < producers; ++p) {
+                threads.emplace_back([&]() {
+                    for (size_t i = 0; i < perProducer; ++i) {
+                        session->onLoginSuccess(BENCH_USER_ID, BENCH_ACCESS_TOKEN, BENCH_REFRESH_TOKEN,
+                                                (int)LoginType::ACCOUNT, 0);
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            int64_t start = nowNs();
+            size_t dispatched = session->dispatchPendingEvents();
+            if (dispatched > 0) {
+                result.samples.push_back(static_cast<double>(nowNs() - start) / static_cast<double>(dispatched));
+            }
+        }
+
+        ctx.report.add(std::move(result.param("dropped", session->getDroppedEventCount())));
+        session->setEventDispatchBudget(std::chrono::microseconds(2000));
+        resetSession(session);
+    }
+
+    //--------------------------------------------------------------------
+    // Bridge channel: SDK callbacks as ring records instead of per-call JNI strings
+
+    // Writes a LOGIN_SUCCESS record the way Tech3CChannel.java does and lets the session read it in
+    // place. channel.loginSuccess.strings copies the tokens into std::strings first, what the
+    // per-event nativeOnLoginSuccess path pays on top of the JNI call itself (jstring2string x3).
+    // The ring is small enough to wrap every few records.
+    void benchChannel(Context& ctx, Tech3CSession* session) {
+        const size_t events = ctx.scaled(20000);
+        const size_t ringBytes = 4096;
+        std::vector<uint64_t> ring(ringBytes / sizeof(uint64_t));
+
+        for (bool copyStrings : { false, true }) {
+            const char* name = copyStrings ? "channel.loginSuccess.strings" : "channel.loginSuccess";
+            if (!ctx.enabled(name) || !startSession(session, name)) {
+                continue;
+            }
+
+            ChannelWriter writer;
+            ChannelReader reader;
+            writer.attach(ring.data(), ringBytes);
+            reader.attach(ring.data(), ringBytes);
+            const size_t payload = channelStringBytes(BENCH_USER_ID) + channelStringBytes(BENCH_ACCESS_TOKEN)
+                    + channelStringBytes(BENCH_REFRESH_TOKEN) + 2 * CHANNEL_LONG_BYTES;
+
+            Result result(name);
+            result.samples.reserve(events);
+            uint64_t allocations = 0;
+            bool delivered = true;
+            for (size_t i = 0; i < events; ++i) {
+                AllocationCounter counter;
+                const int64_t start = nowNs();
+                if (copyStrings) {
+                    std::string userId(BENCH_USER_ID);
+                    std::string accessToken(BENCH_ACCESS_TOKEN);
+                    std::string refreshToken(BENCH_REFRESH_TOKEN);
+                    session->onLoginSuccess(userId, accessToken, refreshToken, (int)LoginType::ACCOUNT, 0);
+                } else {
+                    delivered &= writer.begin(ChannelRecord::LOGIN_SUCCESS, payload);
+                    writer.putString(BENCH_USER_ID);
+                    writer.putString(BENCH_ACCESS_TOKEN);
+                    writer.putString(BENCH_REFRESH_TOKEN);
+                    writer.putLong((int64_t)LoginType::ACCOUNT);
+                    writer.putLong(0);
+                    writer.setHead(reader.read(writer.commit(),
+                                               [session](ChannelFields& fields) { session->onChannelEvent(fields); }));
+                }
+                result.samples.push_back(static_cast<double>(nowNs() - start));
+                allocations += counter.count();
+                // Keep the event queue from overflowing, outside the measurement
+                if (i % 64 == 63) {
+                    session->dispatchPendingEvents();
+                }
+            }
+            session->dispatchPendingEvents();
+
+            const UserInfo user = session->getCurrentUser();
+            if (!delivered || user.getAccessToken() != BENCH_ACCESS_TOKEN || user.getUserId() != BENCH_USER_ID) {
+                AXLOGWARN("tech3c_bench: %s did not deliver the login", name);
+                ctx.failed = true;
+            }
+            ctx.report.add(std::move(result.param("ringBytes", (int64_t)ringBytes)
+                    .param("events", (int64_t)events).param("allocations", (int64_t)allocations)));
+            resetSession(session);
+        }
+    }
+
+    //--------------------------------------------------------------------
+    // Session resume at launch
+
+    void benchSessionRestore(Context& ctx) {
+        const char* name = "session.restore";
+        if (!ctx.enabled(name)) {
+            return;
+        }
+
+        // The bench writes the saved session itself, to a file of its own, so every restore has
+        // one to load whatever the shared session did before
+        const std::string sessionFile = (std::filesystem::temp_directory_path() /
+                                         ("tech3c_bench_restore_" + std::to_string(nowNs()) + ".bin")).string();
+        UserInfo user;
+        user.setCredentials(BENCH_USER_ID, BENCH_ACCESS_TOKEN, BENCH_REFRESH_TOKEN);
+        user.loginType = LoginType::ACCOUNT;
+        user.expiryTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count() + 3600 * 1000;
+        if (!SessionStore(sessionFile).save(user)) {
+            AXLOGWARN("tech3c_bench: cannot write %s, skipping %s", sessionFile.c_str(), name);
+            ctx.failed = true;
+            return;
+        }
+
+        SessionOptions options;
+        options.persistSession = true;
+        options.sessionFile = sessionFile;
+        options.dispatchOnFrame = false;
+        std::unique_ptr<Tech3CSession> session(new Tech3CSession(options));
+
+        Result result(name);
+        const size_t restores = ctx.scaled(1000);
+        for (size_t i = 0; i < restores; ++i) {
+            int64_t start = nowNs();
+            bool restored = session->restoreSession();
+            int64_t end = nowNs();
+            if (!restored) {
+                AXLOGWARN("tech3c_bench: restoring %s failed", sessionFile.c_str());
+                ctx.failed = true;
+                break;
+            }
+            result.samples.push_back(static_cast<double>(end - start));
+        }
+        if (session->getCurrentUser().getUserId() != BENCH_USER_ID) {
+            AXLOGWARN("tech3c_bench: %s restored the wrong user", name);
+            ctx.failed = true;
+        }
+        ctx.report.add(std::move(result));
+
+        session.reset();
+        std::remove(sessionFile.c_str());
+    }
+
+    //--------------------------------------------------------------------
+    // Current user reads from networking threads while logins keep landing
+
+    void benchUserSnapshot(Context& ctx, Tech3CSession* session) {
+        const size_t readsPerThread = ctx.scaled(200000);
+        if (!startSession(session, "user snapshot benchmarks")) {
+            return;
+        }
+
+        for (size_t threadCount : { (size_t)1, (size_t)4 }) {
+            for (const char* kind : { "snapshot", "isLoggedIn" }) {
+                std::string name = std::string("user.") + kind + ".threads" + std::to_string(threadCount);
+                if (!ctx.enabled(name)) {
+                    continue;
+                }
+
+                Result result(name);
+                result.param("threads", (int64_t)threadCount).param("readsPerThread", (int64_t)readsPerThread);
+                result.samples.resize(threadCount);
+                const bool snapshot = kind[0] == 's';
+
+                std::atomic<bool> done(false);
+                std::atomic<size_t> sink(0);
+                std::thread writer([&]() {
+                    while (!done.load(std::memory_order_acquire)) {
+                        session->onLoginSuccess(BENCH_USER_ID, BENCH_ACCESS_TOKEN, BENCH_REFRESH_TOKEN,
+                                                (int)LoginType::ACCOUNT, 0);
+                        session->dispatchPendingEvents();
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    }
+                });
+
+                std::vector<std::thread> readers;
+                for (size_t t = 0; t < threadCount; ++t) {
+                    readers.emplace_back([&, t]() {
+                        size_t acc = 0;
+                        int64_t start = nowNs();
+                        for (size_t i = 0; i < readsPerThread; ++i) {
+                            if (snapshot) {
+                                acc += session->getUserSnapshot()->accessToken.size();
+                            } else {
+                                acc += session->isLoggedIn() ? 1 : 0;
+                            }
+                        }
+                        result.samples[t] = static_cast<double>(nowNs() - start) / static_cast<double>(readsPerThread);
+                        sink.fetch_add(acc, std::memory_order_relaxed);
+                    });
+                }
+                for (auto& reader : readers) {
+                    reader.join();
+                }
+                done.store(true, std::memory_order_release);
+                writer.join();
+                ctx.report.add(std::move(result));
+            }
+        }
+        resetSession(session);
+    }
+
+    //--------------------------------------------------------------------
+    // acquireToken() from networking threads: served from the cached token, and all of them
+    // hitting the expiry boundary at once, which must cost the auth backend one refresh
+
+    void benchAcquireToken(Context& ctx, Tech3CSession* session) {
+        const size_t callsPerThread = ctx.scaled(200000);
+        const size_t rounds = ctx.scaled(200);
+        if (!startSession(session, "acquireToken benchmarks")) {
+            return;
+        }
+
+        // Stands in for the auth backend, answering after a network round trip
+        std::atomic<size_t> refreshes(0);
+        session->setTokenRefreshHandler([&refreshes](const UserInfo&) {
+            refreshes.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            TokenRefreshResult result;
+            result.success = true;
+            result.accessToken = BENCH_ACCESS_TOKEN;
+            result.refreshToken = BENCH_REFRESH_TOKEN;
+            result.expiryTime = deviceTimeMs() + 60 * 60 * 1000;
+            return result;
+        });
+
+        for (size_t threadCount : { (size_t)1, (size_t)4 }) {
+            std::string name = "token.acquire.cached.threads" + std::to_string(threadCount);
+            if (!ctx.enabled(name)) {
+                continue;
+            }
+            session->onLoginSuccess(BENCH_USER_ID, BENCH_ACCESS_TOKEN, BENCH_REFRESH_TOKEN,
+                                    (int)LoginType::ACCOUNT, deviceTimeMs() + 60 * 60 * 1000);
+
+            Result result(name);
+            result.param("threads", (int64_t)threadCount).param("callsPerThread", (int64_t)callsPerThread);
+            result.samples.resize(threadCount);
+            std::atomic<size_t> sink(0);
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < threadCount; ++t) {
+                threads.emplace_back([&, t]() {
+                    size_t acc = 0;
+                    int64_t start = nowNs();
+                    for (size_t i = 0; i < callsPerThread; ++i) {
+                        acc += session->acquireToken().get().value()->accessToken.size();
+                    }
+                    result.samples[t] = static_cast<double>(nowNs() - start) / static_cast<double>(callsPerThread);
+                    sink.fetch_add(acc, std::memory_order_relaxed);
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            ctx.report.add(std::move(result));
+        }
+
+        std::vector<size_t> threadCounts = { 8 };
+        size_t hardware = std::thread::hardware_concurrency();
+        if (hardware > 8) {
+            threadCounts.push_back(hardware);
+        }
+        for (size_t threadCount : threadCounts) {
+            std::string name = "token.acquire.expiry.threads" + std::to_string(threadCount);
+            if (!ctx.enabled(name)) {
+                continue;
+            }
+
+            // Per round: every thread finds the token inside its 30 s validity window at once;
+            // the sample is the time until the last of them holds the refreshed token
+            Result result(name, "us");
+            result.param("threads", (int64_t)threadCount).param("rounds", (int64_t)rounds);
+            refreshes.store(0);
+            std::atomic<size_t> failures(0);
+            for (size_t round = 0; round < rounds; ++round) {
+                session->onLoginSuccess(BENCH_USER_ID, BENCH_ACCESS_TOKEN, BENCH_REFRESH_TOKEN,
+                                        (int)LoginType::ACCOUNT, deviceTimeMs() + 10 * 1000);
+
+                std::atomic<size_t> ready(0);
+                std::atomic<bool> go(false);
+                std::vector<std::thread> threads;
+                for (size_t t = 0; t < threadCount; ++t) {
+                    threads.emplace_back([&]() {
+                        ready.fetch_add(1);
+                        while (!go.load(std::memory_order_acquire)) {
+                            std::this_thread::yield();
+                        }
+                        if (!session->acquireToken().get()) {
+                            failures.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    });
+                }
+                while (ready.load() < threadCount) {
+                    std::this_thread::yield();
+                }
+                int64_t start = nowNs();
+                go.store(true, std::memory_order_release);
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+                result.samples.push_back(static_cast<double>(nowNs() - start) / 1000.0);
+            }
+            result.param("refreshes", (int64_t)refreshes.load()).param("failures", (int64_t)failures.load());
+            if (refreshes.load() != rounds || failures.load() != 0) {
+                AXLOGWARN("tech3c_bench: %s made %d refreshes in %d rounds, %d callers failed", name.c_str(),
+                          (int)refreshes.load(), (int)rounds, (int)failures.load());
+                ctx.failed = true;
+            }
+            ctx.report.add(std::move(result));
+        }
+
+        session->setTokenRefreshHandler(nullptr);
+        session->logout();
+        session->dispatchPendingEvents();
+        resetSession(session);
+    }
+
+    //--------------------------------------------------------------------
+    // Metrics recording, paid on every timed SDK call
+
+    void benchMetrics(Context& ctx) {
+        const char* name = "metrics.record";
+        if (ctx.enabled(name)) {
+            Metrics metrics;
+            Result result(name);
+            timeBatches(result, ctx.scaled(1000), 1000, [&metrics](size_t i) {
+                metrics.recordLatency(MetricOperation::AUTH_LOGIN, 500 + (i * 7919) % 200000);
+            });
+            ctx.report.add(std::move(result));
+        }
+
+        name = "metrics.snapshot";
+        if (ctx.enabled(name)) {
+            Metrics metrics;
+            for (size_t i = 0; i < 10000; ++i) {
+                metrics.recordLatency(static_cast<MetricOperation>(i % static_cast<size_t>(MetricOperation::COUNT)), i);
+            }
+            Result result(name);
+            size_t bytes = 0;
+            timeBatches(result, ctx.scaled(200), 10, [&metrics, &bytes](size_t) {
+                bytes += metrics.snapshot().toJson().size();
+            });
+            ctx.report.add(std::move(result.param("jsonBytes", (int64_t)(bytes / std::max<size_t>(result.samples.size() * 10, 1)))));
+        }
+    }
+
+    //--------------------------------------------------------------------
+    // Contention: SDK callbacks, logouts, user reads and setters from many threads at once
+
+    enum StressOp { STRESS_LOGIN, STRESS_ERROR, STRESS_LOGOUT, STRESS_GET_USER, STRESS_SETTER, STRESS_OP_COUNT };
+
+    const char* const STRESS_OP_NAMES[STRESS_OP_COUNT] = {
+        "onLoginSuccess", "onError", "logout", "getCurrentUser", "setter"
+    };
+
+    // One round of 16 operations: reads dominate like in a game, the writers still collide
+    const StressOp STRESS_MIX[16] = {
+        STRESS_GET_USER, STRESS_LOGIN, STRESS_GET_USER, STRESS_SETTER,
+        STRESS_GET_USER, STRESS_LOGIN, STRESS_ERROR, STRESS_GET_USER,
+        STRESS_SETTER, STRESS_LOGIN, STRESS_GET_USER, STRESS_LOGOUT,
+        STRESS_GET_USER, STRESS_LOGIN, STRESS_SETTER, STRESS_ERROR,
+    };
+
+    // N threads hammer the session while this thread drains events like the axmol thread does.
+    // stress.threadsN reports the latency of every operation, the throughput and the session lock
+    // waits (getMetrics().lockWait); stress.threadsN.<op> splits the latency per operation.
+    // Runs clean under -fsanitize=thread / address.
+    void benchStress(Context& ctx, Tech3CSession* session) {
+        const size_t opsPerThread = ctx.scaled(20000);
+        std::vector<size_t> threadCounts = { 1, 2, 4, 8 };
+        size_t hardware = std::thread::hardware_concurrency();
+        if (hardware > 8) {
+            threadCounts.push_back(hardware);
+        }
+
+        for (size_t threadCount : threadCounts) {
+            const std::string name = "stress.threads" + std::to_string(threadCount);
+            if (!ctx.enabled(name)) {
+                continue;
+            }
+            if (!startSession(session, name.c_str())) {
+                return;
+            }
+            session->resetMetrics();
+
+            // [thread][op] -> ns per call, reserved up front so recording never allocates
+            std::vector<std::array<std::vector<double>, STRESS_OP_COUNT>> latencies(threadCount);
+            for (auto& perOp : latencies) {
+                for (auto& samples : perOp) {
+                    samples.reserve(opsPerThread / 2);
+                }
+            }
+
+            std::atomic<size_t> ready(0);
+            std::atomic<size_t> finished(0);
+            std::atomic<bool> go(false);
+            std::atomic<uintptr_t> sink(0);
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < threadCount; ++t) {
+                threads.emplace_back([&, t]() {
+                    ready.fetch_add(1);
+                    while (!go.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+                    uintptr_t acc = 0;
+                    for (size_t i = 0; i < opsPerThread; ++i) {
+                        // Threads start at different points of the mix so different writers collide
+                        const StressOp op = STRESS_MIX[(i + t * 5) % 16];
+                        const int64_t start = nowNs();
+                        switch (op) {
+                            case STRESS_LOGIN:
+                                session->onLoginSuccess(BENCH_USER_ID, BENCH_ACCESS_TOKEN, BENCH_REFRESH_TOKEN,
+                                                        (int)LoginType::ACCOUNT, 0);
+                                break;
+                            case STRESS_ERROR:
+                                session->onError("stress");
+                                break;
+                            case STRESS_LOGOUT:
+                                session->logout();
+                                break;
+                            case STRESS_GET_USER:
+                                acc += session->getCurrentUser().expiryTime;
+                                break;
+                            case STRESS_SETTER:
+                                session->setLanguage((i & 1) ? Language::THAI : Language::ENGLISH);
+                                break;
+                            default:
+                                break;
+                        }
+                        latencies[t][op].push_back(static_cast<double>(nowNs() - start));
+                    }
+                    sink.fetch_xor(acc, std::memory_order_relaxed);
+                    finished.fetch_add(1, std::memory_order_release);
+                });
+            }
+            while (ready.load() < threadCount) {
+                std::this_thread::yield();
+            }
+
+            const int64_t start = nowNs();
+            go.store(true, std::memory_order_release);
+            while (finished.load(std::memory_order_acquire) < threadCount) {
+                session->dispatchPendingEvents();
+                std::this_thread::yield();
+            }
+            const int64_t elapsed = nowNs() - start;
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            session->flushBridgeCalls();
+            session->dispatchPendingEvents();
+
+            const MetricsSnapshot metrics = session->getMetrics();
+            const size_t totalOps = opsPerThread * threadCount;
+            Result result(name);
+            result.param("threads", (int64_t)threadCount).param("opsPerThread", (int64_t)opsPerThread)
+                    .param("opsPerSec", (int64_t)(static_cast<double>(totalOps) * 1e9 / static_cast<double>(elapsed)))
+                    .param("lockWaits", (int64_t)metrics.lockWait.count)
+                    .param("lockWaitTotalUs", (int64_t)(metrics.lockWait.meanUs * static_cast<double>(metrics.lockWait.count)))
+                    .param("lockWaitP99Us", (int64_t)metrics.lockWait.p99Us)
+                    .param("lockWaitMaxUs", (int64_t)metrics.lockWait.maxUs)
+                    .param("droppedEvents", (int64_t)session->getDroppedEventCount());
+            result.samples.reserve(totalOps);
+            for (size_t op = 0; op < STRESS_OP_COUNT; ++op) {
+                Result opResult(name + "." + STRESS_OP_NAMES[op]);
+                opResult.param("threads", (int64_t)threadCount);
+                for (const auto& perOp : latencies) {
+                    opResult.samples.insert(opResult.samples.end(), perOp[op].begin(), perOp[op].end());
+                }
+                result.samples.insert(result.samples.end(), opResult.samples.begin(), opResult.samples.end());
+                ctx.report.add(std::move(opResult));
+            }
+            ctx.report.add(std::move(result));
+            resetSession(session);
+        }
+    }
+
+    //--------------------------------------------------------------------
+    // Many sessions in one process
+
+    // Sessions on one shared host, as a bot or QA harness runs them: initialize() each against the
+    // stand-in auth server, then log them all in at once. Reports the cost per session of both
+    // steps; the host runs them all on a handful of threads. Desktop backend only.
+    void benchSessions(Context& ctx) {
+#if TECH3C_DESKTOP_BACKEND
+        const char* initName = "sessions.initialize";
+        const char* loginName = "sessions.login";
+        if (!ctx.enabled(initName) && !ctx.enabled(loginName)) {
+            return;
+        }
+
+        const size_t sessionCount = ctx.scaled(500);
+        const size_t threadCount = 4;
+        auto host = std::make_shared<SessionHost>(threadCount);
+        SessionOptions options;
+        options.host = host;
+        options.eventQueueCapacity = 8;
+        options.dispatchOnFrame = false;
+
+        Result initResult(initName);
+        initResult.param("sessions", (int64_t)sessionCount).param("hostThreads", (int64_t)threadCount);
+        std::vector<std::unique_ptr<Tech3CSession>> sessions;
+        sessions.reserve(sessionCount);
+        for (size_t i = 0; i < sessionCount; ++i) {
+            std::unique_ptr<Tech3CSession> session(new Tech3CSession(options));
+            session->applyConfig(ConfigBuilder().debugMode(false).enableMaintenanceCheck(false).build());
+            int64_t start = nowNs();
+            if (!session->initialize(CLIENT_ID, CLIENT_SECRET)) {
+                AXLOGWARN("tech3c_bench: session initialize failed, skipping %s", initName);
+                ctx.failed = true;
+                return;
+            }
+            initResult.samples.push_back(static_cast<double>(nowNs() - start));
+            session->getDesktopBackend()->setAuthFlow(DesktopAuthFlow::GUEST);
+            sessions.push_back(std::move(session));
+        }
+
+        // All auth flows run concurrently on the host threads; this thread drains every session
+        std::atomic<size_t> loggedIn(0);
+        for (auto& session : sessions) {
+            session->setLoginSuccessCallback([&loggedIn](const UserInfo&) { loggedIn.fetch_add(1); });
+        }
+        const int64_t start = nowNs();
+        for (auto& session : sessions) {
+            session->showAuth();
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+        while (loggedIn.load() < sessionCount && std::chrono::steady_clock::now() < deadline) {
+            for (auto& session : sessions) {
+                session->dispatchPendingEvents();
+            }
+            std::this_thread::yield();
+        }
+        const int64_t elapsed = nowNs() - start;
+
+        Result loginResult(loginName);
+        loginResult.param("sessions", (int64_t)sessionCount).param("hostThreads", (int64_t)threadCount)
+                .param("sessionBytes", (int64_t)(sizeof(Tech3CSession) + options.eventQueueCapacity * sizeof(SdkEvent)));
+        loginResult.samples.push_back(static_cast<double>(elapsed) / static_cast<double>(sessionCount));
+        if (loggedIn.load() != sessionCount) {
+            AXLOGWARN("tech3c_bench: only %zu of %zu sessions logged in", loggedIn.load(), sessionCount);
+            ctx.failed = true;
+        }
+
+        if (ctx.enabled(initName)) {
+            ctx.report.add(std::move(initResult));
+        }
+        if (ctx.enabled(loginName)) {
+            ctx.report.add(std::move(loginResult.param("loggedIn", (int64_t)loggedIn.load())));
+        }
+        // Sessions go before the host they share
+        sessions.clear();
+#endif
+    }
+
+    //--------------------------------------------------------------------
+    // Desktop login against the stand-in auth server, from showAuth() to the login callback:
+    // a new TCP connection per request versus the pooled keep-alive ones initialize() opened, and
+    // pooled with the maintenance check sent to an endpoint of its own
+
+    void benchDesktopLogin(Context& ctx) {
+#if TECH3C_DESKTOP_BACKEND
+        const size_t logins = ctx.scaled(500);
+        for (const char* name : { "desktop.login.cold", "desktop.login.warm", "desktop.login.endpoint" }) {
+            if (!ctx.enabled(name)) {
+                continue;
+            }
+            const bool pooled = std::strcmp(name, "desktop.login.cold") != 0;
+            const bool endpoint = std::strcmp(name, "desktop.login.endpoint") == 0;
+
+            auto host = std::make_shared<SessionHost>(1);
+            std::string error;
+            HttpClient* client = host->connectAuthService(error);
+            if (!client) {
+                AXLOGWARN("tech3c_bench: %s, skipping %s", error.c_str(), name);
+                ctx.failed = true;
+                continue;
+            }
+            client->setMaxIdleConnections(pooled ? 8 : 0);
+
+            SessionOptions options;
+            options.host = host;
+            options.dispatchOnFrame = false;
+            std::unique_ptr<Tech3CSession> session(new Tech3CSession(options));
+            // The maintenance check is on: riding on the login it adds no request, probing the endpoint
+            // it adds one, the answer is cached for the other logins
+            StandInAuthServer* server = host->getStandInServer();
+            ConfigBuilder config;
+            config.debugMode(false).enableMaintenanceCheck(true);
+            if (endpoint) {
+                config.ipMaintenanceCheck("127.0.0.1:" + std::to_string(server->getPort()));
+            }
+            session->applyConfig(config.build());
+            if (!session->initialize(CLIENT_ID, CLIENT_SECRET)) {
+                AXLOGWARN("tech3c_bench: session initialize failed, skipping %s", name);
+                ctx.failed = true;
+                continue;
+            }
+            session->getDesktopBackend()->setAuthFlow(DesktopAuthFlow::GUEST);
+            std::atomic<bool> loggedIn(false);
+            session->setLoginSuccessCallback([&loggedIn](const UserInfo&) { loggedIn.store(true); });
+
+            Result result(name, "us");
+            result.param("logins", (int64_t)logins);
+            result.samples.reserve(logins);
+            const uint64_t requestsBefore = server->getRequestCount();
+            const uint64_t connectsBefore = client->getConnectCount();
+            size_t completed = 0;
+            for (size_t i = 0; i < logins; ++i) {
+                loggedIn.store(false);
+                const int64_t start = nowNs();
+                session->showAuth();
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+                while (!loggedIn.load() && std::chrono::steady_clock::now() < deadline) {
+                    session->dispatchPendingEvents();
+                }
+                if (!loggedIn.load()) {
+                    break;
+                }
+                result.samples.push_back(static_cast<double>(nowNs() - start) / 1000.0);
+                ++completed;
+            }
+
+            // One request per login plus the one probe, and on the warm path no connection beyond
+            // those initialize() opened (the probe has connections of its own)
+            const uint64_t requests = server->getRequestCount() - requestsBefore;
+            const uint64_t connects = client->getConnectCount() - connectsBefore;
+            result.param("requests", (int64_t)requests).param("connects", (int64_t)connects);
+            if (completed != logins || requests != completed + (endpoint ? 1 : 0) || (pooled && connects != 0)) {
+                AXLOGWARN("tech3c_bench: %s logged in %zu of %zu times with %d requests, %d connects",
+                          name, completed, logins, (int)requests, (int)connects);
+                ctx.failed = true;
+            }
+            ctx.report.add(std::move(result));
+            // The session goes before the host it runs on
+            session.reset();
+        }
+#endif
+    }
+
+    //--------------------------------------------------------------------
+    // Maintenance probe over two endpoints, the first accepting connections but never answering:
+    // a probe costs about one attempt delay instead of the timeout a serial check would wait,
+    // and a cached answer costs no request at all
+
+    void benchMaintenanceProbe(Context& ctx) {
+#if TECH3C_DESKTOP_BACKEND
+        if (!ctx.enabled("maintenance.probe.cold") && !ctx.enabled("maintenance.probe.cached")) {
+            return;
+        }
+
+        auto host = std::make_shared<SessionHost>(1);
+        std::string error;
+        if (!host->connectAuthService(error) || !host->getStandInServer()) {
+            AXLOGWARN("tech3c_bench: %s, skipping maintenance.probe", error.c_str());
+            ctx.failed = true;
+            return;
+        }
+        StandInAuthServer* server = host->getStandInServer();
+
+        // Connects complete in the listen backlog, the request then goes unanswered
+        uint16_t silentPort = 0;
+        const int silentFd = http::listenTcp("127.0.0.1", silentPort);
+        if (silentFd < 0) {
+            AXLOGWARN("tech3c_bench: no listening socket, skipping maintenance.probe");
+            ctx.failed = true;
+            return;
+        }
+        const std::string answering = "127.0.0.1:" + std::to_string(server->getPort());
+        const std::string endpoints = "127.0.0.1:" + std::to_string(silentPort) + ", " + answering;
+        const int64_t attemptDelayMs = 250;
+        const int64_t timeoutMs = 5000;
+
+        MaintenanceProbe probe(host->getCircuitBreakers());
+        probe.setAttemptDelay(std::chrono::milliseconds(attemptDelayMs));
+        probe.setTimeout(std::chrono::milliseconds(timeoutMs));
+
+        for (bool cached : { false, true }) {
+            const char* name = cached ? "maintenance.probe.cached" : "maintenance.probe.cold";
+            if (!ctx.enabled(name)) {
+                continue;
+            }
+            const size_t checks = cached ? ctx.scaled(10000) : ctx.scaled(20);
+            probe.setCacheTtl(std::chrono::milliseconds(cached ? 60000 : 0));
+            probe.clearCache();
+            if (cached) {
+                probe.check(endpoints);
+            }
+
+            Result result(name, "us");
+            result.param("checks", (int64_t)checks).param("attemptDelayMs", attemptDelayMs).param("timeoutMs", timeoutMs);
+            result.samples.reserve(checks);
+            const uint64_t probesBefore = probe.getProbeCount();
+            const uint64_t requestsBefore = server->getRequestCount();
+            size_t answered = 0;
+            int64_t slowestNs = 0;
+            for (size_t i = 0; i < checks; ++i) {
+                const int64_t start = nowNs();
+                MaintenanceProbe::Result answer = probe.check(endpoints);
+                const int64_t elapsedNs = nowNs() - start;
+                result.samples.push_back(static_cast<double>(elapsedNs) / 1000.0);
+                slowestNs = std::max(slowestNs, elapsedNs);
+                if (answer.answered && !answer.maintenance && answer.endpoint == answering) {
+                    ++answered;
+                }
+            }
+
+            // Every check answered by the second endpoint well before the timeout; cached checks
+            // send nothing
+            const uint64_t probes = probe.getProbeCount() - probesBefore;
+            const uint64_t requests = server->getRequestCount() - requestsBefore;
+            result.param("probes", (int64_t)probes).param("requests", (int64_t)requests);
+            if (answered != checks || slowestNs >= timeoutMs * 1000000 / 2
+                || (cached ? probes != 0 || requests != 0 : probes != checks || requests != checks)) {
+                AXLOGWARN("tech3c_bench: %s answered %zu of %zu checks with %d probes, %d requests",
+                          name, answered, checks, (int)probes, (int)requests);
+                ctx.failed = true;
+            }
+            ctx.report.add(std::move(result));
+        }
+        http::closeSocket(silentFd);
+#endif
+    }
+
+    //--------------------------------------------------------------------
+    // Retries against a degraded stand-in auth server: initialize() riding out two failed init
+    // requests with a short backoff, and acquireToken() once the auth service's circuit breaker
+    // opened, where callers get the current token at once instead of queueing behind a refresh
+
+    void benchRetry(Context& ctx) {
+#if TECH3C_DESKTOP_BACKEND
+        RetryPolicy retryPolicy;
+        retryPolicy.maxAttempts = 3;
+        retryPolicy.initialDelay = std::chrono::milliseconds(5);
+        retryPolicy.maxDelay = std::chrono::milliseconds(20);
+
+        if (ctx.enabled("retry.init.transient")) {
+            auto host = std::make_shared<SessionHost>(1);
+            std::string error;
+            if (!host->connectAuthService(error) || !host->getStandInServer()) {
+                AXLOGWARN("tech3c_bench: %s, skipping retry.init.transient", error.c_str());
+                ctx.failed = true;
+                return;
+            }
+            StandInAuthServer* server = host->getStandInServer();
+            SessionOptions options;
+            options.host = host;
+            options.dispatchOnFrame = false;
+            options.retryPolicy = retryPolicy;
+            std::unique_ptr<Tech3CSession> session(new Tech3CSession(options));
+            session->applyConfig(ConfigBuilder().debugMode(false).enableMaintenanceCheck(false).build());
+
+            const size_t inits = ctx.scaled(100);
+            const int failures = 2;
+            Result result("retry.init.transient", "us");
+            result.param("inits", (int64_t)inits).param("failures", (int64_t)failures)
+                  .param("initialDelayMs", (int64_t)retryPolicy.initialDelay.count());
+            result.samples.reserve(inits);
+            size_t initialized = 0;
+            uint64_t requests = 0;
+            for (size_t i = 0; i < inits; ++i) {
+                StandInAuthServer::Options serverOptions = server->getOptions();
+                serverOptions.failRequests = failures;
+                server->setOptions(serverOptions);
+
+                const uint64_t requestsBefore = server->getRequestCount();
+                const int64_t start = nowNs();
+                if (session->initialize(CLIENT_ID, CLIENT_SECRET)) {
+                    ++initialized;
+                }
+                result.samples.push_back(static_cast<double>(nowNs() - start) / 1000.0);
+                requests += server->getRequestCount() - requestsBefore;
+                session->cleanup();
+            }
+
+            // Every init got through on its third request
+            result.param("requests", (int64_t)requests);
+            if (initialized != inits || requests != inits * (failures + 1)) {
+                AXLOGWARN("tech3c_bench: retry.init.transient initialized %zu of %zu times with %d requests",
+                          initialized, inits, (int)requests);
+                ctx.failed = true;
+            }
+            ctx.report.add(std::move(result));
+            session.reset();
+        }
+
+        if (ctx.enabled("retry.breaker.failfast")) {
+            auto host = std::make_shared<SessionHost>(1);
+            CircuitBreakerPolicy breakerPolicy;
+            breakerPolicy.failureThreshold = 3;
+            breakerPolicy.openDuration = std::chrono::milliseconds(60000);
+            host->getCircuitBreakers().setPolicy(breakerPolicy);
+            std::string error;
+            if (!host->connectAuthService(error) || !host->getStandInServer()) {
+                AXLOGWARN("tech3c_bench: %s, skipping retry.breaker.failfast", error.c_str());
+                ctx.failed = true;
+                return;
+            }
+            StandInAuthServer* server = host->getStandInServer();
+            SessionOptions options;
+            options.host = host;
+            options.dispatchOnFrame = false;
+            options.retryPolicy = retryPolicy;
+            std::unique_ptr<Tech3CSession> session(new Tech3CSession(options));
+            session->applyConfig(ConfigBuilder().debugMode(false).enableMaintenanceCheck(false).build());
+            std::atomic<bool> loggedIn(false);
+            session->setLoginSuccessCallback([&loggedIn](const UserInfo&) { loggedIn.store(true); });
+            if (!session->initialize(CLIENT_ID, CLIENT_SECRET)) {
+                AXLOGWARN("tech3c_bench: session initialize failed, skipping retry.breaker.failfast");
+                ctx.failed = true;
+                return;
+            }
+            session->getDesktopBackend()->setAuthFlow(DesktopAuthFlow::GUEST);
+            session->showAuth();
+            const auto loginDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!loggedIn.load() && std::chrono::steady_clock::now() < loginDeadline) {
+                session->dispatchPendingEvents();
+            }
+            if (!loggedIn.load()) {
+                AXLOGWARN("tech3c_bench: login failed, skipping retry.breaker.failfast");
+                ctx.failed = true;
+                return;
+            }
+            const std::string accessToken(session->getCurrentUser().getAccessToken());
+
+            // The backend goes down; asking for more validity than the token has forces refreshes,
+            // which fail (and retry on their own) until the breaker opens
+            StandInAuthServer::Options serverOptions = server->getOptions();
+            serverOptions.failRequests = 1000000;
+            server->setOptions(serverOptions);
+            const auto minValidity = std::chrono::hours(2);
+            CircuitBreaker* breaker = session->getDesktopBackend()->getCircuitBreaker();
+            const uint64_t requestsBefore = server->getRequestCount();
+            for (int i = 0; i < 100 && breaker->getState() != CircuitState::OPEN; ++i) {
+                session->acquireToken(minValidity).wait();
+            }
+            const uint64_t requests = server->getRequestCount() - requestsBefore;
+
+            const size_t calls = ctx.scaled(10000);
+            Result result("retry.breaker.failfast", "us");
+            result.param("calls", (int64_t)calls).param("failureThreshold", (int64_t)breakerPolicy.failureThreshold);
+            result.samples.reserve(calls);
+            size_t current = 0;
+            for (size_t i = 0; i < calls; ++i) {
+                const int64_t start = nowNs();
+                TokenFuture token = session->acquireToken(minValidity);
+                const bool ready = token.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                result.samples.push_back(static_cast<double>(nowNs() - start) / 1000.0);
+                if (ready && token.get() && token.get().value()->getAccessToken() == accessToken) {
+                    ++current;
+                }
+            }
+
+            // The breaker opened on its threshold, and from then on no caller waited or reached the server
+            const CircuitBreakerStatus status = breaker->getStatus();
+            const uint64_t totalRequests = server->getRequestCount() - requestsBefore;
+            result.param("requests", (int64_t)totalRequests);
+            if (status.state != CircuitState::OPEN || current != calls
+                || requests != (uint64_t)breakerPolicy.failureThreshold || totalRequests != requests) {
+                AXLOGWARN("tech3c_bench: retry.breaker.failfast served %zu of %zu calls, breaker %s after %d requests",
+                          current, calls, circuitStateToString(status.state).c_str(), (int)totalRequests);
+                ctx.failed = true;
+            }
+            ctx.report.add(std::move(result));
+
+            serverOptions.failRequests = 0;
+            server->setOptions(serverOptions);
+            session.reset();
+        }
+#endif
+    }
+
+    //--------------------------------------------------------------------
+    // getInstance() contention
+
+    void benchGetInstance(Context& ctx) {
+        const size_t callsPerThread = ctx.scaled(200000);
+        std::vector<size_t> threadCounts = { 1, 2, 4, 8 };
+        size_t hardware = std::thread::hardware_concurrency();
+        if (hardware > 8) {
+            threadCounts.push_back(hardware);
+        }
+
+        for (size_t threadCount : threadCounts) {
+            std::string name = "getInstance.threads" + std::to_string(threadCount);
+            if (!ctx.enabled(name)) {
+                continue;
+            }
+
+            // Per-thread mean cost of one call; the spread shows how unfair the lock is
+            Result result(name);
+            result.param("threads", (int64_t)threadCount).param("callsPerThread", (int64_t)callsPerThread);
+            result.samples.resize(threadCount);
+
+            std::atomic<size_t> ready(0);
+            std::atomic<bool> go(false);
+            std::atomic<uintptr_t> sink(0);
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < threadCount; ++t) {
+                threads.emplace_back([&, t]() {
+                    ready.fetch_add(1);
+                    while (!go.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+                    uintptr_t acc = 0;
+                    int64_t start = nowNs();
+                    for (size_t i = 0; i < callsPerThread; ++i) {
+                        acc ^= reinterpret_cast<uintptr_t>(Tech3CManager::getInstance());
+                    }
+                    result.samples[t] = static_cast<double>(nowNs() - start) / static_cast<double>(callsPerThread);
+                    sink.fetch_xor(acc, std::memory_order_relaxed);
+                });
+            }
+            while (ready.load() < threadCount) {
+                std::this_thread::yield();
+            }
+            go.store(true, std::memory_order_release);
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            ctx.report.add(std::move(result));
+        }
+    }
+
+    bool parseArgs(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--out" && i + 1 < argc) {
+                options.outPath = argv[++i];
+            } else if (arg == "--filter" && i + 1 < argc) {
+                options.filter = argv[++i];
+            } else if (arg == "--quick") {
+                options.quick = true;
+            } else {
+                std::fprintf(stderr, "usage: %s [--out results.json] [--filter substring] [--quick]\n", argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    Context ctx;
+    if (!parseArgs(argc, argv, ctx.options)) {
+        return 2;
+    }
+
+    ctx.report.setMeta("suite", "tech3c_bench");
+    ctx.report.setMeta("schemaVersion", "1");
+    ctx.report.setMeta("platform", platformName());
+    ctx.report.setMeta("compiler", compilerName());
+#if TECH3C_DESKTOP_BACKEND
+    ctx.report.setMeta("backend", "desktop");
+#else
+    ctx.report.setMeta("backend", "stub");
+#endif
+    ctx.report.setMeta("quick", ctx.options.quick ? "true" : "false");
+
+#if TECH3C_DESKTOP_BACKEND
+    // Sessions log in against the in-process auth server unless TECH3C_AUTH_URL is set; the
+    // retry and desktop.login benchmarks need it
+    SessionHost::setStandInServerEnabled(true);
+#endif
+
+    // The single-session benchmarks share this one: persisting like the default session, but to a
+    // file of its own, and drained by the bench instead of the axmol scheduler
+    const std::string sessionFile = (std::filesystem::temp_directory_path() /
+                                     ("tech3c_bench_" + std::to_string(nowNs()) + ".bin")).string();
+    SessionOptions options;
+    options.persistSession = true;
+    options.sessionFile = sessionFile;
+    options.dispatchOnFrame = false;
+    std::unique_ptr<Tech3CSession> session(new Tech3CSession(options));
+
+    benchSetters(ctx, session.get());
+    benchLifecycle(ctx, session.get());
+    benchLoginLatency(ctx, session.get(), "login.latency.immediate", ctx.scaled(2000), std::chrono::microseconds(0));
+    benchLoginLatency(ctx, session.get(), "login.latency.frame60", ctx.scaled(120), std::chrono::microseconds(16667));
+    benchDispatchBurst(ctx, session.get());
+    benchChannel(ctx, session.get());
+    benchSessionRestore(ctx);
+    benchUserSnapshot(ctx, session.get());
+    benchAcquireToken(ctx, session.get());
+    benchMetrics(ctx);
+    benchStress(ctx, session.get());
+    session.reset();
+    std::remove(sessionFile.c_str());
+    benchSessions(ctx);
+    benchDesktopLogin(ctx);
+    benchMaintenanceProbe(ctx);
+    benchRetry(ctx);
+    benchGetInstance(ctx);
+
+    // benchGetInstance only creates the default session, it is never initialized
+    Tech3CManager::destroyInstance();
+
+    if (!ctx.report.write(ctx.options.outPath)) {
+        std::fprintf(stderr, "tech3c_bench: failed to write %s\n", ctx.options.outPath.c_str());
+        return 1;
+    }
+    return ctx.failed ? 3 : 0;
+}
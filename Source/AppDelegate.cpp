@@ -25,6 +25,9 @@
 
 #include "AppDelegate.h"
 #include "Scenes/LoginScene.h"
+#include "StartupProfiler.h"
+#include "Tech3C/Tech3CTrace.h"
+#include <future>
 
 #define USE_AUDIO_ENGINE 1
 
@@ -36,9 +39,42 @@ using namespace ax;
 
 static ax::Size designResolutionSize = ax::Size(1920, 1080);
 
-AppDelegate::AppDelegate() {}
+// Files the first scene loads; reading them ahead on a worker means the scene finds them in the page cache
+static const char* const startupPreloadFiles[] = {"fonts/Marker Felt.ttf"};
 
-AppDelegate::~AppDelegate() {}
+static void preloadStartupFiles()
+{
+    STARTUP_PHASE("preload files");
+    auto fileUtils = FileUtils::getInstance();
+    for (auto file : startupPreloadFiles)
+    {
+        fileUtils->getDataFromFile(file);
+    }
+}
+
+#if TECH3C_TRACE_STARTUP
+// Saved next to tech3c.log, open it in chrome://tracing or ui.perfetto.dev
+static void writeStartupTrace()
+{
+    auto path = FileUtils::getInstance()->getWritablePath() + "tech3c_trace.json";
+    if (tech3c::Tracer::getInstance().writeJson(path))
+    {
+        AXLOG("Tech3C trace written to %s", path.c_str());
+    }
+}
+#endif
+
+AppDelegate::AppDelegate()
+{
+    StartupProfiler::getInstance().begin();
+}
+
+AppDelegate::~AppDelegate()
+{
+#if TECH3C_TRACE_STARTUP
+    writeStartupTrace();
+#endif
+}
 
 // if you want a different context, modify the value of glContextAttrs
 // it will affect all platforms
@@ -54,11 +90,35 @@ void AppDelegate::initGLContextAttrs()
 
 bool AppDelegate::applicationDidFinishLaunching()
 {
+#if TECH3C_TRACE_STARTUP
+    tech3c::Tracer::getInstance().start();
+    tech3c::Tracer::getInstance().setThreadName("axmol main");
+#endif
+    TECH3C_TRACE_SCOPE("app", "AppDelegate::applicationDidFinishLaunching");
+    StartupProfiler::getInstance().watchFirstFrame();
+
+    // Start the work that does not need the GL view first, it overlaps with creating it
+    std::future<void> preload = std::async(std::launch::async, preloadStartupFiles);
+
+    // Resume the saved Tech3C session so returning players are logged in before the first frame
+    {
+        STARTUP_PHASE("tech3c restore session");
+        tech3c::Tech3CManager::getInstance()->restoreSession();
+    }
+
+    // Completes on the axmol thread once the SDK is up, usually a few frames in
+    const int64_t tech3cStartUs = StartupProfiler::nowUs();
+    auto tech3cInit = LoginScene::initializeTech3C();
+    tech3cInit.then([tech3cStartUs](const tech3c::AsyncResult<tech3c::Done>&) {
+        StartupProfiler::getInstance().record("tech3c initialize", tech3cStartUs, StartupProfiler::nowUs());
+    });
+
     // initialize director
     auto director = Director::getInstance();
     auto glView   = director->getGLView();
     if (!glView)
     {
+        STARTUP_PHASE("glview");
 #if (AX_TARGET_PLATFORM == AX_PLATFORM_WIN32) || (AX_TARGET_PLATFORM == AX_PLATFORM_MAC) || \
     (AX_TARGET_PLATFORM == AX_PLATFORM_LINUX)
         glView = GLViewImpl::createWithRect(
@@ -79,8 +139,22 @@ bool AppDelegate::applicationDidFinishLaunching()
     glView->setDesignResolutionSize(designResolutionSize.width, designResolutionSize.height,
                                     ResolutionPolicy::SHOW_ALL);
 
+#if TECH3C_TRACE_STARTUP
+    tech3c::Tracer::getInstance().traceFrames(true);
+#endif
+
+    {
+        STARTUP_PHASE("wait preload files");
+        preload.wait();
+    }
+
     // create a scene. it's an autorelease object
-    auto scene = utils::createInstance<LoginScene>();
+    LoginScene* scene = nullptr;
+    {
+        STARTUP_PHASE("login scene");
+        scene = utils::createInstance<LoginScene>();
+    }
+    scene->watchTech3CInitialization(tech3cInit);
 
     // run
     director->runWithScene(scene);
@@ -96,6 +170,11 @@ void AppDelegate::applicationDidEnterBackground()
 #if USE_AUDIO_ENGINE
     AudioEngine::pauseAll();
 #endif
+
+#if TECH3C_TRACE_STARTUP
+    // Mobile apps are often killed in the background without running the destructor
+    writeStartupTrace();
+#endif
 }
 
 // this function will be called when the app is active again
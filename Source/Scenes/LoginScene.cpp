@@ -1,5 +1,6 @@
 // LoginScene.cpp
 #include "LoginScene.h"
+#include "Tech3C/Tech3CTrace.h"
 
 USING_NS_AX;
 
@@ -8,6 +9,7 @@ Scene* LoginScene::createScene() {
 }
 
 bool LoginScene::init() {
+    TECH3C_TRACE_SCOPE("app", "LoginScene::init");
     if (!Scene::init()) {
         return false;
     }
@@ -17,7 +19,6 @@ bool LoginScene::init() {
     setupBackground();
     setupUI();
     setupTech3CCallbacks();
-    initializeTech3C();
 
     return true;
 }
@@ -49,6 +50,7 @@ void LoginScene::setupBackground() {
 }
 
 void LoginScene::setupUI() {
+    TECH3C_TRACE_SCOPE("app", "LoginScene::setupUI");
     setupLabels();
     setupButtons();
 }
@@ -151,30 +153,48 @@ void LoginScene::setupTech3CCallbacks() {
     manager->setAuthScreenOpenedCallback([this]() {
         this->onAuthScreenOpened();
     });
+
+    manager->setTokenRefreshedCallback([this](const tech3c::UserInfo& userInfo) {
+        this->onTokenRefreshed(userInfo);
+    });
 }
 
-void LoginScene::initializeTech3C() {
+tech3c::AsyncOperation<tech3c::Done> LoginScene::initializeTech3C() {
+    TECH3C_TRACE_SCOPE("app", "LoginScene::initializeTech3C");
     auto manager = tech3c::Tech3CManager::getInstance();
 
+    // Configure SDK, buffered until initialize() pushes it in one bridge call
+    manager->applyConfig(tech3c::ConfigBuilder()
+                             .debugMode(true)
+                             .orientation(tech3c::OrientationMode::LANDSCAPE)
+                             .uiMode(tech3c::UiMode::DIALOG)
+                             .language(tech3c::Language::VIETNAMESE)
+                             .enableGuestLogin(true)
+                             .disableExitLogin(false)
+                             .requireOtp(true)
+                             // .enableMaintenanceCheck(true)
+                             // .ipMaintenanceCheck("103.51.120.202")
+                             .build());
+
     // Initialize with your credentials
-    bool success = manager->initialize("3cgame", "2NPDoFBSarmjgvK25OKSi9tEttaX1s4Y");
-
-    if (success) {
-        // Configure SDK
-        manager->setDebugMode(true);
-        manager->setOrientation(tech3c::OrientationMode::LANDSCAPE);
-        manager->setUiMode(tech3c::UiMode::DIALOG);
-        manager->setLanguage(tech3c::Language::VIETNAMESE);
-        manager->setEnableGuestLogin(true);
-        manager->setDisableExitLogin(false);
-        manager->setRequireOtp(true);
-        // manager->setEnableMaintenanceCheck(true);
-        // manager->setIpMaintenanceCheck("103.51.120.202");
-
-        updateStatusMessage("Tech3C SDK initialized successfully", Color3B::GREEN);
-    } else {
-        updateStatusMessage("Failed to initialize Tech3C SDK", Color3B::RED);
+    return manager->initializeAsync("3cgame", "2NPDoFBSarmjgvK25OKSi9tEttaX1s4Y");
+}
+
+void LoginScene::watchTech3CInitialization(tech3c::AsyncOperation<tech3c::Done> operation) {
+    if (!operation.isDone()) {
+        updateStatusMessage("Initializing Tech3C SDK...", Color3B::YELLOW);
     }
+
+    // The scene may be replaced before the SDK is ready
+    this->retain();
+    operation.then([this](const tech3c::AsyncResult<tech3c::Done>& result) {
+        if (result) {
+            updateStatusMessage("Tech3C SDK initialized successfully", Color3B::GREEN);
+        } else {
+            updateStatusMessage("Failed to initialize Tech3C SDK", Color3B::RED);
+        }
+        this->release();
+    });
 }
 
 void LoginScene::onLoginButtonClicked(Object* sender) {
@@ -186,7 +206,10 @@ void LoginScene::onLoginButtonClicked(Object* sender) {
     }
 
     updateStatusMessage("Showing login screen...", Color3B::YELLOW);
+#if !TECH3C_DESKTOP_BACKEND
+    // On desktop the auth service (or the stand-in server) answers the maintenance check itself
     manager->setIpMaintenanceCheck("103.51.120.202");
+#endif
     manager->showAuth();
 }
 
@@ -239,6 +262,11 @@ void LoginScene::onAuthScreenOpened() {
     updateStatusMessage("Auth screen opened", Color3B::BLUE);
 }
 
+void LoginScene::onTokenRefreshed(const tech3c::UserInfo& userInfo) {
+    AXLOGD("Token refreshed: UserID=%s, Expires=%lld", userInfo.userId.c_str(), (long long)userInfo.expiryTime);
+    updateUserInfo(userInfo);
+}
+
 void LoginScene::updateUIForLoginState(bool isLoggedIn) {
     m_isLoggedIn = isLoggedIn;
 
@@ -284,21 +312,25 @@ std::string LoginScene::formatUserInfo(const tech3c::UserInfo& userInfo) {
         return "";
     }
 
-    std::string info = "User Info:\n";
-    info += "ID: " + userInfo.userId + "\n";
-    info += "Type: " + tech3c::loginTypeToString(userInfo.loginType) + "\n";
-    info += "Token: " + truncateString(userInfo.accessToken, 20) + "...\n";
+    // Appends views of the inline UserInfo fields, the only allocation is the result
+    std::string info;
+    info.reserve(128);
+    info += "User Info:\nID: ";
+    info += userInfo.getUserId();
+    info += "\nType: ";
+    info += tech3c::loginTypeToString(userInfo.loginType);
+    info += "\nToken: ";
+    info += truncateString(userInfo.getAccessToken(), 20);
+    info += "...\n";
 
     if (userInfo.expiryTime > 0) {
-        info += "Expires: " + std::to_string(userInfo.expiryTime);
+        info += "Expires: ";
+        info += std::to_string(userInfo.expiryTime);
     }
 
     return info;
 }
 
-std::string LoginScene::truncateString(const std::string& str, size_t maxLength) {
-    if (str.length() <= maxLength) {
-        return str;
-    }
-    return str.substr(0, maxLength) + "...";
+std::string_view LoginScene::truncateString(std::string_view str, size_t maxLength) {
+    return str.substr(0, maxLength);
 }
@@ -15,6 +15,12 @@ public:
 
     CREATE_FUNC(LoginScene);
 
+    // Applies the demo config and starts SDK initialization off the axmol thread. AppDelegate
+    // calls it before creating the GL view so both overlap.
+    static tech3c::AsyncOperation<tech3c::Done> initializeTech3C();
+    // Shows the outcome of initializeTech3C() in the status label
+    void watchTech3CInitialization(tech3c::AsyncOperation<tech3c::Done> operation);
+
 protected:
     void onEnter() override;
     void onExit() override;
@@ -37,6 +43,7 @@ private:
     void onLoginError(const tech3c::ErrorInfo& error);
     void onLoginCancelled();
     void onAuthScreenOpened();
+    void onTokenRefreshed(const tech3c::UserInfo& userInfo);
 
     // UI Updates
     void updateUIForLoginState(bool isLoggedIn);
@@ -45,9 +52,8 @@ private:
     void showErrorDialog(const std::string& title, const std::string& message);
 
     // Utility
-    void initializeTech3C();
     std::string formatUserInfo(const tech3c::UserInfo& userInfo);
-    std::string truncateString(const std::string& str, size_t maxLength);
+    std::string_view truncateString(std::string_view str, size_t maxLength);
 
     // UI Elements
     ui::Button* m_loginButton;
@@ -0,0 +1,93 @@
+// StartupProfiler.cpp
+#include "StartupProfiler.h"
+#include "axmol.h"
+#include "fmt/format.h"
+#include <algorithm>
+#include <iterator>
+
+USING_NS_AX;
+
+StartupProfiler& StartupProfiler::getInstance() {
+    static StartupProfiler profiler;
+    return profiler;
+}
+
+StartupProfiler::StartupProfiler()
+        : m_launchUs(nowUs())
+        , m_firstFrameUs(-1)
+        , m_mainThread(std::this_thread::get_id())
+        , m_firstFrameListener(nullptr) {
+}
+
+void StartupProfiler::begin() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_launchUs = nowUs();
+    m_firstFrameUs = -1;
+    m_mainThread = std::this_thread::get_id();
+    m_phases.clear();
+}
+
+void StartupProfiler::record(const char* name, int64_t startUs, int64_t endUs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const bool mainThread = std::this_thread::get_id() == m_mainThread;
+    m_phases.push_back(Phase{name, startUs - m_launchUs, endUs - m_launchUs, mainThread});
+}
+
+void StartupProfiler::watchFirstFrame() {
+    if (m_firstFrameListener) {
+        return;
+    }
+    m_firstFrameListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(
+            Director::EVENT_AFTER_DRAW, [this](EventCustom*) { onFirstFrame(); });
+}
+
+void StartupProfiler::onFirstFrame() {
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(static_cast<EventListener*>(m_firstFrameListener));
+    m_firstFrameListener = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_firstFrameUs = nowUs() - m_launchUs;
+    }
+    TECH3C_TRACE_INSTANT("startup", "first frame");
+    AXLOG("%s", report().c_str());
+}
+
+int64_t StartupProfiler::getTimeToFirstFrameUs() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_firstFrameUs;
+}
+
+std::vector<StartupProfiler::Phase> StartupProfiler::getPhases() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_phases;
+}
+
+std::string StartupProfiler::report() const {
+    std::vector<Phase> phases = getPhases();
+    const int64_t firstFrameUs = getTimeToFirstFrameUs();
+    std::stable_sort(phases.begin(), phases.end(),
+                     [](const Phase& a, const Phase& b) { return a.startUs < b.startUs; });
+
+    // Main thread time is what the player waits for, background phases only count if waited on
+    int64_t mainUs = 0;
+    fmt::memory_buffer out;
+    fmt::format_to(std::back_inserter(out), "Startup phases (ms since launch):\n");
+    for (const Phase& phase : phases) {
+        const int64_t durationUs = phase.endUs - phase.startUs;
+        if (phase.mainThread) {
+            mainUs += durationUs;
+        }
+        fmt::format_to(std::back_inserter(out), "  {:<24} {:>9.2f} -> {:>9.2f}  {:>8.2f}  {}\n",
+                       phase.name, phase.startUs / 1000.0, phase.endUs / 1000.0, durationUs / 1000.0,
+                       phase.mainThread ? "main" : "background");
+    }
+    fmt::format_to(std::back_inserter(out), "  main thread phases: {:.2f} ms\n", mainUs / 1000.0);
+    if (firstFrameUs >= 0) {
+        fmt::format_to(std::back_inserter(out), "  time to first frame: {:.2f} ms", firstFrameUs / 1000.0);
+    } else {
+        fmt::format_to(std::back_inserter(out), "  first frame not drawn yet");
+    }
+    return fmt::to_string(out);
+}
@@ -0,0 +1,76 @@
+// StartupProfiler.h
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Tech3C/Tech3CTrace.h"
+
+// Times the named phases of a cold start and the time until the first frame is drawn.
+// Phases may run on any thread; the report is logged once the first frame is on screen.
+class StartupProfiler {
+public:
+    struct Phase {
+        const char* name;       // String literal
+        int64_t startUs;        // Relative to begin()
+        int64_t endUs;
+        bool mainThread;
+    };
+
+    static StartupProfiler& getInstance();
+
+    // Time zero of the launch, AppDelegate calls it from its constructor
+    void begin();
+    // Records a phase that ran between two nowUs() readings, from any thread
+    void record(const char* name, int64_t startUs, int64_t endUs);
+    // Logs the report after the first frame has been drawn, call on the axmol thread
+    void watchFirstFrame();
+
+    // -1 until the first frame has been drawn
+    int64_t getTimeToFirstFrameUs() const;
+    std::vector<Phase> getPhases() const;
+    std::string report() const;
+
+    static int64_t nowUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Records its own lifetime as a phase, and as a span of a running tech3c trace
+    class Scope {
+    public:
+        explicit Scope(const char* name) : m_name(name), m_trace("startup", name), m_startUs(nowUs()) {}
+        ~Scope() { StartupProfiler::getInstance().record(m_name, m_startUs, nowUs()); }
+
+    private:
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        const char* m_name;
+        tech3c::TraceScope m_trace;
+        int64_t m_startUs;
+    };
+
+private:
+    StartupProfiler();
+    StartupProfiler(const StartupProfiler&) = delete;
+    StartupProfiler& operator=(const StartupProfiler&) = delete;
+
+    void onFirstFrame();
+
+    int64_t m_launchUs;
+    int64_t m_firstFrameUs;
+    std::thread::id m_mainThread;
+    void* m_firstFrameListener;
+
+    mutable std::mutex m_mutex;
+    std::vector<Phase> m_phases;
+};
+
+#define STARTUP_PHASE_CONCAT_INNER(a, b) a##b
+#define STARTUP_PHASE_CONCAT(a, b) STARTUP_PHASE_CONCAT_INNER(a, b)
+// STARTUP_PHASE("glview"); times the rest of the block
+#define STARTUP_PHASE(name) StartupProfiler::Scope STARTUP_PHASE_CONCAT(startupPhase, __LINE__)(name)
@@ -16,6 +16,21 @@ typedef void (*ErrorCallback)(const char* error);
 typedef void (*CancelCallback)(void);
 typedef void (*AuthScreenOpenedCallback)(void);
 
+// Batched configuration, mask bits match tech3c::ConfigField
+typedef struct tech3c_ios_config {
+    unsigned int mask;
+    bool debugMode;
+    int uiMode;
+    int language;
+    int orientation;
+    bool enableGuestLogin;
+    bool disableExitLogin;
+    bool requireOtp;
+    bool enableMaintenanceCheck;
+    const char* ipMaintenanceCheck;
+    bool enableRequireBOD;
+} tech3c_ios_config;
+
 // iOS Bridge Functions
 bool tech3c_ios_initialize(const char* appKey, const char* appSecret);
 void tech3c_ios_cleanup(void);
@@ -34,6 +49,7 @@ void tech3c_ios_setTimeout(int timeoutSeconds);
 void tech3c_ios_setEnvironment(int environment); // 0=Production, 1=Development
 void tech3c_ios_setDialogSize(float width, float height);
 void tech3c_ios_setEnableRequireBOD(bool enable); // todo: update
+void tech3c_ios_applyConfig(const tech3c_ios_config* config); // Applies only the fields in config->mask
 
 // Authentication Methods
 void tech3c_ios_showAuth(void);
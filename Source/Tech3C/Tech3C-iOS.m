@@ -102,6 +102,16 @@
 
 #pragma mark - C Bridge Functions
 
+// Tech3CManager makes bridge calls from its worker thread; UIKit work must happen on the main queue.
+// dispatch_async keeps the calls in order and never blocks the caller.
+static void tech3c_ios_runOnMain(dispatch_block_t block) {
+    if ([NSThread isMainThread]) {
+        block();
+    } else {
+        dispatch_async(dispatch_get_main_queue(), block);
+    }
+}
+
 bool tech3c_ios_initialize(const char* appKey, const char* appSecret) {
     if (!appKey || !appSecret) {
         NSLog(@"[Tech3C Bridge] ERROR: appKey or appSecret is null");
@@ -267,24 +277,64 @@ void tech3c_ios_setEnableRequireBOD(bool enable) {
     }
 }
 
+void tech3c_ios_applyConfig(const tech3c_ios_config* config) {
+    if (!config) {
+        return;
+    }
+
+    // The caller's strings are gone by the time the block runs, copy everything first
+    tech3c_ios_config values = *config;
+    NSString *serverIp = config->ipMaintenanceCheck ? [NSString stringWithUTF8String:config->ipMaintenanceCheck] : nil;
+    values.ipMaintenanceCheck = NULL;
+
+    tech3c_ios_runOnMain(^{
+        Tech3CIdController *controller = [Tech3CIdController shared];
+        if (!controller) {
+            NSLog(@"[Tech3C Bridge] ERROR: Controller not initialized");
+            return;
+        }
+
+        // Bits match tech3c::ConfigField
+        unsigned int mask = values.mask;
+        if (mask & (1u << 0)) [controller setDebug:values.debugMode];
+        if (mask & (1u << 1)) [controller setUiMode:(values.uiMode == 0) ? UiModeDialog : UiModeFullscreen];
+        if (mask & (1u << 2)) [controller setLanguageDisplay:(Language)values.language];
+        if (mask & (1u << 3)) [controller setOrientation:(OrientationMode)values.orientation];
+        if (mask & (1u << 4)) [controller setEnableGuestLogin:values.enableGuestLogin];
+        if (mask & (1u << 5)) [controller setDisableExitLogin:values.disableExitLogin];
+        if (mask & (1u << 6)) [controller setRequireOtp:values.requireOtp];
+        if (mask & (1u << 7)) [controller setEnableMaintenanceCheck:values.enableMaintenanceCheck];
+        if ((mask & (1u << 8)) && serverIp) {
+            [controller setServerIp:serverIp];
+        }
+        if (mask & (1u << 9)) [controller setEnableRequireBOD:values.enableRequireBOD];
+
+        NSLog(@"[Tech3C Bridge] Config applied, mask: 0x%x", mask);
+    });
+}
+
 #pragma mark - Authentication Methods
 
 void tech3c_ios_showAuth(void) {
-    Tech3CIdController *controller = [Tech3CIdController shared];
-    if (controller) {
-        NSLog(@"[Tech3C Bridge] Showing auth screen");
-        [controller showAuth];
-    } else {
-        NSLog(@"[Tech3C Bridge] ERROR: Controller not initialized");
-    }
+    tech3c_ios_runOnMain(^{
+        Tech3CIdController *controller = [Tech3CIdController shared];
+        if (controller) {
+            NSLog(@"[Tech3C Bridge] Showing auth screen");
+            [controller showAuth];
+        } else {
+            NSLog(@"[Tech3C Bridge] ERROR: Controller not initialized");
+        }
+    });
 }
 
 void tech3c_ios_logout(void) {
-    Tech3CIdController *controller = [Tech3CIdController shared];
-    if (controller) {
-        NSLog(@"[Tech3C Bridge] Logging out");
-        [controller logout];
-    }
+    tech3c_ios_runOnMain(^{
+        Tech3CIdController *controller = [Tech3CIdController shared];
+        if (controller) {
+            NSLog(@"[Tech3C Bridge] Logging out");
+            [controller logout];
+        }
+    });
 }
 
 void tech3c_ios_changePassword(void) {
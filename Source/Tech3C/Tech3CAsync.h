@@ -0,0 +1,336 @@
+#pragma once
+
+#include "Tech3CTypes.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define TECH3C_HAS_COROUTINES 1
+#else
+#define TECH3C_HAS_COROUTINES 0
+#endif
+
+namespace tech3c {
+
+    // Error codes reported by async operations, next to the SDK's own 1xxx/2xxx codes
+    constexpr int ERROR_AUTH_CANCELLED = 3000;          // The player closed the auth screen
+    constexpr int ERROR_OPERATION_CANCELLED = 3001;     // Cancelled through a CancellationToken or cleanup()
+    constexpr int ERROR_NOT_LOGGED_IN = 3002;           // No user to get a token for, or logged out while waiting
+    constexpr int ERROR_CIRCUIT_OPEN = 3003;            // Failed fast, the backend's circuit breaker is open
+
+    // Value type for operations that only succeed or fail
+    using Done = std::monostate;
+
+    // Outcome of an async operation: a value or an ErrorInfo
+    template <typename T>
+    class AsyncResult {
+    public:
+        AsyncResult(T value) : m_value(std::move(value)) {}
+        AsyncResult(ErrorInfo error) : m_error(std::move(error)) {}
+
+        bool ok() const { return m_value.has_value(); }
+        explicit operator bool() const { return ok(); }
+
+        const T& value() const { return *m_value; }
+        T& value() { return *m_value; }
+        const ErrorInfo& error() const { return m_error; }
+
+    private:
+        std::optional<T> m_value;
+        ErrorInfo m_error;
+    };
+
+    //========================================================================
+    // Cancellation
+
+    namespace detail {
+        struct CancellationState {
+            std::atomic<bool> cancelled{false};
+            std::mutex mutex;
+            std::condition_variable callbackDone;
+            uint64_t nextId = 1;
+            std::vector<std::pair<uint64_t, std::function<void()>>> callbacks;
+            // Callback cancel() is running right now, and on which thread
+            uint64_t runningId = 0;
+            std::thread::id runningThread;
+        };
+    }
+
+    // Observes a CancellationSource. A default constructed token is never cancelled.
+    class CancellationToken {
+    public:
+        CancellationToken() = default;
+
+        bool isCancelled() const { return m_state && m_state->cancelled.load(std::memory_order_acquire); }
+        bool canBeCancelled() const { return m_state != nullptr; }
+
+        // Runs callback on the cancelling thread, or right away if already cancelled; returns 0 in that case
+        uint64_t subscribe(std::function<void()> callback) const {
+            if (!m_state) {
+                return 0;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                if (!m_state->cancelled.load(std::memory_order_acquire)) {
+                    uint64_t id = m_state->nextId++;
+                    m_state->callbacks.emplace_back(id, std::move(callback));
+                    return id;
+                }
+            }
+            callback();
+            return 0;
+        }
+
+        // Once this returns the callback will not run and is not running, so it may safely capture
+        // objects that die right after; only a callback unsubscribing itself does not wait for itself
+        void unsubscribe(uint64_t id) const {
+            if (!m_state || id == 0) {
+                return;
+            }
+            std::unique_lock<std::mutex> lock(m_state->mutex);
+            for (auto it = m_state->callbacks.begin(); it != m_state->callbacks.end(); ++it) {
+                if (it->first == id) {
+                    m_state->callbacks.erase(it);
+                    return;
+                }
+            }
+            if (m_state->runningThread != std::this_thread::get_id()) {
+                m_state->callbackDone.wait(lock, [this, id]() { return m_state->runningId != id; });
+            }
+        }
+
+    private:
+        friend class CancellationSource;
+        explicit CancellationToken(std::shared_ptr<detail::CancellationState> state) : m_state(std::move(state)) {}
+
+        std::shared_ptr<detail::CancellationState> m_state;
+    };
+
+    // Owner side of a cancellation; cancel() may be called from any thread
+    class CancellationSource {
+    public:
+        CancellationSource() : m_state(std::make_shared<detail::CancellationState>()) {}
+
+        CancellationToken getToken() const { return CancellationToken(m_state); }
+        bool isCancelled() const { return m_state->cancelled.load(std::memory_order_acquire); }
+
+        void cancel() {
+            std::unique_lock<std::mutex> lock(m_state->mutex);
+            if (m_state->cancelled.exchange(true, std::memory_order_acq_rel)) {
+                return;
+            }
+            // One at a time and unlocked while it runs, so callbacks may unsubscribe others
+            m_state->runningThread = std::this_thread::get_id();
+            while (!m_state->callbacks.empty()) {
+                auto callback = std::move(m_state->callbacks.front());
+                m_state->callbacks.erase(m_state->callbacks.begin());
+                m_state->runningId = callback.first;
+                lock.unlock();
+                callback.second();
+                lock.lock();
+                m_state->runningId = 0;
+                m_state->callbackDone.notify_all();
+            }
+            m_state->runningThread = std::thread::id();
+        }
+
+    private:
+        std::shared_ptr<detail::CancellationState> m_state;
+    };
+
+    //========================================================================
+    // AsyncOperation
+
+    namespace detail {
+        // Completed and observed on the axmol thread only, so it needs no synchronisation
+        template <typename T>
+        struct OperationState {
+            uint64_t id = 0;
+            std::optional<AsyncResult<T>> result;
+            std::vector<std::function<void(const AsyncResult<T>&)>> continuations;
+#if TECH3C_HAS_COROUTINES
+            std::coroutine_handle<> waiter;
+#endif
+            CancellationToken cancelToken;
+            uint64_t cancelSubscription = 0;
+
+            void complete(AsyncResult<T> value) {
+                if (result) {
+                    return;
+                }
+                result.emplace(std::move(value));
+                cancelToken.unsubscribe(cancelSubscription);
+                cancelSubscription = 0;
+
+                auto callbacks = std::move(continuations);
+                continuations.clear();
+                for (auto& callback : callbacks) {
+                    callback(*result);
+                }
+#if TECH3C_HAS_COROUTINES
+                if (waiter) {
+                    auto handle = waiter;
+                    waiter = nullptr;
+                    handle.resume();
+                }
+#endif
+            }
+        };
+    }
+
+    // Handle to a pending Tech3C operation. Await it from a tech3c::Task coroutine, or chain
+    // a continuation with then(); either way it completes on the axmol thread.
+    template <typename T>
+    class AsyncOperation {
+    public:
+        explicit AsyncOperation(std::shared_ptr<detail::OperationState<T>> state) : m_state(std::move(state)) {}
+
+        static AsyncOperation completed(AsyncResult<T> result) {
+            auto state = std::make_shared<detail::OperationState<T>>();
+            state->result.emplace(std::move(result));
+            return AsyncOperation(std::move(state));
+        }
+
+        bool isDone() const { return m_state->result.has_value(); }
+        // Only valid once isDone()
+        const AsyncResult<T>& getResult() const { return *m_state->result; }
+
+        // Runs callback on completion, immediately if the operation already finished. Callbacks
+        // added to the same operation run in the order they were added.
+        AsyncOperation& then(std::function<void(const AsyncResult<T>&)> callback) {
+            if (m_state->result) {
+                callback(*m_state->result);
+            } else {
+                m_state->continuations.push_back(std::move(callback));
+            }
+            return *this;
+        }
+
+#if TECH3C_HAS_COROUTINES
+        bool await_ready() const noexcept { return m_state->result.has_value(); }
+        void await_suspend(std::coroutine_handle<> handle) { m_state->waiter = handle; }
+        AsyncResult<T> await_resume() { return *m_state->result; }
+#endif
+
+    private:
+        std::shared_ptr<detail::OperationState<T>> m_state;
+    };
+
+#if TECH3C_HAS_COROUTINES
+    //========================================================================
+    // Task
+
+    namespace detail {
+        struct TaskPromiseBase {
+            std::coroutine_handle<> continuation;
+            bool detached = false;
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+                template <typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                    TaskPromiseBase& promise = handle.promise();
+                    if (promise.continuation) {
+                        return promise.continuation;
+                    }
+                    if (promise.detached) {
+                        handle.destroy();
+                    }
+                    return std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            FinalAwaiter final_suspend() noexcept { return {}; }
+
+            void unhandled_exception() { std::terminate(); }
+        };
+
+        template <typename T>
+        struct TaskPromise : TaskPromiseBase {
+            std::optional<T> value;
+            void return_value(T v) { value.emplace(std::move(v)); }
+        };
+
+        template <>
+        struct TaskPromise<void> : TaskPromiseBase {
+            void return_void() {}
+        };
+    }
+
+    // Lazily started coroutine for game-side flows, e.g.
+    //   tech3c::Task<> loginFlow() {
+    //       auto user = co_await manager->authenticate();
+    //       if (!user) co_return;
+    //       ...
+    //   }
+    //   loginFlow().detach();
+    // co_await a Task to run it as a step of another Task, or detach() it to start it on its own;
+    // a detached Task frees itself when it finishes.
+    template <typename T = void>
+    class Task {
+    public:
+        struct promise_type : detail::TaskPromise<T> {
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        };
+
+        Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                reset();
+                m_handle = std::exchange(other.m_handle, nullptr);
+            }
+            return *this;
+        }
+        ~Task() { reset(); }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        void detach() {
+            if (!m_handle) {
+                return;
+            }
+            auto handle = std::exchange(m_handle, nullptr);
+            handle.promise().detached = true;
+            handle.resume();
+        }
+
+        bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            m_handle.promise().continuation = awaiting;
+            return m_handle;
+        }
+        auto await_resume() {
+            if constexpr (!std::is_void_v<T>) {
+                return std::move(*m_handle.promise().value);
+            }
+        }
+
+    private:
+        explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+        void reset() {
+            if (m_handle) {
+                m_handle.destroy();
+                m_handle = nullptr;
+            }
+        }
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+#endif
+}
@@ -0,0 +1,130 @@
+#include "Tech3CBridgeChannel.h"
+#include "Tech3CLog.h"
+
+using namespace tech3c;
+
+namespace {
+
+    constexpr size_t alignRecord(size_t size) {
+        return (size + CHANNEL_RECORD_HEADER_BYTES - 1) & ~(CHANNEL_RECORD_HEADER_BYTES - 1);
+    }
+}
+
+//========================================================================
+// ChannelWriter
+
+ChannelWriter::ChannelWriter()
+        : m_data(nullptr)
+        , m_capacity(0)
+        , m_head(0)
+        , m_tail(0)
+        , m_recordSize(0)
+        , m_cursor(0)
+        , m_recordEnd(0) {
+}
+
+bool ChannelWriter::attach(void* data, size_t capacity) {
+    if (!data || !isValidChannelCapacity(capacity)) {
+        return false;
+    }
+    m_data = static_cast<uint8_t*>(data);
+    m_capacity = capacity;
+    m_head = 0;
+    m_tail = 0;
+    m_recordSize = 0;
+    return true;
+}
+
+bool ChannelWriter::begin(ChannelRecord type, size_t payloadBytes) {
+    if (!m_data || payloadBytes > m_capacity) {
+        return false;
+    }
+    const size_t size = alignRecord(CHANNEL_RECORD_HEADER_BYTES + payloadBytes);
+    const uint64_t free = m_capacity - (m_tail - m_head);
+    size_t offset = static_cast<size_t>(m_tail & (m_capacity - 1));
+    const size_t contiguous = m_capacity - offset;
+
+    if (size > contiguous) {
+        // Pad out the end and start over at 0, if the consumer has freed the space for both
+        if (contiguous + size > free) {
+            return false;
+        }
+        writeHeader(offset, contiguous, ChannelRecord::PAD);
+        m_tail += contiguous;
+        offset = 0;
+    } else if (size > free) {
+        return false;
+    }
+
+    writeHeader(offset, size, type);
+    m_recordSize = size;
+    m_cursor = offset + CHANNEL_RECORD_HEADER_BYTES;
+    m_recordEnd = offset + size;
+    return true;
+}
+
+void ChannelWriter::putLong(int64_t value) {
+    std::memcpy(m_data + m_cursor, &value, sizeof(value));
+    m_cursor += sizeof(value);
+}
+
+void ChannelWriter::putString(std::string_view value) {
+    const uint32_t length = static_cast<uint32_t>(value.size());
+    std::memcpy(m_data + m_cursor, &length, sizeof(length));
+    std::memcpy(m_data + m_cursor + sizeof(length), value.data(), value.size());
+    m_cursor += sizeof(length) + value.size();
+}
+
+uint64_t ChannelWriter::commit() {
+    // Deterministic padding, the ring may be dumped while debugging
+    std::memset(m_data + m_cursor, 0, m_recordEnd - m_cursor);
+    m_tail += m_recordSize;
+    m_recordSize = 0;
+    return m_tail;
+}
+
+void ChannelWriter::writeHeader(size_t offset, size_t size, ChannelRecord type) {
+    const uint32_t size32 = static_cast<uint32_t>(size);
+    const uint16_t header[2] = { static_cast<uint16_t>(type), 0 };
+    std::memcpy(m_data + offset, &size32, sizeof(size32));
+    std::memcpy(m_data + offset + sizeof(size32), header, sizeof(header));
+}
+
+//========================================================================
+// ChannelReader
+
+ChannelReader::ChannelReader()
+        : m_data(nullptr)
+        , m_capacity(0)
+        , m_head(0) {
+}
+
+bool ChannelReader::attach(const void* data, size_t capacity) {
+    if (!data || !isValidChannelCapacity(capacity)) {
+        return false;
+    }
+    m_data = static_cast<const uint8_t*>(data);
+    m_capacity = capacity;
+    m_head = 0;
+    return true;
+}
+
+void ChannelReader::reportCorrupt(uint64_t tail) const {
+    TECH3C_LOGE("Bridge channel: bad record or tail {} at head {}, stopped reading", tail, m_head);
+}
+
+//========================================================================
+// BridgeChannel
+
+BridgeChannel& BridgeChannel::getInstance() {
+    static BridgeChannel instance;
+    return instance;
+}
+
+bool BridgeChannel::attach(void* events, size_t eventCapacity, void* commands, size_t commandCapacity) {
+    if (!isValidChannelCapacity(eventCapacity) || !isValidChannelCapacity(commandCapacity)) {
+        TECH3C_LOGE("Bridge channel: ring sizes {} / {} are not powers of two", eventCapacity, commandCapacity);
+        return false;
+    }
+    return m_events.attach(events, eventCapacity) && m_commands.attach(commands, commandCapacity);
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace tech3c {
+
+    // Binary records passed between native code and Tech3CChannel.java through two direct
+    // ByteBuffers, one ring per direction, so SDK callbacks and bridge calls carry no jstrings.
+    //
+    // A ring is a power of two bytes; positions only grow and are taken modulo the size. Every
+    // record starts 8-byte aligned with an 8-byte header { uint32 size; uint16 type; uint16 0 },
+    // size covering header, fields and padding. Fields follow in the order listed per type:
+    // longs as 8 bytes, strings as a uint32 byte length and that many UTF-8 bytes, all in native
+    // byte order. A record never wraps: the producer fills the end of the ring with a PAD record
+    // and starts over at 0.
+    //
+    // Positions never live in the buffers, so neither side needs the memory fences Java only has
+    // from Android 33 on. Commands: native code passes its tail as the argument of
+    // Tech3CChannel.onCommands, which reads every record up to it before returning. Events: Java
+    // publishes its tail in the volatile Tech3CChannel.sEventTail without calling into native
+    // code; Tech3CSession::readChannelEvents() reads it through JNI once per frame (or on
+    // Tech3CChannel.flush()) and stores the new head in the volatile sEventHead. JNI field access
+    // keeps volatile semantics, which orders the record bytes against the positions.
+    //
+    // Keep in sync with Tech3CChannel.java.
+    enum class ChannelRecord : uint16_t {
+        PAD = 0,                    // Skipped, the next record is at the start of the ring
+
+        // Java -> native, Tech3CSession::readChannelEvents
+        LOGIN_SUCCESS = 1,          // userId, accessToken, refreshToken: string; loginType, expiryTime: long
+        REGISTER_SUCCESS = 2,       // userId, accessToken, refreshToken: string; expiryTime: long
+        AUTH_ERROR = 3,             // message: string
+        AUTH_CANCELLED = 4,
+        AUTH_SCREEN_OPENED = 5,
+
+        // native -> Java, Tech3CChannel.onCommands
+        SHOW_AUTH = 32,
+        LOGOUT = 33,
+        // mask, debugMode, uiMode, language, orientation, enableGuestLogin, disableExitLogin,
+        // requireOtp, enableMaintenanceCheck: long; ipMaintenanceCheck: string; enableRequireBOD: long
+        APPLY_CONFIG = 34,
+    };
+
+    constexpr size_t CHANNEL_RECORD_HEADER_BYTES = 8;
+    constexpr size_t CHANNEL_LONG_BYTES = 8;
+
+    constexpr size_t channelStringBytes(std::string_view value) { return 4 + value.size(); }
+
+    // True for a buffer either side can use as a ring
+    constexpr bool isValidChannelCapacity(size_t capacity) {
+        return capacity >= 64 && capacity <= (size_t(1) << 30) && (capacity & (capacity - 1)) == 0;
+    }
+
+    // Producer side of a ring over memory owned by someone else, one thread at a time:
+    // begin() a record, put its fields, commit() and hand the returned tail to the consumer.
+    class ChannelWriter {
+    public:
+        ChannelWriter();
+
+        // capacity per isValidChannelCapacity(); starts at position 0 on both sides
+        bool attach(void* data, size_t capacity);
+        bool isAttached() const { return m_data != nullptr; }
+
+        // Starts a record with payloadBytes of fields, false when it does not fit the free space
+        bool begin(ChannelRecord type, size_t payloadBytes);
+        void putLong(int64_t value);
+        void putString(std::string_view value);
+        // Ends the record begun last, returns the tail to pass to the consumer
+        uint64_t commit();
+
+        // The consumer has read everything before head
+        void setHead(uint64_t head) { m_head = head; }
+        uint64_t getTail() const { return m_tail; }
+
+    private:
+        ChannelWriter(const ChannelWriter&) = delete;
+        ChannelWriter& operator=(const ChannelWriter&) = delete;
+
+        void writeHeader(size_t offset, size_t size, ChannelRecord type);
+
+        uint8_t* m_data;
+        size_t m_capacity;
+        uint64_t m_head;
+        uint64_t m_tail;
+        // Record between begin() and commit()
+        size_t m_recordSize;
+        size_t m_cursor;
+        size_t m_recordEnd;
+    };
+
+    // The fields of one record, read in place: strings point into the ring and stay valid only
+    // until the read() that produced the record returns. Getters fail once a record runs short.
+    class ChannelFields {
+    public:
+        ChannelFields(ChannelRecord type, const uint8_t* data, size_t size)
+                : m_type(type), m_data(data), m_size(size), m_cursor(0) {}
+
+        ChannelRecord getType() const { return m_type; }
+
+        bool getLong(int64_t& out) {
+            if (m_size - m_cursor < CHANNEL_LONG_BYTES) {
+                return false;
+            }
+            std::memcpy(&out, m_data + m_cursor, CHANNEL_LONG_BYTES);
+            m_cursor += CHANNEL_LONG_BYTES;
+            return true;
+        }
+
+        bool getString(std::string_view& out) {
+            uint32_t length;
+            if (m_size - m_cursor < sizeof(length)) {
+                return false;
+            }
+            std::memcpy(&length, m_data + m_cursor, sizeof(length));
+            if (m_size - m_cursor - sizeof(length) < length) {
+                return false;
+            }
+            out = std::string_view(reinterpret_cast<const char*>(m_data + m_cursor + sizeof(length)), length);
+            m_cursor += sizeof(length) + length;
+            return true;
+        }
+
+    private:
+        ChannelRecord m_type;
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_cursor;
+    };
+
+    // Consumer side of a ring, one thread at a time
+    class ChannelReader {
+    public:
+        ChannelReader();
+
+        bool attach(const void* data, size_t capacity);
+        bool isAttached() const { return m_data != nullptr; }
+        uint64_t getHead() const { return m_head; }
+
+        // Calls onRecord(ChannelFields&) for each record up to the producer's tail and returns the
+        // new head. A tail or record the ring cannot hold stops the read where it is, so a
+        // misbehaving producer runs out of space instead of making native code read past the buffer.
+        template <typename OnRecord>
+        uint64_t read(uint64_t tail, OnRecord&& onRecord) {
+            if (!m_data || tail < m_head || tail - m_head > m_capacity) {
+                reportCorrupt(tail);
+                return m_head;
+            }
+            while (m_head < tail) {
+                const size_t offset = static_cast<size_t>(m_head & (m_capacity - 1));
+                const size_t available = static_cast<size_t>(std::min<uint64_t>(tail - m_head, m_capacity - offset));
+                // The header has to be inside the ring before it is read
+                if (available < CHANNEL_RECORD_HEADER_BYTES || offset % CHANNEL_RECORD_HEADER_BYTES != 0) {
+                    reportCorrupt(tail);
+                    return m_head;
+                }
+                uint32_t size;
+                uint16_t type;
+                std::memcpy(&size, m_data + offset, sizeof(size));
+                std::memcpy(&type, m_data + offset + sizeof(size), sizeof(type));
+                if (size < CHANNEL_RECORD_HEADER_BYTES || size % CHANNEL_RECORD_HEADER_BYTES != 0 || size > available) {
+                    reportCorrupt(tail);
+                    return m_head;
+                }
+                if (static_cast<ChannelRecord>(type) != ChannelRecord::PAD) {
+                    ChannelFields fields(static_cast<ChannelRecord>(type), m_data + offset + CHANNEL_RECORD_HEADER_BYTES,
+                                         size - CHANNEL_RECORD_HEADER_BYTES);
+                    onRecord(fields);
+                }
+                m_head += size;
+            }
+            return m_head;
+        }
+
+    private:
+        ChannelReader(const ChannelReader&) = delete;
+        ChannelReader& operator=(const ChannelReader&) = delete;
+
+        void reportCorrupt(uint64_t tail) const;
+
+        const uint8_t* m_data;
+        size_t m_capacity;
+        uint64_t m_head;
+    };
+
+    // The rings shared with Tech3CChannel.java, process wide like the native SDK they talk to.
+    // Events are read by Tech3CSession::readChannelEvents() under a lock of its own; commands
+    // are written on the SDK worker thread.
+    class BridgeChannel {
+    public:
+        static BridgeChannel& getInstance();
+
+        // Java hands over its buffers once, before the SDK is initialized
+        bool attach(void* events, size_t eventCapacity, void* commands, size_t commandCapacity);
+
+        ChannelReader& getEvents() { return m_events; }
+        ChannelWriter& getCommands() { return m_commands; }
+
+    private:
+        BridgeChannel() = default;
+        BridgeChannel(const BridgeChannel&) = delete;
+        BridgeChannel& operator=(const BridgeChannel&) = delete;
+
+        ChannelReader m_events;
+        ChannelWriter m_commands;
+    };
+}
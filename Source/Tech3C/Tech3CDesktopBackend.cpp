@@ -0,0 +1,348 @@
+#include "Tech3CDesktopBackend.h"
+
+#if TECH3C_DESKTOP_BACKEND
+
+#include "Tech3CHttp.h"
+#include "Tech3CJson.h"
+#include "Tech3CLog.h"
+#include "Tech3CSession.h"
+#include "Tech3CTrace.h"
+#include <cstdlib>
+#include <thread>
+
+using namespace tech3c;
+
+namespace {
+
+    // Kept open from initialize() on: one for the auth flows and one for token refreshes
+    const size_t PRECONNECT_CONNECTIONS = 2;
+
+    DesktopAuthFlow flowFromEnvironment() {
+        const char* value = std::getenv("TECH3C_DESKTOP_FLOW");
+        std::string flow = value ? value : "";
+        if (flow == "guest") return DesktopAuthFlow::GUEST;
+        if (flow == "social") return DesktopAuthFlow::SOCIAL;
+        if (flow == "register") return DesktopAuthFlow::REGISTER;
+        if (flow == "cancel") return DesktopAuthFlow::CANCEL;
+        if (flow == "invalid") return DesktopAuthFlow::INVALID_CREDENTIALS;
+        return DesktopAuthFlow::ACCOUNT;
+    }
+
+    std::string envOr(const char* name, const char* fallback) {
+        const char* value = std::getenv(name);
+        return (value && *value) ? value : fallback;
+    }
+}
+
+DesktopBackend::DesktopBackend(Tech3CSession* owner, SessionHost& host)
+        : m_owner(owner)
+        , m_host(host)
+        , m_client(nullptr)
+        , m_running(false)
+        , m_flow(flowFromEnvironment())
+        , m_username(envOr("TECH3C_DESKTOP_USER", "player"))
+        , m_password(envOr("TECH3C_DESKTOP_PASSWORD", "password"))
+        , m_worker("tech3c desktop backend", host.getWorkerPool()) {
+}
+
+DesktopBackend::~DesktopBackend() {
+    shutdown();
+}
+
+bool DesktopBackend::initialize(const std::string& clientId, const std::string& clientSecret, std::string& error) {
+    m_client = m_host.connectAuthService(error);
+    if (!m_client) {
+        return false;
+    }
+    // The handshakes overlap each other, and the init request below already runs on a warm
+    // connection; later sessions of the host find them pooled and open none
+    m_client->preconnect(PRECONNECT_CONNECTIONS);
+
+    std::string body = "{";
+    json::appendField(body, "clientId", clientId);
+    json::appendField(body, "clientSecret", clientSecret);
+    body += "}";
+
+    HttpResponse response = requestWithRetry("POST", "/v1/auth/init", body);
+    if (!response.ok()) {
+        std::string_view message;
+        error = json::getString(response.getBody(), "error", message) ? std::string(message)
+                : (response.error.empty() ? "HTTP " + std::to_string(response.status) : response.error);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running = true;
+    return true;
+}
+
+void DesktopBackend::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    // Queued requests still run so logout reaches the server
+    m_worker.stop();
+}
+
+void DesktopBackend::applyConfig(const Config& config) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+}
+
+void DesktopBackend::setRetryPolicy(const RetryPolicy& policy) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_retryPolicy = policy;
+}
+
+void DesktopBackend::setAuthFlow(DesktopAuthFlow flow) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_flow = flow;
+}
+
+void DesktopBackend::setAccount(const std::string& username, const std::string& password) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_username = username;
+    m_password = password;
+}
+
+void DesktopBackend::showAuth() {
+    DesktopAuthFlow flow;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        flow = m_flow;
+    }
+    post([this, flow]() { runAuth(flow); });
+}
+
+void DesktopBackend::logout() {
+    post([this]() {
+        TECH3C_TRACE_SCOPE("desktop", "DesktopBackend::logout");
+        std::string body = "{";
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            json::appendField(body, "refreshToken", m_refreshToken);
+            m_refreshToken.clear();
+        }
+        body += "}";
+
+        HttpResponse response = m_client->post("/v1/auth/logout", body);
+        if (!response.ok()) {
+            deliverError(response, "Failed to logout");
+        }
+    });
+}
+
+TokenRefreshResult DesktopBackend::refreshTokens(std::string_view refreshToken) {
+    TECH3C_TRACE_SCOPE("desktop", "DesktopBackend::refreshTokens");
+    TokenRefreshResult result;
+
+    std::string body = "{";
+    json::appendField(body, "refreshToken", refreshToken);
+    body += "}";
+
+    // One attempt, the session spaces out the retries itself while the token is still good
+    HttpResponse response = m_client->post("/v1/auth/refresh", body);
+    std::string_view accessToken, newRefreshToken, message;
+    int64_t expiryTime = 0;
+    if (!response.ok()) {
+        result.error = json::getString(response.getBody(), "error", message) ? std::string(message)
+                : (response.error.empty() ? "HTTP " + std::to_string(response.status) : response.error);
+        // The service turned the refresh token down, asking again gets the same answer
+        result.retryable = response.rejected || response.status < 400 || response.status >= 500;
+        if (response.rejected) {
+            result.retryAfterMs = m_client->getCircuitBreaker()->getRetryAfter().count();
+        }
+        return result;
+    }
+    if (!json::getString(response.getBody(), "accessToken", accessToken)
+        || !json::getInt64(response.getBody(), "expiryTime", expiryTime)) {
+        result.error = "Malformed refresh response";
+        return result;
+    }
+    json::getString(response.getBody(), "refreshToken", newRefreshToken);
+
+    // Prefer the millisecond serverTime field, the Date header only has second resolution
+    if (!json::getInt64(response.getBody(), "serverTime", result.serverTime)) {
+        http::parseHttpDate(response.getDate(), result.serverTime);
+    }
+
+    result.success = true;
+    result.accessToken.assign(accessToken);
+    result.refreshToken.assign(newRefreshToken);
+    result.expiryTime = expiryTime;
+
+    if (!newRefreshToken.empty()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_refreshToken = result.refreshToken;
+    }
+    return result;
+}
+
+void DesktopBackend::waitIdle() {
+    m_worker.flush();
+}
+
+void DesktopBackend::post(std::function<void()> task) {
+    // Under m_mutex so shutdown() either finds the task queued or it is never posted
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) {
+        return;
+    }
+    m_worker.post(std::move(task));
+}
+
+void DesktopBackend::runAuth(DesktopAuthFlow flow) {
+    TECH3C_TRACE_SCOPE("desktop", "DesktopBackend::runAuth");
+    std::string username, password, maintenanceEndpoints;
+    bool maintenanceCheck;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        username = m_username;
+        password = m_password;
+        maintenanceCheck = m_config.enableMaintenanceCheck;
+        maintenanceEndpoints = m_config.ipMaintenanceCheck;
+    }
+
+    if (flow == DesktopAuthFlow::CANCEL) {
+        // Nothing to send, so the maintenance check is a request of its own
+        if (maintenanceCheck && isUnderMaintenance(maintenanceEndpoints)) {
+            m_owner->onError("Server is under maintenance");
+            return;
+        }
+        m_owner->onAuthScreenOpened();
+        m_owner->onAuthCancelled();
+        return;
+    }
+
+    // Configured maintenance endpoints are probed before anything is sent, answered from the host's
+    // cache while it is fresh. Without them the auth service refuses logins with 503 while under
+    // maintenance, so the check rides on the login itself and a warm login is one round trip.
+    // The simulated auth screen only opens once the check has an answer, the way the SDK shows
+    // its maintenance notice instead.
+    const bool checkOnLogin = maintenanceCheck && maintenanceEndpoints.empty();
+    if (maintenanceCheck && !checkOnLogin && isUnderMaintenance(maintenanceEndpoints)) {
+        m_owner->onError("Server is under maintenance");
+        return;
+    }
+    if (!checkOnLogin) {
+        m_owner->onAuthScreenOpened();
+    }
+
+    std::string body = "{";
+    const char* path = "/v1/auth/login";
+    switch (flow) {
+        case DesktopAuthFlow::CANCEL:
+            break;
+        case DesktopAuthFlow::GUEST:
+            json::appendField(body, "flow", "guest");
+            break;
+        case DesktopAuthFlow::SOCIAL:
+            json::appendField(body, "flow", "social");
+            break;
+        case DesktopAuthFlow::REGISTER:
+            path = "/v1/auth/register";
+            json::appendField(body, "username", username);
+            json::appendField(body, "password", password);
+            break;
+        case DesktopAuthFlow::INVALID_CREDENTIALS:
+            password += "-invalid";
+            // fall through
+        case DesktopAuthFlow::ACCOUNT:
+            json::appendField(body, "flow", "account");
+            json::appendField(body, "username", username);
+            json::appendField(body, "password", password);
+            break;
+    }
+    body += "}";
+
+    const int64_t sentAt = deviceTimeMs();
+    HttpResponse response = m_client->post(path, body);
+    if (checkOnLogin) {
+        bool maintenance = false;
+        if (response.status == 503 && json::getBool(response.getBody(), "maintenance", maintenance) && maintenance) {
+            m_owner->onError("Server is under maintenance");
+            return;
+        }
+        m_owner->onAuthScreenOpened();
+    }
+    if (!response.ok()) {
+        deliverError(response, "Authentication failed");
+        return;
+    }
+
+    // Known before the login is delivered, so the first token refresh is already skew corrected
+    int64_t serverTime = 0;
+    if (json::getInt64(response.getBody(), "serverTime", serverTime)) {
+        m_owner->reportServerTime(serverTime, sentAt, deviceTimeMs());
+    }
+    deliverTokens(response, flow == DesktopAuthFlow::REGISTER);
+}
+
+bool DesktopBackend::isUnderMaintenance(const std::string& endpoints) {
+    TECH3C_TRACE_SCOPE("desktop", "DesktopBackend::isUnderMaintenance");
+    if (!endpoints.empty()) {
+        // No endpoint answering is no reason to keep the player out, the login still finds out
+        return m_host.getMaintenanceProbe().check(endpoints).maintenance;
+    }
+
+    HttpResponse response = requestWithRetry("GET", "/v1/maintenance", std::string_view());
+    bool maintenance = false;
+    return response.ok() && json::getBool(response.getBody(), "maintenance", maintenance) && maintenance;
+}
+
+HttpResponse DesktopBackend::requestWithRetry(std::string_view method, std::string_view path, std::string_view body) {
+    RetryPolicy policy;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        policy = m_retryPolicy;
+    }
+
+    HttpResponse response = m_client->request(method, path, body);
+    for (int retry = 1; retry < policy.maxAttempts && response.isTransientFailure(); ++retry) {
+        const std::chrono::milliseconds delay = policy.delayBefore(retry);
+        TECH3C_LOGW("{} {} failed ({}), retrying in {} ms", method, path,
+                    response.error.empty() ? "HTTP " + std::to_string(response.status) : response.error, delay.count());
+        std::this_thread::sleep_for(delay);
+        response = m_client->request(method, path, body);
+    }
+    return response;
+}
+
+void DesktopBackend::deliverTokens(const HttpResponse& response, bool registered) {
+    std::string_view userId, accessToken, refreshToken;
+    int64_t loginType = (int64_t)LoginType::ACCOUNT;
+    int64_t expiryTime = 0;
+    if (!json::getString(response.getBody(), "userId", userId)
+        || !json::getString(response.getBody(), "accessToken", accessToken)) {
+        m_owner->onError("Malformed auth response");
+        return;
+    }
+    json::getString(response.getBody(), "refreshToken", refreshToken);
+    json::getInt64(response.getBody(), "loginType", loginType);
+    json::getInt64(response.getBody(), "expiryTime", expiryTime);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_refreshToken.assign(refreshToken);
+    }
+
+    if (registered) {
+        m_owner->onRegisterSuccess(userId, accessToken, refreshToken, expiryTime);
+    } else {
+        m_owner->onLoginSuccess(userId, accessToken, refreshToken, (int)loginType, expiryTime);
+    }
+}
+
+void DesktopBackend::deliverError(const HttpResponse& response, const std::string& fallback) {
+    std::string_view message;
+    if (json::getString(response.getBody(), "error", message)) {
+        m_owner->onError(std::string(message));
+    } else if (!response.error.empty()) {
+        m_owner->onError(response.error);
+    } else {
+        m_owner->onError(fallback + " (HTTP " + std::to_string(response.status) + ")");
+    }
+}
+
+#endif
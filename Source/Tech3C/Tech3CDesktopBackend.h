@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Tech3CPlatform.h"
+#include "Tech3CTypes.h"
+
+#if TECH3C_DESKTOP_BACKEND
+
+#include "Tech3CHttpClient.h"
+#include "Tech3CSessionHost.h"
+#include "Tech3CStandInServer.h"
+#include "Tech3CWorker.h"
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace tech3c {
+
+    class Tech3CSession;
+
+    // What the simulated auth screen does when showAuth() is called on desktop.
+    // Defaults to TECH3C_DESKTOP_FLOW (account|guest|social|register|cancel|invalid), else ACCOUNT.
+    enum class DesktopAuthFlow {
+        ACCOUNT = 0,
+        GUEST,
+        SOCIAL,
+        REGISTER,
+        CANCEL,
+        INVALID_CREDENTIALS
+    };
+
+    // Desktop replacement for the native Tech3C SDK. Talks to the auth service at
+    // TECH3C_AUTH_URL, or to an in-process StandInAuthServer when the host allows it, and
+    // reports results through the same Tech3CSession entry points the JNI/iOS bridges use.
+    // Network work runs on a backend Worker of the session's host, never on the caller's.
+    class DesktopBackend {
+    public:
+        // host must outlive the backend
+        DesktopBackend(Tech3CSession* owner, SessionHost& host);
+        ~DesktopBackend();
+
+        // Synchronous, validates the client credentials with the auth service
+        bool initialize(const std::string& clientId, const std::string& clientSecret, std::string& error);
+        // Finishes queued work and stops the backend worker; the host keeps its stand-in server
+        void shutdown();
+
+        void applyConfig(const Config& config);
+        // Backoff for the init request and the auth service's maintenance query
+        void setRetryPolicy(const RetryPolicy& policy);
+        void showAuth();
+        void logout();
+        // Synchronous, runs on the caller's thread (the token refresh thread)
+        TokenRefreshResult refreshTokens(std::string_view refreshToken);
+
+        void setAuthFlow(DesktopAuthFlow flow);
+        // Credentials typed into the simulated auth screen for ACCOUNT/REGISTER flows
+        void setAccount(const std::string& username, const std::string& password);
+
+        // Blocks until every queued request has completed
+        void waitIdle();
+
+        const std::string& getServerUrl() const { return m_client->getBaseUrl(); }
+        // The auth service's breaker, null before initialize()
+        CircuitBreaker* getCircuitBreaker() const { return m_client ? m_client->getCircuitBreaker() : nullptr; }
+        StandInAuthServer* getStandInServer() { return m_host.getStandInServer(); }
+
+    private:
+        DesktopBackend(const DesktopBackend&) = delete;
+        DesktopBackend& operator=(const DesktopBackend&) = delete;
+
+        void post(std::function<void()> task);
+        // Retries transient failures per the retry policy, blocking through the backoff; fails
+        // fast without retrying while the auth service's circuit breaker is open
+        HttpResponse requestWithRetry(std::string_view method, std::string_view path, std::string_view body);
+
+        void runAuth(DesktopAuthFlow flow);
+        // Probes the configured endpoints when there are any, otherwise asks the auth service
+        bool isUnderMaintenance(const std::string& endpoints);
+        void deliverTokens(const HttpResponse& response, bool registered);
+        void deliverError(const HttpResponse& response, const std::string& fallback);
+
+        Tech3CSession* m_owner;
+        SessionHost& m_host;
+        // Shared with the other sessions of the host, set by initialize()
+        HttpClient* m_client;
+
+        // Guarded by m_mutex
+        std::mutex m_mutex;
+        bool m_running;
+        Config m_config;
+        RetryPolicy m_retryPolicy;
+        DesktopAuthFlow m_flow;
+        std::string m_username;
+        std::string m_password;
+        std::string m_refreshToken;
+
+        Worker m_worker;
+    };
+}
+
+#endif
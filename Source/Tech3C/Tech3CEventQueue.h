@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Tech3CTypes.h"
+#include "Tech3CMpscRing.h"
+#include <cstdint>
+#include <utility>
+
+namespace tech3c {
+
+    // SDK events delivered from the JNI / iOS callback threads to the axmol thread
+    enum class EventType : uint8_t {
+        LOGIN_SUCCESS = 0,
+        REGISTER_SUCCESS,
+        AUTH_ERROR,
+        AUTH_CANCELLED,
+        AUTH_SCREEN_OPENED,
+        TOKEN_REFRESHED,
+        OPERATION_CANCELLED,
+        INITIALIZED,
+        LOGOUT_COMPLETED,
+        TOKEN_REFRESH_FAILED    // Background refresh, reaches the error callback but no auth operation
+    };
+
+    inline const char* eventTypeName(EventType type) {
+        switch (type) {
+            case EventType::LOGIN_SUCCESS: return "LOGIN_SUCCESS";
+            case EventType::REGISTER_SUCCESS: return "REGISTER_SUCCESS";
+            case EventType::AUTH_ERROR: return "AUTH_ERROR";
+            case EventType::AUTH_CANCELLED: return "AUTH_CANCELLED";
+            case EventType::AUTH_SCREEN_OPENED: return "AUTH_SCREEN_OPENED";
+            case EventType::TOKEN_REFRESHED: return "TOKEN_REFRESHED";
+            case EventType::OPERATION_CANCELLED: return "OPERATION_CANCELLED";
+            case EventType::INITIALIZED: return "INITIALIZED";
+            case EventType::LOGOUT_COMPLETED: return "LOGOUT_COMPLETED";
+            case EventType::TOKEN_REFRESH_FAILED: return "TOKEN_REFRESH_FAILED";
+        }
+        return "UNKNOWN";
+    }
+
+    struct SdkEvent {
+        EventType type;
+        UserSnapshot user;  // LOGIN_SUCCESS, REGISTER_SUCCESS, TOKEN_REFRESHED: the published user, not a copy
+        ErrorInfo error;    // AUTH_ERROR, TOKEN_REFRESH_FAILED, INITIALIZED / LOGOUT_COMPLETED (code 0 on success)
+        uint64_t operationId; // OPERATION_CANCELLED, LOGOUT_COMPLETED
+        uint64_t traceFlowId; // Links postEvent() with the dispatch in a trace, 0 when not tracing
+        uint32_t generation;  // Manager generation at postEvent(), stale events are dropped
+
+        SdkEvent() : type(EventType::AUTH_ERROR), operationId(0), traceFlowId(0), generation(0) {}
+        explicit SdkEvent(EventType t, uint64_t id = 0) : type(t), operationId(id), traceFlowId(0), generation(0) {}
+        SdkEvent(EventType t, UserSnapshot u) : type(t), user(std::move(u)), operationId(0), traceFlowId(0), generation(0) {}
+        explicit SdkEvent(const ErrorInfo& e, EventType t = EventType::AUTH_ERROR)
+            : type(t), error(e), operationId(0), traceFlowId(0), generation(0) {}
+    };
+
+    using SdkEventQueue = MpscRing<SdkEvent>;
+
+    // Per session; slots hold a UserSnapshot rather than the ~3 KB UserInfo, so a ring is ~32 KB
+    constexpr size_t DEFAULT_EVENT_QUEUE_CAPACITY = 256;
+}
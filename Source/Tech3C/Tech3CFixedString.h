@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace tech3c {
+
+    // String of at most Capacity bytes stored inline and always null terminated. Trivially
+    // copyable, so structs made of it copy with a memcpy and never touch the heap. Assigning a
+    // longer value fails and leaves the string unchanged rather than cutting a token short.
+    template <size_t Capacity>
+    class FixedString {
+        static_assert(Capacity > 0 && Capacity < UINT32_MAX, "Capacity out of range");
+
+    public:
+        static constexpr size_t capacity() { return Capacity; }
+
+        FixedString() : m_size(0) { m_data[0] = '\0'; }
+
+        // Returns false, changing nothing, when value is longer than Capacity
+        bool assign(std::string_view value) {
+            if (value.size() > Capacity) {
+                return false;
+            }
+            std::memmove(m_data, value.data(), value.size());
+            m_size = static_cast<uint32_t>(value.size());
+            m_data[m_size] = '\0';
+            return true;
+        }
+
+        void clear() {
+            m_size = 0;
+            m_data[0] = '\0';
+        }
+
+        std::string_view view() const { return std::string_view(m_data, m_size); }
+        operator std::string_view() const { return view(); }
+        std::string str() const { return std::string(m_data, m_size); }
+        const char* c_str() const { return m_data; }
+        const char* data() const { return m_data; }
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        friend bool operator==(const FixedString& a, const FixedString& b) { return a.view() == b.view(); }
+        friend bool operator!=(const FixedString& a, const FixedString& b) { return !(a == b); }
+
+    private:
+        uint32_t m_size;
+        char m_data[Capacity + 1];
+    };
+}
@@ -0,0 +1,602 @@
+#include "Tech3CHttp.h"
+
+#if TECH3C_DESKTOP_BACKEND
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#if TECH3C_HTTP_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // Apple platforms disable SIGPIPE per socket with SO_NOSIGPIPE instead
+#endif
+
+namespace tech3c {
+namespace http {
+
+    namespace {
+
+        void configureSocket(int fd) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        }
+
+        const char* statusText(int status) {
+            switch (status) {
+                case 200: return "OK";
+                case 400: return "Bad Request";
+                case 401: return "Unauthorized";
+                case 404: return "Not Found";
+                case 503: return "Service Unavailable";
+                default: return "Error";
+            }
+        }
+
+        bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+            if (a.size() != b.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < a.size(); ++i) {
+                char ca = a[i], cb = b[i];
+                if (ca >= 'A' && ca <= 'Z') ca = static_cast<char>(ca - 'A' + 'a');
+                if (cb >= 'A' && cb <= 'Z') cb = static_cast<char>(cb - 'A' + 'a');
+                if (ca != cb) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::string_view trim(std::string_view s) {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+            return s;
+        }
+
+        int remainingMs(std::chrono::steady_clock::time_point deadline) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            return left.count() > 0 ? static_cast<int>(left.count()) : 0;
+        }
+    }
+
+    bool parseUrl(std::string_view url, std::string& host, uint16_t& port) {
+        constexpr std::string_view scheme = "http://";
+        if (url.substr(0, scheme.size()) != scheme) {
+            return false;
+        }
+        url.remove_prefix(scheme.size());
+
+        size_t slash = url.find('/');
+        if (slash != std::string_view::npos) {
+            url = url.substr(0, slash);
+        }
+
+        size_t colon = url.rfind(':');
+        port = 80;
+        if (colon != std::string_view::npos) {
+            int value = 0;
+            for (char c : url.substr(colon + 1)) {
+                if (c < '0' || c > '9') {
+                    return false;
+                }
+                value = value * 10 + (c - '0');
+                if (value > 65535) {
+                    return false;
+                }
+            }
+            port = static_cast<uint16_t>(value);
+            url = url.substr(0, colon);
+        }
+
+        host.assign(url.data(), url.size());
+        return !host.empty();
+    }
+
+    int connectTcp(const std::string& host, uint16_t port, std::chrono::milliseconds timeout) {
+        std::vector<int> fds;
+        return connectTcpMany(host, port, 1, timeout, fds) == 1 ? fds[0] : -1;
+    }
+
+    size_t connectTcpMany(const std::string& host, uint16_t port, size_t count, std::chrono::milliseconds timeout,
+                          std::vector<int>& out) {
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo* result = nullptr;
+        std::string service = std::to_string(port);
+        if (count == 0 || getaddrinfo(host.c_str(), service.c_str(), &hints, &result) != 0) {
+            return 0;
+        }
+
+        // All missing connections to one address at once, the next address only for those that
+        // failed; the sockets stay non-blocking, every wait goes through the poller
+        const size_t before = out.size();
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        Poller poller;
+        std::vector<int> pending;
+        std::vector<int> ready;
+        for (addrinfo* ai = result; ai && out.size() - before < count; ai = ai->ai_next) {
+            for (size_t i = out.size() - before; i < count; ++i) {
+                int fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+                if (fd < 0) {
+                    break;
+                }
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+                if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+                    configureSocket(fd);
+                    out.push_back(fd);
+                } else if (errno == EINPROGRESS && poller.add(fd, true)) {
+                    pending.push_back(fd);
+                } else {
+                    ::close(fd);
+                }
+            }
+
+            while (!pending.empty()) {
+                poller.wait(std::chrono::milliseconds(remainingMs(deadline)), ready);
+                if (ready.empty()) {
+                    break;
+                }
+                for (int fd : ready) {
+                    poller.remove(fd);
+                    pending.erase(std::find(pending.begin(), pending.end(), fd));
+                    if (finishConnect(fd)) {
+                        out.push_back(fd);
+                    } else {
+                        ::close(fd);
+                    }
+                }
+            }
+            // Timed out, the handshakes still in flight are given up
+            for (int fd : pending) {
+                poller.remove(fd);
+                ::close(fd);
+            }
+            pending.clear();
+        }
+
+        freeaddrinfo(result);
+        return out.size() - before;
+    }
+
+    int beginConnect(const std::string& host, uint16_t port) {
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo* result = nullptr;
+        std::string service = std::to_string(port);
+        if (getaddrinfo(host.c_str(), service.c_str(), &hints, &result) != 0) {
+            return -1;
+        }
+
+        int fd = ::socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+        if (fd >= 0) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+            if (::connect(fd, result->ai_addr, result->ai_addrlen) != 0 && errno != EINPROGRESS) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(result);
+        return fd;
+    }
+
+    bool finishConnect(int fd) {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) != 0 || error != 0) {
+            return false;
+        }
+        configureSocket(fd);
+        return true;
+    }
+
+    int listenTcp(const std::string& host, uint16_t& port) {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1
+            || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+            || ::listen(fd, 64) != 0) {
+            ::close(fd);
+            return -1;
+        }
+
+        socklen_t len = sizeof(addr);
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        port = ntohs(addr.sin_port);
+        return fd;
+    }
+
+    int acceptTcp(int listenFd) {
+        int fd;
+        do {
+            fd = ::accept(listenFd, nullptr, nullptr);
+        } while (fd < 0 && errno == EINTR);
+        if (fd >= 0) {
+            configureSocket(fd);
+        }
+        return fd;
+    }
+
+    void closeSocket(int fd) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    bool sendAll(int fd, std::string_view data, std::chrono::milliseconds timeout, size_t* sent) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        if (sent) {
+            *sent = 0;
+        }
+        while (!data.empty()) {
+            pollfd pfd = { fd, POLLOUT, 0 };
+            if (::poll(&pfd, 1, remainingMs(deadline)) != 1) {
+                return false;
+            }
+            ssize_t n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR || errno == EAGAIN) continue;
+                return false;
+            }
+            data.remove_prefix(static_cast<size_t>(n));
+            if (sent) {
+                *sent += static_cast<size_t>(n);
+            }
+        }
+        return true;
+    }
+
+    //========================================================================
+    // Poller
+
+#if TECH3C_HTTP_EPOLL
+    Poller::Poller()
+            : m_count(0)
+            , m_epollFd(epoll_create1(EPOLL_CLOEXEC)) {
+    }
+
+    Poller::~Poller() {
+        closeSocket(m_epollFd);
+    }
+
+    bool Poller::add(int fd, bool writable) {
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = writable ? EPOLLOUT : (EPOLLIN | EPOLLRDHUP);
+        event.data.fd = fd;
+        if (m_epollFd < 0 || epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            return false;
+        }
+        ++m_count;
+        return true;
+    }
+
+    void Poller::remove(int fd) {
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr) == 0) {
+            --m_count;
+        }
+    }
+
+    void Poller::wait(std::chrono::milliseconds timeout, std::vector<int>& ready) {
+        ready.clear();
+        epoll_event events[64];
+        int n;
+        do {
+            n = epoll_wait(m_epollFd, events, 64, static_cast<int>(timeout.count()));
+        } while (n < 0 && errno == EINTR);
+        for (int i = 0; i < n; ++i) {
+            ready.push_back(events[i].data.fd);
+        }
+    }
+#else
+    Poller::Poller()
+            : m_count(0) {
+    }
+
+    Poller::~Poller() {
+    }
+
+    bool Poller::add(int fd, bool writable) {
+        m_fds.push_back({ fd, static_cast<short>(writable ? POLLOUT : POLLIN), 0 });
+        ++m_count;
+        return true;
+    }
+
+    void Poller::remove(int fd) {
+        for (auto it = m_fds.begin(); it != m_fds.end(); ++it) {
+            if (it->fd == fd) {
+                m_fds.erase(it);
+                --m_count;
+                return;
+            }
+        }
+    }
+
+    void Poller::wait(std::chrono::milliseconds timeout, std::vector<int>& ready) {
+        ready.clear();
+        int n;
+        do {
+            n = ::poll(m_fds.data(), m_fds.size(), static_cast<int>(timeout.count()));
+        } while (n < 0 && errno == EINTR);
+        for (size_t i = 0; n > 0 && i < m_fds.size(); ++i) {
+            if (m_fds[i].revents != 0) {
+                ready.push_back(m_fds[i].fd);
+            }
+        }
+    }
+#endif
+
+    //========================================================================
+    // Reader
+
+    bool Reader::readRequest(Message& out, std::chrono::milliseconds timeout) {
+        MessageHead head;
+        std::string_view method, path;
+        if (!readMessage(head, true, &method, &path, timeout)) {
+            return false;
+        }
+        out = Message();
+        out.method.assign(method);
+        out.path.assign(path);
+        out.keepAlive = head.keepAlive;
+        out.body.assign(m_buffer, head.bodyOffset, head.bodyLength);
+        m_buffer.erase(0, head.size);
+        return true;
+    }
+
+    bool Reader::readResponse(MessageHead& out, std::chrono::milliseconds timeout) {
+        return readMessage(out, false, nullptr, nullptr, timeout);
+    }
+
+    bool Reader::fill(std::chrono::steady_clock::time_point deadline) {
+        for (;;) {
+            pollfd pfd = { m_fd, POLLIN, 0 };
+            int rc = ::poll(&pfd, 1, remainingMs(deadline));
+            if (rc < 0 && errno == EINTR) {
+                continue;
+            }
+            if (rc != 1) {
+                return false;
+            }
+
+            const size_t used = m_buffer.size();
+            m_buffer.resize(used + READ_CHUNK);
+            ssize_t n = ::recv(m_fd, &m_buffer[used], READ_CHUNK, 0);
+            m_buffer.resize(used + (n > 0 ? static_cast<size_t>(n) : 0));
+            if (n > 0) {
+                return true;
+            }
+            if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+                continue;
+            }
+            m_closed = true;
+            return false;
+        }
+    }
+
+    bool Reader::reject() {
+        // The buffer is left as is, so HttpClient does not take this for a stale keep-alive socket
+        m_closed = true;
+        return false;
+    }
+
+    bool Reader::readMessage(MessageHead& out, bool isRequest, std::string_view* method, std::string_view* path,
+                             std::chrono::milliseconds timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        size_t headerEnd;
+        while ((headerEnd = m_buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (m_buffer.size() > MAX_HEADER_BYTES) {
+                return reject();
+            }
+            if (!fill(deadline)) {
+                return false;
+            }
+        }
+
+        // Everything is kept as offsets, reading the body may move the buffer
+        std::string_view head(m_buffer.data(), headerEnd);
+        size_t lineEnd = head.find("\r\n");
+        std::string_view startLine = head.substr(0, lineEnd);
+
+        out = MessageHead();
+        size_t methodLength = 0, pathOffset = 0, pathLength = 0;
+        if (isRequest) {
+            // METHOD SP PATH SP VERSION
+            size_t sp1 = startLine.find(' ');
+            size_t sp2 = startLine.find(' ', sp1 + 1);
+            if (sp1 == std::string_view::npos || sp2 == std::string_view::npos) {
+                return false;
+            }
+            methodLength = sp1;
+            pathOffset = sp1 + 1;
+            pathLength = sp2 - sp1 - 1;
+        } else {
+            // VERSION SP STATUS SP REASON
+            size_t sp1 = startLine.find(' ');
+            if (sp1 == std::string_view::npos || startLine.size() < sp1 + 4) {
+                return false;
+            }
+            int status = 0;
+            for (char c : startLine.substr(sp1 + 1, 3)) {
+                if (c < '0' || c > '9') {
+                    return false;
+                }
+                status = status * 10 + (c - '0');
+            }
+            out.status = status;
+        }
+
+        size_t contentLength = 0;
+        bool hasContentLength = false;
+        while (lineEnd != std::string_view::npos) {
+            head.remove_prefix(lineEnd + 2);
+            lineEnd = head.find("\r\n");
+            std::string_view line = head.substr(0, lineEnd);
+            size_t colon = line.find(':');
+            if (colon == std::string_view::npos) {
+                continue;
+            }
+
+            std::string_view name = trim(line.substr(0, colon));
+            std::string_view value = trim(line.substr(colon + 1));
+            if (equalsIgnoreCase(name, "Content-Length")) {
+                // from_chars rejects signs, empty values and overflow
+                const char* end = value.data() + value.size();
+                auto [ptr, ec] = std::from_chars(value.data(), end, contentLength);
+                if (ec != std::errc() || ptr != end || contentLength > MAX_BODY_BYTES) {
+                    return reject();
+                }
+                hasContentLength = true;
+            } else if (equalsIgnoreCase(name, "Connection")) {
+                out.keepAlive = !equalsIgnoreCase(value, "close");
+            } else if (equalsIgnoreCase(name, "Date")) {
+                out.dateOffset = static_cast<size_t>(value.data() - m_buffer.data());
+                out.dateLength = value.size();
+            }
+        }
+
+        size_t bodyStart = headerEnd + 4;
+        if (!hasContentLength && !isRequest) {
+            // Body runs until the server closes the connection
+            while (fill(deadline)) {
+                if (m_buffer.size() - bodyStart > MAX_BODY_BYTES) {
+                    return reject();
+                }
+            }
+            if (!m_closed) {
+                return false;
+            }
+            contentLength = m_buffer.size() - bodyStart;
+            out.keepAlive = false;
+        }
+
+        while (m_buffer.size() < bodyStart + contentLength) {
+            if (!fill(deadline)) {
+                return false;
+            }
+        }
+
+        out.bodyOffset = bodyStart;
+        out.bodyLength = contentLength;
+        out.size = bodyStart + contentLength;
+        if (isRequest) {
+            *method = std::string_view(m_buffer.data(), methodLength);
+            *path = std::string_view(m_buffer.data() + pathOffset, pathLength);
+        }
+        return true;
+    }
+
+    std::string buildRequest(std::string_view method, std::string_view host, std::string_view path,
+                             std::string_view body, bool keepAlive) {
+        std::string request;
+        request.reserve(128 + body.size());
+        request.append(method).append(" ").append(path).append(" HTTP/1.1\r\n");
+        request.append("Host: ").append(host).append("\r\n");
+        request.append("Connection: ").append(keepAlive ? "keep-alive" : "close").append("\r\n");
+        if (!body.empty()) {
+            request.append("Content-Type: application/json\r\n");
+        }
+        request.append("Content-Length: ").append(std::to_string(body.size())).append("\r\n\r\n");
+        request.append(body);
+        return request;
+    }
+
+    std::string buildResponse(int status, std::string_view body, bool keepAlive) {
+        auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+
+        std::string response;
+        response.reserve(160 + body.size());
+        response.append("HTTP/1.1 ").append(std::to_string(status)).append(" ").append(statusText(status)).append("\r\n");
+        response.append("Date: ").append(formatHttpDate(now)).append("\r\n");
+        response.append("Connection: ").append(keepAlive ? "keep-alive" : "close").append("\r\n");
+        response.append("Content-Type: application/json\r\n");
+        response.append("Content-Length: ").append(std::to_string(body.size())).append("\r\n\r\n");
+        response.append(body);
+        return response;
+    }
+
+    std::string formatHttpDate(int64_t epochMs) {
+        time_t seconds = static_cast<time_t>(epochMs / 1000);
+        tm utc;
+        gmtime_r(&seconds, &utc);
+
+        char buffer[64];
+        size_t n = strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &utc);
+        return std::string(buffer, n);
+    }
+
+    bool parseHttpDate(std::string_view date, int64_t& epochMs) {
+        // "Sun, 06 Nov 1994 08:49:37 GMT"
+        static const char* MONTHS = "JanFebMarAprMayJunJulAugSepOctNovDec";
+        if (date.size() != 29 || date.substr(25) != " GMT" || date[3] != ',') {
+            return false;
+        }
+
+        auto number = [&date](size_t pos, size_t len, int& out) {
+            out = 0;
+            for (size_t i = pos; i < pos + len; ++i) {
+                if (date[i] < '0' || date[i] > '9') return false;
+                out = out * 10 + (date[i] - '0');
+            }
+            return true;
+        };
+
+        int day, year, hour, minute, second;
+        if (!number(5, 2, day) || !number(12, 4, year) || !number(17, 2, hour)
+            || !number(20, 2, minute) || !number(23, 2, second)) {
+            return false;
+        }
+        const char* month = std::strstr(MONTHS, std::string(date.substr(8, 3)).c_str());
+        if (!month || (month - MONTHS) % 3 != 0) {
+            return false;
+        }
+
+        // Days from civil date (proleptic Gregorian), avoids the non-portable timegm
+        int m = static_cast<int>((month - MONTHS) / 3) + 1;
+        int y = year - (m <= 2 ? 1 : 0);
+        int era = (y >= 0 ? y : y - 399) / 400;
+        int yoe = y - era * 400;
+        int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        int64_t days = static_cast<int64_t>(era) * 146097 + doe - 719468;
+
+        epochMs = ((days * 24 + hour) * 60 + minute) * 60000LL + second * 1000LL;
+        return true;
+    }
+}
+}
+
+#endif
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Tech3CPlatform.h"
+
+#if TECH3C_DESKTOP_BACKEND
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_LINUX
+#define TECH3C_HTTP_EPOLL 1
+#else
+#define TECH3C_HTTP_EPOLL 0
+#include <poll.h>
+#endif
+
+// Small HTTP/1.1 plumbing shared by the desktop auth client and the stand-in auth server
+namespace tech3c {
+namespace http {
+
+    // A request as the stand-in server handles it, copied out of the Reader
+    struct Message {
+        std::string method;
+        std::string path;
+        std::string body;
+        bool keepAlive = true;
+    };
+
+    // Where the parts of a message sit in the Reader's buffer, see Reader::readResponse
+    struct MessageHead {
+        int status = 0;             // Responses only
+        bool keepAlive = true;
+        size_t size = 0;            // Whole message: start line, headers and body
+        size_t bodyOffset = 0;
+        size_t bodyLength = 0;
+        size_t dateOffset = 0;
+        size_t dateLength = 0;
+    };
+
+    // Parses "http://host[:port]" into host and port
+    bool parseUrl(std::string_view url, std::string& host, uint16_t& port);
+
+    // Returns a connected non-blocking socket, or -1
+    int connectTcp(const std::string& host, uint16_t port, std::chrono::milliseconds timeout);
+    // Opens up to count connections at once, all handshakes in flight together; appends the
+    // connected non-blocking sockets to out and returns how many it added
+    size_t connectTcpMany(const std::string& host, uint16_t port, size_t count, std::chrono::milliseconds timeout,
+                          std::vector<int>& out);
+    // Starts a non-blocking connect to the first address of host and returns the socket, or -1 when
+    // it failed right away; once a Poller reports it writable, finishConnect() tells how it went
+    int beginConnect(const std::string& host, uint16_t port);
+    bool finishConnect(int fd);
+    // Returns a listening socket bound to host (port 0 picks a free one), or -1
+    int listenTcp(const std::string& host, uint16_t& port);
+    // Accepts a pending connection on a listening socket, or returns -1
+    int acceptTcp(int listenFd);
+    void closeSocket(int fd);
+
+    // sent, when given, receives the bytes written even on failure
+    bool sendAll(int fd, std::string_view data, std::chrono::milliseconds timeout, size_t* sent = nullptr);
+
+    // Waits on many sockets at once: epoll on Linux, poll() elsewhere. One thread at a time.
+    class Poller {
+    public:
+        Poller();
+        ~Poller();
+
+        // Reports fd once connected (writable) or, otherwise, once readable or hung up
+        bool add(int fd, bool writable);
+        void remove(int fd);
+        bool empty() const { return m_count == 0; }
+
+        // Replaces ready with the sockets that have an event, waiting up to timeout for one
+        void wait(std::chrono::milliseconds timeout, std::vector<int>& ready);
+
+    private:
+        Poller(const Poller&) = delete;
+        Poller& operator=(const Poller&) = delete;
+
+        size_t m_count;
+#if TECH3C_HTTP_EPOLL
+        int m_epollFd;
+#else
+        std::vector<pollfd> m_fds;
+#endif
+    };
+
+    // Reads HTTP messages from one connection, keeping bytes of pipelined follow-up messages.
+    // recv() writes straight into the buffer, nothing is copied on the way in.
+    class Reader {
+    public:
+        explicit Reader(int fd) : m_fd(fd), m_closed(false) {}
+
+        bool readRequest(Message& out, std::chrono::milliseconds timeout);
+        // Leaves the response in place at the front of getBuffer(), described by out; the caller
+        // takes it from there (or erases out.size bytes) before reading the next one. A zero
+        // timeout only takes what has arrived: false while !isClosed() means the rest is on its way,
+        // and the next call picks up from the bytes kept so far.
+        bool readResponse(MessageHead& out, std::chrono::milliseconds timeout);
+
+        std::string& getBuffer() { return m_buffer; }
+        // The peer closed the connection or it failed, rather than timing out
+        bool isClosed() const { return m_closed; }
+
+    private:
+        // Parses the message at the front of the buffer; method and path only for requests
+        bool readMessage(MessageHead& out, bool isRequest, std::string_view* method, std::string_view* path,
+                         std::chrono::milliseconds timeout);
+        bool fill(std::chrono::steady_clock::time_point deadline);
+        // Gives up on a message that is oversized or malformed, the connection cannot be reused
+        bool reject();
+
+        static constexpr size_t READ_CHUNK = 4096;
+        // Auth messages are a few KB, anything near these limits is a broken or hostile peer
+        static constexpr size_t MAX_HEADER_BYTES = 16 * 1024;
+        static constexpr size_t MAX_BODY_BYTES = 1024 * 1024;
+
+        int m_fd;
+        bool m_closed;
+        std::string m_buffer;
+    };
+
+    std::string buildRequest(std::string_view method, std::string_view host, std::string_view path,
+                             std::string_view body, bool keepAlive);
+    std::string buildResponse(int status, std::string_view body, bool keepAlive);
+
+    // RFC 7231 IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT"
+    std::string formatHttpDate(int64_t epochMs);
+    // Parses an IMF-fixdate into epoch milliseconds, returns false for other formats
+    bool parseHttpDate(std::string_view date, int64_t& epochMs);
+}
+}
+
+#endif
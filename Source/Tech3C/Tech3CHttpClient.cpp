@@ -0,0 +1,207 @@
+#include "Tech3CHttpClient.h"
+
+#if TECH3C_DESKTOP_BACKEND
+
+#include <algorithm>
+
+using namespace tech3c;
+
+HttpClient::HttpClient()
+        : m_port(0)
+        , m_timeout(10000)
+        , m_breaker(nullptr)
+        , m_connectCount(0)
+        , m_maxIdle(DEFAULT_MAX_IDLE)
+        , m_idleTimeout(DEFAULT_IDLE_TIMEOUT_MS) {
+}
+
+HttpClient::~HttpClient() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const ConnectionPtr& connection : m_idle) {
+        m_idlePoller.remove(connection->fd);
+    }
+    m_idle.clear();
+}
+
+bool HttpClient::setBaseUrl(const std::string& url) {
+    if (!http::parseUrl(url, m_host, m_port)) {
+        return false;
+    }
+    m_baseUrl = url;
+
+    // Pooled connections lead to the old server
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const ConnectionPtr& connection : m_idle) {
+        m_idlePoller.remove(connection->fd);
+    }
+    m_idle.clear();
+    return true;
+}
+
+void HttpClient::setMaxIdleConnections(size_t count) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxIdle = count;
+    while (m_idle.size() > m_maxIdle) {
+        m_idlePoller.remove(m_idle.front()->fd);
+        m_idle.erase(m_idle.begin());
+    }
+}
+
+void HttpClient::setIdleTimeout(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_idleTimeout = timeout;
+}
+
+size_t HttpClient::preconnect(size_t count) {
+    size_t missing;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        dropClosedLocked();
+        count = std::min(count, m_maxIdle);
+        missing = count > m_idle.size() ? count - m_idle.size() : 0;
+    }
+
+    std::vector<int> fds;
+    if (missing > 0) {
+        http::connectTcpMany(m_host, m_port, missing, m_timeout, fds);
+        m_connectCount.fetch_add(fds.size(), std::memory_order_relaxed);
+    }
+    for (int fd : fds) {
+        release(ConnectionPtr(new Connection(fd)));
+    }
+    return getIdleConnectionCount();
+}
+
+size_t HttpClient::getIdleConnectionCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_idle.size();
+}
+
+HttpResponse HttpClient::get(std::string_view path) {
+    return request("GET", path, std::string_view());
+}
+
+HttpResponse HttpClient::post(std::string_view path, std::string_view jsonBody) {
+    return request("POST", path, jsonBody);
+}
+
+HttpResponse HttpClient::request(std::string_view method, std::string_view path, std::string_view body) {
+    if (m_breaker && !m_breaker->allowRequest()) {
+        HttpResponse rejected;
+        rejected.rejected = true;
+        rejected.error = "Auth service unavailable, retry in "
+                + std::to_string(m_breaker->getRetryAfter().count()) + " ms";
+        return rejected;
+    }
+
+    HttpResponse response = send(method, path, body);
+    if (m_breaker) {
+        if (response.isTransientFailure()) {
+            m_breaker->recordFailure();
+        } else {
+            m_breaker->recordSuccess();
+        }
+    }
+    return response;
+}
+
+HttpResponse HttpClient::send(std::string_view method, std::string_view path, std::string_view body) {
+    HttpResponse response;
+    const std::string message = http::buildRequest(method, m_host, path, body, true);
+
+    // A pooled connection the server closed just as the request went out goes stale without a
+    // byte of the answer. Whether the server acted on the request is unknown once any of it was
+    // written: only idempotent requests go out again on a new connection, the others (a login
+    // replayed could register twice, a refresh spend a rotated token twice) leave it to the caller
+    const bool idempotent = method == "GET" || method == "HEAD";
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        ConnectionPtr connection = attempt == 0 ? takeIdle() : nullptr;
+        const bool reused = connection != nullptr;
+        if (!connection) {
+            int fd = http::connectTcp(m_host, m_port, m_timeout);
+            if (fd < 0) {
+                response.error = "Failed to connect to " + m_baseUrl;
+                return response;
+            }
+            m_connectCount.fetch_add(1, std::memory_order_relaxed);
+            connection.reset(new Connection(fd));
+        }
+
+        size_t sent = 0;
+        if (!http::sendAll(connection->fd, message, m_timeout, &sent)) {
+            if (reused && (idempotent || sent == 0)) {
+                continue;
+            }
+            response.error = "Failed to send request to " + m_baseUrl;
+            return response;
+        }
+
+        http::Reader& reader = connection->reader;
+        if (!reader.readResponse(response.m_head, m_timeout)) {
+            if (reused && idempotent && reader.isClosed() && reader.getBuffer().empty()) {
+                continue;
+            }
+            response.error = "No response from " + m_baseUrl;
+            return response;
+        }
+
+        // The response takes over the receive buffer, the body is never copied. Anything past the
+        // message means the connection is out of step with the server, so it is not reused.
+        response.status = response.m_head.status;
+        const bool inStep = reader.getBuffer().size() == response.m_head.size;
+        response.m_message.swap(reader.getBuffer());
+        if (inStep && response.m_head.keepAlive) {
+            release(std::move(connection));
+        }
+        return response;
+    }
+
+    response.error = "Connection to " + m_baseUrl + " closed";
+    return response;
+}
+
+HttpClient::ConnectionPtr HttpClient::takeIdle() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    dropClosedLocked();
+
+    const auto now = std::chrono::steady_clock::now();
+    while (!m_idle.empty()) {
+        ConnectionPtr connection = std::move(m_idle.back());
+        m_idle.pop_back();
+        m_idlePoller.remove(connection->fd);
+        if (now - connection->idleSince < m_idleTimeout) {
+            return connection;
+        }
+    }
+    return nullptr;
+}
+
+void HttpClient::release(ConnectionPtr connection) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_idle.size() >= m_maxIdle || !m_idlePoller.add(connection->fd, false)) {
+        return;
+    }
+    connection->idleSince = std::chrono::steady_clock::now();
+    m_idle.push_back(std::move(connection));
+}
+
+void HttpClient::dropClosedLocked() {
+    if (m_idle.empty()) {
+        return;
+    }
+
+    // One call covers the whole pool: an idle connection only gets an event when the server
+    // closed it (or sent something unasked), either way it is of no use anymore
+    m_idlePoller.wait(std::chrono::milliseconds(0), m_ready);
+    for (int fd : m_ready) {
+        m_idlePoller.remove(fd);
+        for (auto it = m_idle.begin(); it != m_idle.end(); ++it) {
+            if ((*it)->fd == fd) {
+                m_idle.erase(it);
+                break;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Tech3CPlatform.h"
+
+#if TECH3C_DESKTOP_BACKEND
+
+#include "Tech3CHttp.h"
+#include "Tech3CRetry.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tech3c {
+
+    class HttpResponse {
+    public:
+        int status = 0;         // 0 when the request never got an answer
+        std::string error;      // Transport error description
+        bool rejected = false;  // Failed fast without a request, the circuit breaker is open
+
+        bool ok() const { return status >= 200 && status < 300; }
+        // No answer or a server error, worth another try; what circuit breakers count as failures.
+        // 503 is the auth service's maintenance answer, a deliberate one.
+        bool isTransientFailure() const { return !rejected && (status == 0 || (status >= 500 && status != 503)); }
+
+        // Views into the message as received, which the response owns; JSON fields looked up in
+        // the body are copied once, into their destination (e.g. UserInfo)
+        std::string_view getBody() const { return std::string_view(m_message).substr(m_head.bodyOffset, m_head.bodyLength); }
+        std::string_view getDate() const { return std::string_view(m_message).substr(m_head.dateOffset, m_head.dateLength); }
+
+    private:
+        friend class HttpClient;
+
+        std::string m_message;
+        http::MessageHead m_head;
+    };
+
+    // Blocking HTTP/1.1 JSON client for the desktop auth backend, shared by every thread of a
+    // SessionHost. Keeps idle keep-alive connections: a request takes the most recently used one
+    // (or connects when none is left) and hands it back once the response is read, so a warm
+    // request is one round trip with no handshake.
+    class HttpClient {
+    public:
+        HttpClient();
+        ~HttpClient();
+
+        // Base URL of the auth service, "http://host[:port]"; set before the first request
+        bool setBaseUrl(const std::string& url);
+        const std::string& getBaseUrl() const { return m_baseUrl; }
+        void setTimeout(std::chrono::milliseconds timeout) { m_timeout = timeout; }
+        // Requests fail fast while it is open, transient failures count against it. Set before the
+        // first request.
+        void setCircuitBreaker(CircuitBreaker* breaker) { m_breaker = breaker; }
+        CircuitBreaker* getCircuitBreaker() const { return m_breaker; }
+
+        // Idle connections kept for reuse, 0 closes each one after its request
+        void setMaxIdleConnections(size_t count);
+        // Idle connections older than this are closed instead of reused, ahead of the server's own
+        // keep-alive timeout
+        void setIdleTimeout(std::chrono::milliseconds timeout);
+        // Connects in parallel until count connections (at most the idle limit) wait in the pool,
+        // so the first requests skip the handshake; returns the idle count
+        size_t preconnect(size_t count);
+
+        size_t getIdleConnectionCount() const;
+        // TCP connections opened so far, requests on pooled ones do not count
+        uint64_t getConnectCount() const { return m_connectCount.load(std::memory_order_relaxed); }
+
+        HttpResponse get(std::string_view path);
+        HttpResponse post(std::string_view path, std::string_view jsonBody);
+        // Any method, behind the circuit breaker like get() and post()
+        HttpResponse request(std::string_view method, std::string_view path, std::string_view body);
+
+    private:
+        HttpClient(const HttpClient&) = delete;
+        HttpClient& operator=(const HttpClient&) = delete;
+
+        struct Connection {
+            explicit Connection(int socket) : fd(socket), reader(socket) {}
+            ~Connection() { http::closeSocket(fd); }
+
+            int fd;
+            http::Reader reader;
+            std::chrono::steady_clock::time_point idleSince;
+        };
+        using ConnectionPtr = std::unique_ptr<Connection>;
+
+        HttpResponse send(std::string_view method, std::string_view path, std::string_view body);
+
+        // The most recently used idle connection still open, or null
+        ConnectionPtr takeIdle();
+        // Pools the connection if there is room, otherwise closes it
+        void release(ConnectionPtr connection);
+        // Closes the idle connections the server has closed or written to, caller holds m_mutex
+        void dropClosedLocked();
+
+        static constexpr size_t DEFAULT_MAX_IDLE = 8;
+        static constexpr int64_t DEFAULT_IDLE_TIMEOUT_MS = 20000;
+
+        std::string m_baseUrl;
+        std::string m_host;
+        uint16_t m_port;
+        std::chrono::milliseconds m_timeout;
+        CircuitBreaker* m_breaker;
+        std::atomic<uint64_t> m_connectCount;
+
+        // Guarded by m_mutex
+        mutable std::mutex m_mutex;
+        std::vector<ConnectionPtr> m_idle;      // Most recently used last
+        http::Poller m_idlePoller;              // Watches m_idle for the server closing them
+        std::vector<int> m_ready;
+        size_t m_maxIdle;
+        std::chrono::milliseconds m_idleTimeout;
+    };
+}
+
+#endif
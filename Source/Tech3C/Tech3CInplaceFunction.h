@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace tech3c {
+
+    template <typename Signature, size_t Capacity>
+    class InplaceFunction;
+
+    // Copyable callable wrapper like std::function, but the callable always lives in an inline
+    // buffer of Capacity bytes: constructing, copying, moving and calling never allocate. A
+    // callable that does not fit is a compile error, not a heap fallback; capture a pointer to
+    // bigger state instead.
+    template <typename R, typename... Args, size_t Capacity>
+    class InplaceFunction<R(Args...), Capacity> {
+    public:
+        static constexpr size_t capacity() { return Capacity; }
+
+        InplaceFunction() noexcept : m_ops(nullptr) {}
+        InplaceFunction(std::nullptr_t) noexcept : m_ops(nullptr) {}
+
+        template <typename F, typename Callable = std::decay_t<F>,
+                  typename = std::enable_if_t<!std::is_same_v<Callable, InplaceFunction> &&
+                                              std::is_invocable_r_v<R, Callable&, Args...>>>
+        InplaceFunction(F&& callable) : m_ops(nullptr) {
+            static_assert(sizeof(Callable) <= Capacity,
+                          "callable does not fit the inline buffer, capture less or by pointer");
+            static_assert(alignof(Callable) <= alignof(std::max_align_t),
+                          "callable is over-aligned for the inline buffer");
+            static_assert(std::is_copy_constructible_v<Callable>, "callable must be copyable");
+            static_assert(std::is_nothrow_move_constructible_v<Callable>, "callable must be nothrow movable");
+
+            ::new (static_cast<void*>(m_storage)) Callable(std::forward<F>(callable));
+            m_ops = &OPS<Callable>;
+        }
+
+        InplaceFunction(const InplaceFunction& other) : m_ops(nullptr) {
+            if (other.m_ops) {
+                other.m_ops->copy(m_storage, other.m_storage);
+                m_ops = other.m_ops;
+            }
+        }
+
+        InplaceFunction(InplaceFunction&& other) noexcept : m_ops(nullptr) {
+            if (other.m_ops) {
+                other.m_ops->move(m_storage, other.m_storage);
+                m_ops = other.m_ops;
+                other.reset();
+            }
+        }
+
+        ~InplaceFunction() { reset(); }
+
+        InplaceFunction& operator=(const InplaceFunction& other) {
+            if (this != &other) {
+                InplaceFunction copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+            if (this != &other) {
+                reset();
+                if (other.m_ops) {
+                    other.m_ops->move(m_storage, other.m_storage);
+                    m_ops = other.m_ops;
+                    other.reset();
+                }
+            }
+            return *this;
+        }
+
+        InplaceFunction& operator=(std::nullptr_t) noexcept {
+            reset();
+            return *this;
+        }
+
+        explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+        // Like std::function, calling an empty wrapper is a programming error; check operator bool
+        R operator()(Args... args) const {
+            return m_ops->invoke(m_storage, std::forward<Args>(args)...);
+        }
+
+    private:
+        struct Ops {
+            R (*invoke)(void* storage, Args&&... args);
+            void (*copy)(void* to, const void* from);
+            void (*move)(void* to, void* from);     // Leaves from moved-from but alive
+            void (*destroy)(void* storage);
+        };
+
+        template <typename Callable>
+        static constexpr Ops OPS = {
+            [](void* storage, Args&&... args) -> R {
+                return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+            },
+            [](void* to, const void* from) { ::new (to) Callable(*static_cast<const Callable*>(from)); },
+            [](void* to, void* from) { ::new (to) Callable(std::move(*static_cast<Callable*>(from))); },
+            [](void* storage) { static_cast<Callable*>(storage)->~Callable(); },
+        };
+
+        void reset() noexcept {
+            if (m_ops) {
+                m_ops->destroy(m_storage);
+                m_ops = nullptr;
+            }
+        }
+
+        // Mutable like std::function's target, so a const wrapper can call a mutable lambda
+        alignas(std::max_align_t) mutable unsigned char m_storage[Capacity];
+        const Ops* m_ops;
+    };
+}
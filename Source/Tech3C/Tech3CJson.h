@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+// Minimal helpers for the flat JSON objects exchanged with the auth service.
+// Lookups return views into the source text, string values are not unescaped.
+namespace tech3c {
+namespace json {
+
+    // Position just after `"key":` (whitespace skipped), or npos
+    inline size_t findValue(std::string_view json, std::string_view key) {
+        size_t pos = 0;
+        while ((pos = json.find(key, pos)) != std::string_view::npos) {
+            size_t end = pos + key.size();
+            if (pos > 0 && json[pos - 1] == '"' && end < json.size() && json[end] == '"') {
+                size_t p = end + 1;
+                while (p < json.size() && (json[p] == ' ' || json[p] == '\t' || json[p] == '\n' || json[p] == '\r')) ++p;
+                if (p < json.size() && json[p] == ':') {
+                    ++p;
+                    while (p < json.size() && (json[p] == ' ' || json[p] == '\t' || json[p] == '\n' || json[p] == '\r')) ++p;
+                    return p;
+                }
+            }
+            pos = end;
+        }
+        return std::string_view::npos;
+    }
+
+    inline bool getString(std::string_view json, std::string_view key, std::string_view& out) {
+        size_t p = findValue(json, key);
+        if (p == std::string_view::npos || p >= json.size() || json[p] != '"') {
+            return false;
+        }
+        size_t end = p + 1;
+        while (end < json.size() && json[end] != '"') {
+            end += (json[end] == '\\') ? 2 : 1;
+        }
+        if (end >= json.size()) {
+            return false;
+        }
+        out = json.substr(p + 1, end - p - 1);
+        return true;
+    }
+
+    inline bool getInt64(std::string_view json, std::string_view key, int64_t& out) {
+        size_t p = findValue(json, key);
+        if (p == std::string_view::npos || p >= json.size()) {
+            return false;
+        }
+        bool negative = json[p] == '-';
+        if (negative) ++p;
+        if (p >= json.size() || json[p] < '0' || json[p] > '9') {
+            return false;
+        }
+        int64_t value = 0;
+        while (p < json.size() && json[p] >= '0' && json[p] <= '9') {
+            value = value * 10 + (json[p] - '0');
+            ++p;
+        }
+        out = negative ? -value : value;
+        return true;
+    }
+
+    inline bool getBool(std::string_view json, std::string_view key, bool& out) {
+        size_t p = findValue(json, key);
+        if (p == std::string_view::npos) {
+            return false;
+        }
+        if (json.substr(p, 4) == "true") { out = true; return true; }
+        if (json.substr(p, 5) == "false") { out = false; return true; }
+        return false;
+    }
+
+    // Appends value as a quoted, escaped JSON string
+    inline void appendString(std::string& out, std::string_view value) {
+        out += '"';
+        for (char c : value) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        static const char* HEX = "0123456789abcdef";
+                        out += "\\u00";
+                        out += HEX[(c >> 4) & 0xf];
+                        out += HEX[c & 0xf];
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        out += '"';
+    }
+
+    // Appends `"key":"value"` with a leading comma unless it is the first field
+    inline void appendField(std::string& out, std::string_view key, std::string_view value) {
+        if (out.size() > 1) out += ',';
+        appendString(out, key);
+        out += ':';
+        appendString(out, value);
+    }
+
+    inline void appendInt(std::string& out, std::string_view key, int64_t value) {
+        if (out.size() > 1) out += ',';
+        appendString(out, key);
+        out += ':';
+        out += std::to_string(value);
+    }
+
+    inline void appendBool(std::string& out, std::string_view key, bool value) {
+        if (out.size() > 1) out += ',';
+        appendString(out, key);
+        out += value ? ":true" : ":false";
+    }
+
+    inline void appendDouble(std::string& out, std::string_view key, double value, int precision = 3) {
+        if (out.size() > 1) out += ',';
+        appendString(out, key);
+        char buffer[48];
+        std::snprintf(buffer, sizeof(buffer), ":%.*f", precision, value);
+        out += buffer;
+    }
+
+    // Appends `"key":` followed by an already serialized object or array
+    inline void appendRaw(std::string& out, std::string_view key, std::string_view rawJson) {
+        if (out.size() > 1) out += ',';
+        appendString(out, key);
+        out += ':';
+        out += rawJson;
+    }
+}
+}
@@ -0,0 +1,13 @@
+#include "Tech3CLog.h"
+#include "Tech3CLogSink.h"
+
+namespace tech3c {
+    namespace detail {
+        std::atomic<int> g_minLogLevel(static_cast<int>(LogLevel::Warn));
+
+        void writeLog(LogLevel level, const char* message, size_t length) {
+            // Queued for the writer thread, the calling (callback or frame) thread never does I/O
+            LogSink::getInstance().push(level, message, length);
+        }
+    }
+}
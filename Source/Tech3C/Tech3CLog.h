@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include "fmt/format.h"
+
+// 0 compiles TECH3C_LOGD / TECH3C_LOGI out of the binary, see TECH3C_STRIP_DEBUG_LOG in CMakeLists.txt
+#ifndef TECH3C_LOG_DEBUG
+#define TECH3C_LOG_DEBUG 1
+#endif
+
+namespace tech3c {
+
+    // Same order as ax::LogLevel
+    enum class LogLevel {
+        Debug,
+        Info,
+        Warn,
+        Error,
+        Silent
+    };
+
+    namespace detail {
+        extern std::atomic<int> g_minLogLevel;
+
+        // Queues a formatted message for LogSink, which writes it to the platform log and the log file
+        void writeLog(LogLevel level, const char* message, size_t length);
+
+        template <typename... Args>
+        void formatLog(LogLevel level, fmt::format_string<Args...> format, Args&&... args) {
+            // Inline storage, a typical message never touches the heap
+            fmt::memory_buffer buffer;
+            fmt::format_to(std::back_inserter(buffer), format, std::forward<Args>(args)...);
+            writeLog(level, buffer.data(), buffer.size());
+        }
+    }
+
+    // Messages below this level are dropped before their arguments are even evaluated.
+    // One level for the whole process: Tech3CManager sets Debug or Warn from its
+    // Config::debugMode, other sessions never change it, so bots and harnesses call this.
+    inline void setLogLevel(LogLevel level) {
+        detail::g_minLogLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+
+    inline LogLevel getLogLevel() {
+        return static_cast<LogLevel>(detail::g_minLogLevel.load(std::memory_order_relaxed));
+    }
+
+    inline bool isLogEnabled(LogLevel level) {
+        return static_cast<int>(level) >= detail::g_minLogLevel.load(std::memory_order_relaxed);
+    }
+}
+
+// TECH3C_LOGD("Login success for user: {}", userId);
+// The format string is checked at compile time; arguments are only evaluated and formatted
+// when the level is enabled.
+#define TECH3C_LOG(level, ...)                                      \
+    do {                                                            \
+        if (::tech3c::isLogEnabled(level)) {                        \
+            ::tech3c::detail::formatLog(level, __VA_ARGS__);        \
+        }                                                           \
+    } while (0)
+
+#if TECH3C_LOG_DEBUG
+#define TECH3C_LOGD(...) TECH3C_LOG(::tech3c::LogLevel::Debug, __VA_ARGS__)
+#define TECH3C_LOGI(...) TECH3C_LOG(::tech3c::LogLevel::Info, __VA_ARGS__)
+#else
+// Still type checked, but no code or strings end up in the binary
+#define TECH3C_LOGD(...)                                                                    \
+    do {                                                                                    \
+        if constexpr (false) {                                                              \
+            ::tech3c::detail::formatLog(::tech3c::LogLevel::Debug, __VA_ARGS__);            \
+        }                                                                                   \
+    } while (0)
+#define TECH3C_LOGI(...)                                                                    \
+    do {                                                                                    \
+        if constexpr (false) {                                                              \
+            ::tech3c::detail::formatLog(::tech3c::LogLevel::Info, __VA_ARGS__);             \
+        }                                                                                   \
+    } while (0)
+#endif
+
+#define TECH3C_LOGW(...) TECH3C_LOG(::tech3c::LogLevel::Warn, __VA_ARGS__)
+#define TECH3C_LOGE(...) TECH3C_LOG(::tech3c::LogLevel::Error, __VA_ARGS__)
@@ -0,0 +1,345 @@
+#include "Tech3CLogSink.h"
+#include "Tech3CTrace.h"
+#include "axmol.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID
+#include <android/log.h>
+#endif
+
+USING_NS_AX;
+using namespace tech3c;
+
+namespace {
+
+    const char* LOG_FILE_NAME = "tech3c.log";
+    const size_t DEFAULT_MAX_FILE_BYTES = 1024 * 1024;
+    const int DEFAULT_MAX_FILES = 3;
+
+    // Upper bound on how long a debug record waits; warnings and errors wake the writer at once
+    const auto WRITER_POLL_INTERVAL = std::chrono::milliseconds(200);
+
+    const char LEVEL_CHARS[] = {'D', 'I', 'W', 'E'};
+
+    std::atomic<uint32_t> s_nextThreadId(1);
+
+    uint32_t currentThreadId() {
+        thread_local uint32_t id = s_nextThreadId.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    std::tm toLocalTime(int64_t timeMs) {
+        std::time_t seconds = static_cast<std::time_t>(timeMs / 1000);
+        std::tm local{};
+#if AX_TARGET_PLATFORM == AX_PLATFORM_WIN32 || AX_TARGET_PLATFORM == AX_PLATFORM_WINRT
+        localtime_s(&local, &seconds);
+#else
+        localtime_r(&seconds, &local);
+#endif
+        return local;
+    }
+}
+
+//========================================================================
+// LogSink
+
+LogSink& LogSink::getInstance() {
+    // Never destroyed, logging from other static destructors stays safe; the writer is stopped at exit
+    static LogSink* sink = [] {
+        LogSink* instance = new LogSink();
+        std::atexit([] { LogSink::getInstance().stop(); });
+        return instance;
+    }();
+    return *sink;
+}
+
+LogSink::LogSink()
+        : m_ring(RING_CAPACITY)
+        , m_dropped(0)
+        , m_written(0)
+        , m_state(IDLE)
+        , m_writerSleeping(false)
+        , m_flushRequests(0)
+        , m_flushesDone(0)
+        , m_maxFileBytes(DEFAULT_MAX_FILE_BYTES)
+        , m_maxFiles(DEFAULT_MAX_FILES)
+        , m_platformOutput(true)
+        , m_fileSettingsChanged(false)
+        , m_file(nullptr)
+        , m_fileBytes(0)
+        , m_activeMaxFileBytes(DEFAULT_MAX_FILE_BYTES)
+        , m_activeMaxFiles(DEFAULT_MAX_FILES)
+        , m_activePlatformOutput(true)
+        , m_reportedDrops(0) {
+}
+
+LogSink::~LogSink() {
+    stop();
+}
+
+bool LogSink::push(LogLevel level, const char* message, size_t length) {
+    int state = m_state.load(std::memory_order_acquire);
+    if (state != RUNNING) {
+        if (state == STOPPED) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        start();
+    }
+
+    LogRecord record;
+    record.timeMs = nowMs();
+    record.threadId = currentThreadId();
+    record.level = level;
+    record.length = static_cast<uint16_t>(std::min(length, LOG_RECORD_TEXT_SIZE));
+    std::memcpy(record.text, message, record.length);
+
+    if (!m_ring.tryPush(std::move(record))) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (level >= LogLevel::Warn && m_writerSleeping.load(std::memory_order_relaxed)) {
+        m_wake.notify_one();
+    }
+    return true;
+}
+
+void LogSink::setFileOutput(const std::string& directory, size_t maxFileBytes, int maxFiles) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_directory = directory;
+        m_maxFileBytes = maxFileBytes;
+        m_maxFiles = maxFiles;
+        m_fileSettingsChanged = true;
+    }
+    m_wake.notify_one();
+}
+
+void LogSink::setPlatformOutput(bool enable) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_platformOutput = enable;
+}
+
+std::string LogSink::getFilePath() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string directory = m_directory.empty() ? FileUtils::getInstance()->getWritablePath() : m_directory;
+    if (!directory.empty() && directory.back() != '/' && directory.back() != '\\') {
+        directory += '/';
+    }
+    return directory + LOG_FILE_NAME;
+}
+
+void LogSink::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_state.load(std::memory_order_relaxed) != RUNNING) {
+        return;
+    }
+    const uint64_t target = ++m_flushRequests;
+    m_wake.notify_one();
+    m_flushed.wait(lock, [this, target]() {
+        return m_flushesDone >= target || m_state.load(std::memory_order_relaxed) != RUNNING;
+    });
+}
+
+void LogSink::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_state.store(STOPPED, std::memory_order_release);
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void LogSink::start() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_state.load(std::memory_order_relaxed) != IDLE) {
+        return;
+    }
+    m_thread = std::thread(&LogSink::run, this);
+    m_state.store(RUNNING, std::memory_order_release);
+}
+
+void LogSink::run() {
+    Tracer::getInstance().setThreadName("tech3c log writer");
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        const bool running = m_state.load(std::memory_order_relaxed) == RUNNING;
+        const uint64_t flushTarget = m_flushRequests;
+        const bool reopen = m_fileSettingsChanged;
+        m_activeMaxFileBytes = m_maxFileBytes;
+        m_activeMaxFiles = m_maxFiles;
+        m_activePlatformOutput = m_platformOutput;
+        m_fileSettingsChanged = false;
+        lock.unlock();
+
+        if (reopen && m_file) {
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+        bool wrote = drain();
+        if (m_file && (wrote || !running || flushTarget != m_flushesDone)) {
+            std::fflush(m_file);
+        }
+
+        lock.lock();
+        if (flushTarget > m_flushesDone) {
+            m_flushesDone = flushTarget;
+            m_flushed.notify_all();
+        }
+        if (!running) {
+            break;
+        }
+        if (!wrote) {
+            m_writerSleeping.store(true, std::memory_order_relaxed);
+            m_wake.wait_for(lock, WRITER_POLL_INTERVAL, [this]() {
+                return m_state.load(std::memory_order_relaxed) != RUNNING
+                       || m_flushRequests != m_flushesDone || m_fileSettingsChanged;
+            });
+            m_writerSleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+    lock.unlock();
+
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    m_flushed.notify_all();
+}
+
+bool LogSink::drain() {
+    bool wrote = false;
+    LogRecord record;
+    while (m_ring.tryPop(record)) {
+        writeRecord(record);
+        wrote = true;
+    }
+
+    const uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDrops) {
+        LogRecord notice;
+        notice.timeMs = nowMs();
+        notice.threadId = 0;
+        notice.level = LogLevel::Warn;
+        int length = std::snprintf(notice.text, sizeof(notice.text), "%llu log records dropped, the log ring was full",
+                                   static_cast<unsigned long long>(dropped - m_reportedDrops));
+        notice.length = static_cast<uint16_t>(std::min(static_cast<size_t>(std::max(length, 0)), sizeof(notice.text) - 1));
+        m_reportedDrops = dropped;
+        writeRecord(notice);
+        wrote = true;
+    }
+    return wrote;
+}
+
+void LogSink::writeRecord(const LogRecord& record) {
+    if (m_activePlatformOutput) {
+        writePlatform(record.level, record.text, record.length);
+    }
+
+    if (m_activeMaxFiles > 0) {
+        // "2026-01-31 23:59:59.123 E [3] message"
+        char line[LOG_RECORD_TEXT_SIZE + 48];
+        std::tm local = toLocalTime(record.timeMs);
+        int prefix = std::snprintf(line, sizeof(line), "%04d-%02d-%02d %02d:%02d:%02d.%03d %c [%u] ",
+                                   local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+                                   local.tm_hour, local.tm_min, local.tm_sec, static_cast<int>(record.timeMs % 1000),
+                                   LEVEL_CHARS[static_cast<int>(record.level) & 3], record.threadId);
+        size_t length = static_cast<size_t>(std::max(prefix, 0));
+        std::memcpy(line + length, record.text, record.length);
+        length += record.length;
+        line[length++] = '\n';
+        writeFile(line, length);
+    }
+
+    m_written.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogSink::writePlatform(LogLevel level, const char* text, size_t length) {
+    const int size = static_cast<int>(length);
+#if AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID
+    static const int priorities[] = {ANDROID_LOG_DEBUG, ANDROID_LOG_INFO, ANDROID_LOG_WARN, ANDROID_LOG_ERROR};
+    if (level < LogLevel::Silent) {
+        __android_log_print(priorities[static_cast<int>(level)], "Tech3CManager", "%.*s", size, text);
+    }
+#elif AX_TARGET_PLATFORM == AX_PLATFORM_IOS
+    static const char* tags[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+    if (level < LogLevel::Silent) {
+        printf("[Tech3C %s] %.*s\n", tags[static_cast<int>(level)], size, text);
+    }
+#endif
+    switch (level) {
+        case LogLevel::Debug:
+        case LogLevel::Info:
+            AXLOG("[Tech3C] %.*s", size, text);
+            break;
+        case LogLevel::Warn:
+            AXLOGWARN("[Tech3C WARN] %.*s", size, text);
+            break;
+        case LogLevel::Error:
+            AXLOGWARN("[Tech3C ERROR] %.*s", size, text);
+            break;
+        case LogLevel::Silent:
+            break;
+    }
+}
+
+void LogSink::writeFile(const char* line, size_t length) {
+    if (!m_file) {
+        openFile();
+        if (!m_file) {
+            return;
+        }
+    }
+
+    if (m_fileBytes > 0 && m_fileBytes + length > m_activeMaxFileBytes) {
+        rotateFile();
+        if (!m_file) {
+            return;
+        }
+    }
+
+    m_fileBytes += std::fwrite(line, 1, length, m_file);
+}
+
+void LogSink::openFile() {
+    m_filePath = getFilePath();
+    m_file = std::fopen(m_filePath.c_str(), "ab");
+    if (!m_file) {
+        return;
+    }
+    std::fseek(m_file, 0, SEEK_END);
+    long size = std::ftell(m_file);
+    m_fileBytes = size > 0 ? static_cast<size_t>(size) : 0;
+}
+
+void LogSink::rotateFile() {
+    std::fclose(m_file);
+    m_file = nullptr;
+
+    // tech3c.log.(n-1) falls off, every other file moves up by one
+    if (m_activeMaxFiles > 1) {
+        std::remove((m_filePath + "." + std::to_string(m_activeMaxFiles - 1)).c_str());
+        for (int i = m_activeMaxFiles - 2; i >= 1; --i) {
+            std::rename((m_filePath + "." + std::to_string(i)).c_str(),
+                        (m_filePath + "." + std::to_string(i + 1)).c_str());
+        }
+        std::rename(m_filePath.c_str(), (m_filePath + ".1").c_str());
+    } else {
+        std::remove(m_filePath.c_str());
+    }
+
+    m_file = std::fopen(m_filePath.c_str(), "wb");
+    m_fileBytes = 0;
+}
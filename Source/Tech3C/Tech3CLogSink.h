@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Tech3CLog.h"
+#include "Tech3CMpscRing.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace tech3c {
+
+    // Fixed size so queuing a record never allocates; longer messages are truncated
+    constexpr size_t LOG_RECORD_TEXT_SIZE = 240;
+
+    struct LogRecord {
+        int64_t timeMs;         // Unix epoch milliseconds, taken on the logging thread
+        uint32_t threadId;      // Small per-process id of the logging thread
+        LogLevel level;
+        uint16_t length;
+        char text[LOG_RECORD_TEXT_SIZE];
+    };
+
+    // Takes formatted log records from any thread without blocking and writes them from one
+    // background thread to the platform log and to a rotating file in the writable path
+    // (tech3c.log, tech3c.log.1, ...). When the ring is full the record is dropped and counted.
+    class LogSink {
+    public:
+        static LogSink& getInstance();
+
+        LogSink();
+        ~LogSink();
+
+        // Never blocks; returns false if the record was dropped
+        bool push(LogLevel level, const char* message, size_t length);
+
+        // Empty directory uses the writable path; maxFiles counts the live file too, 0 disables file output
+        void setFileOutput(const std::string& directory, size_t maxFileBytes, int maxFiles);
+        void setPlatformOutput(bool enable);
+        std::string getFilePath() const;
+
+        // Waits until everything pushed before the call is written and the file flushed
+        void flush();
+        // Drains the ring and joins the writer; records pushed afterwards are dropped. Runs at exit.
+        void stop();
+
+        uint64_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+        uint64_t getWrittenCount() const { return m_written.load(std::memory_order_relaxed); }
+
+    private:
+        LogSink(const LogSink&) = delete;
+        LogSink& operator=(const LogSink&) = delete;
+
+        enum State { IDLE, RUNNING, STOPPED };
+
+        void start();
+        void run();
+        // Writer thread only
+        bool drain();
+        void writeRecord(const LogRecord& record);
+        void writePlatform(LogLevel level, const char* text, size_t length);
+        void writeFile(const char* line, size_t length);
+        void openFile();
+        void rotateFile();
+
+        static constexpr size_t RING_CAPACITY = 512;
+
+        MpscRing<LogRecord> m_ring;
+        std::atomic<uint64_t> m_dropped;
+        std::atomic<uint64_t> m_written;
+        std::atomic<int> m_state;
+        std::atomic<bool> m_writerSleeping;
+
+        // Guards the writer lifecycle, settings and flush handshake; push() only takes it to start the writer
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_flushed;
+        std::thread m_thread;
+        uint64_t m_flushRequests;
+        uint64_t m_flushesDone;
+
+        // Settings, copied by the writer under m_mutex
+        std::string m_directory;
+        size_t m_maxFileBytes;
+        int m_maxFiles;
+        bool m_platformOutput;
+        bool m_fileSettingsChanged;
+
+        // Writer thread only
+        std::FILE* m_file;
+        std::string m_filePath;
+        size_t m_fileBytes;
+        size_t m_activeMaxFileBytes;
+        int m_activeMaxFiles;
+        bool m_activePlatformOutput;
+        uint64_t m_reportedDrops;
+    };
+}
@@ -0,0 +1,267 @@
+#include "Tech3CMaintenanceProbe.h"
+
+#if TECH3C_DESKTOP_BACKEND
+
+#include "Tech3CHttp.h"
+#include "Tech3CJson.h"
+#include "Tech3CTrace.h"
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace tech3c;
+
+namespace {
+
+    struct Attempt {
+        Attempt(std::string_view name, CircuitBreaker& circuit, int socket)
+                : endpoint(name), breaker(circuit), fd(socket), connected(false), reader(socket) {}
+        ~Attempt() { http::closeSocket(fd); }
+
+        std::string_view endpoint;
+        CircuitBreaker& breaker;
+        std::string request;
+        int fd;
+        bool connected;
+        http::Reader reader;
+    };
+
+    std::string_view trim(std::string_view s) {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+        return s;
+    }
+
+    // Starts the attempt for one list entry, null when it cannot even begin or its breaker is open
+    std::unique_ptr<Attempt> startAttempt(std::string_view endpoint, http::Poller& poller,
+                                          CircuitBreakerRegistry& breakers, bool& skipped) {
+        skipped = false;
+        std::string url(endpoint);
+        if (url.find("://") == std::string::npos) {
+            url.insert(0, "http://");
+        }
+        std::string host;
+        uint16_t port;
+        if (!http::parseUrl(url, host, port)) {
+            return nullptr;
+        }
+        CircuitBreaker& breaker = breakers.get(url);
+        if (!breaker.allowRequest()) {
+            skipped = true;
+            return nullptr;
+        }
+
+        int fd = http::beginConnect(host, port);
+        if (fd < 0) {
+            breaker.recordFailure();
+            return nullptr;
+        }
+        std::unique_ptr<Attempt> attempt(new Attempt(endpoint, breaker, fd));
+        if (!poller.add(fd, true)) {
+            breaker.recordCancelled();
+            return nullptr;
+        }
+        attempt->request = http::buildRequest("GET", host, "/v1/maintenance", std::string_view(), false);
+        return attempt;
+    }
+}
+
+MaintenanceProbe::MaintenanceProbe(CircuitBreakerRegistry& breakers)
+        : m_breakers(breakers)
+        , m_probeCount(0)
+        , m_cacheTtl(DEFAULT_CACHE_TTL_MS)
+        , m_attemptDelay(DEFAULT_ATTEMPT_DELAY_MS)
+        , m_timeout(DEFAULT_TIMEOUT_MS) {
+}
+
+void MaintenanceProbe::setCacheTtl(std::chrono::milliseconds ttl) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cacheTtl = ttl;
+}
+
+void MaintenanceProbe::setAttemptDelay(std::chrono::milliseconds delay) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_attemptDelay = delay;
+}
+
+void MaintenanceProbe::setTimeout(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_timeout = timeout;
+}
+
+void MaintenanceProbe::setRetryPolicy(const RetryPolicy& policy) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_retryPolicy = policy;
+}
+
+void MaintenanceProbe::clearCache() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_cache.begin(); it != m_cache.end();) {
+        // An entry being probed is filled in when the probe ends
+        it = it->second.probing ? std::next(it) : m_cache.erase(it);
+    }
+}
+
+MaintenanceProbe::Result MaintenanceProbe::check(const std::string& endpoints) {
+    Settings settings;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        bool waited = false;
+        for (;;) {
+            Entry& entry = m_cache[endpoints];
+            if (entry.probing) {
+                m_probed.wait(lock);
+                waited = true;
+                continue;
+            }
+            // After waiting, the probe that just ended answers for this caller too, even unanswered
+            if (waited || (entry.result.answered && std::chrono::steady_clock::now() < entry.expiresAt)) {
+                return entry.result;
+            }
+            entry.probing = true;
+            break;
+        }
+        settings.attemptDelay = m_attemptDelay;
+        settings.timeout = m_timeout;
+        settings.retry = m_retryPolicy;
+    }
+
+    Result result = probe(endpoints, settings);
+    m_probeCount.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = m_cache[endpoints];
+    entry.result = result;
+    entry.expiresAt = std::chrono::steady_clock::now() + m_cacheTtl;
+    entry.probing = false;
+    m_probed.notify_all();
+    return result;
+}
+
+MaintenanceProbe::Result MaintenanceProbe::probe(std::string_view endpoints, const Settings& settings) {
+    TECH3C_TRACE_SCOPE("desktop", "MaintenanceProbe::probe");
+    Result result;
+
+    const auto deadline = std::chrono::steady_clock::now() + settings.timeout;
+    auto nextStart = std::chrono::steady_clock::now();
+    http::Poller poller;
+    std::vector<std::unique_ptr<Attempt>> attempts;     // In flight
+    std::vector<int> ready;
+    http::MessageHead head;
+    std::string_view pending = endpoints;               // Not started yet this round
+    int round = 1;
+    bool reached = false;                               // Some endpoint of this round got an attempt
+
+    auto fail = [&poller, &attempts](size_t index) {
+        poller.remove(attempts[index]->fd);
+        attempts[index]->breaker.recordFailure();
+        attempts.erase(attempts.begin() + static_cast<std::ptrdiff_t>(index));
+    };
+
+    while (!result.answered) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            break;
+        }
+
+        // The next endpoint is due: its turn has come, or every earlier attempt already failed
+        if (!pending.empty() && (now >= nextStart || attempts.empty())) {
+            const size_t comma = pending.find(',');
+            std::string_view endpoint = trim(pending.substr(0, comma));
+            pending = comma == std::string_view::npos ? std::string_view() : pending.substr(comma + 1);
+            if (endpoint.empty()) {
+                continue;
+            }
+
+            bool skipped;
+            std::unique_ptr<Attempt> attempt = startAttempt(endpoint, poller, m_breakers, skipped);
+            reached = reached || !skipped;
+            if (attempt) {
+                attempts.push_back(std::move(attempt));
+                nextStart = now + settings.attemptDelay;
+            }
+            continue;
+        }
+        if (attempts.empty()) {
+            // Every endpoint failed. When every one was failing fast there is nothing to wait for,
+            // otherwise the list gets another round after the backoff, time permitting
+            if (!reached || round >= settings.retry.maxAttempts) {
+                break;
+            }
+            const auto retryAt = now + settings.retry.delayBefore(round++);
+            if (retryAt >= deadline) {
+                break;
+            }
+            std::this_thread::sleep_until(retryAt);
+            pending = endpoints;
+            reached = false;
+            nextStart = retryAt;
+            continue;
+        }
+
+        const auto wakeAt = pending.empty() ? deadline : std::min(deadline, nextStart);
+        poller.wait(std::chrono::ceil<std::chrono::milliseconds>(wakeAt - now), ready);
+
+        for (int fd : ready) {
+            size_t index = 0;
+            while (index < attempts.size() && attempts[index]->fd != fd) {
+                ++index;
+            }
+            if (index == attempts.size()) {
+                continue;
+            }
+            Attempt& attempt = *attempts[index];
+
+            if (!attempt.connected) {
+                // The request fits the empty send buffer of a fresh connection, sending never waits
+                poller.remove(fd);
+                if (!http::finishConnect(fd) || !http::sendAll(fd, attempt.request, settings.timeout)
+                        || !poller.add(fd, false)) {
+                    attempt.breaker.recordFailure();
+                    attempts.erase(attempts.begin() + static_cast<std::ptrdiff_t>(index));
+                    nextStart = now;
+                    continue;
+                }
+                attempt.connected = true;
+                continue;
+            }
+
+            if (!attempt.reader.readResponse(head, std::chrono::milliseconds(0))) {
+                if (attempt.reader.isClosed()) {
+                    fail(index);
+                    nextStart = now;
+                }
+                continue;
+            }
+
+            std::string_view body = std::string_view(attempt.reader.getBuffer()).substr(head.bodyOffset, head.bodyLength);
+            bool maintenance = false;
+            if (head.status == 200 && json::getBool(body, "maintenance", maintenance)) {
+                attempt.breaker.recordSuccess();
+                result.answered = true;
+                result.maintenance = maintenance;
+                result.endpoint.assign(attempt.endpoint);
+                break;
+            }
+            // Not a maintenance endpoint after all, or it is failing
+            fail(index);
+            nextStart = now;
+        }
+    }
+
+    // The attempts still in flight go unanswered, closing them is the cancellation. Those that
+    // lost the race say nothing about their endpoint; those that ran out of time count as failures
+    const bool timedOut = !result.answered;
+    for (const auto& attempt : attempts) {
+        if (timedOut) {
+            attempt->breaker.recordFailure();
+        } else {
+            attempt->breaker.recordCancelled();
+        }
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Tech3CPlatform.h"
+#include "Tech3CRetry.h"
+
+#if TECH3C_DESKTOP_BACKEND
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace tech3c {
+
+    // Maintenance check against several endpoints at once, shared by the sessions of a SessionHost.
+    // Attempts start the happy eyeballs way (RFC 8305): the first right away, each next one after
+    // the attempt delay or as soon as an earlier one fails. The first answer wins and the attempts
+    // still in flight are closed, so one black-holed endpoint costs an attempt delay, not a timeout.
+    //
+    // Answers are cached per endpoint list for the TTL; callers asking while a probe of the same
+    // list is in flight wait for it instead of sending their own. Every endpoint has a circuit
+    // breaker, those failing fast are skipped; when every attempt of a round failed, the round is
+    // retried after a backoff while the timeout allows.
+    class MaintenanceProbe {
+    public:
+        struct Result {
+            bool answered = false;      // False when no endpoint answered in time
+            bool maintenance = false;
+            std::string endpoint;       // The endpoint that answered
+        };
+
+        // breakers must outlive the probe
+        explicit MaintenanceProbe(CircuitBreakerRegistry& breakers);
+
+        void setCacheTtl(std::chrono::milliseconds ttl);
+        void setAttemptDelay(std::chrono::milliseconds delay);
+        void setTimeout(std::chrono::milliseconds timeout);
+        // maxAttempts rounds at most
+        void setRetryPolicy(const RetryPolicy& policy);
+
+        // Blocking. endpoints is a comma-separated list of "host[:port]" or "http://host[:port]",
+        // each serving GET /v1/maintenance; host names are resolved as their attempt starts.
+        // Unanswered probes are not cached, the next call tries again.
+        Result check(const std::string& endpoints);
+        void clearCache();
+
+        // Probes actually sent, cached answers do not count
+        uint64_t getProbeCount() const { return m_probeCount.load(std::memory_order_relaxed); }
+
+    private:
+        MaintenanceProbe(const MaintenanceProbe&) = delete;
+        MaintenanceProbe& operator=(const MaintenanceProbe&) = delete;
+
+        struct Entry {
+            Result result;
+            std::chrono::steady_clock::time_point expiresAt;
+            bool probing = false;
+        };
+
+        struct Settings {
+            std::chrono::milliseconds attemptDelay;
+            std::chrono::milliseconds timeout;
+            RetryPolicy retry;
+        };
+
+        Result probe(std::string_view endpoints, const Settings& settings);
+
+        static constexpr int64_t DEFAULT_CACHE_TTL_MS = 30000;
+        static constexpr int64_t DEFAULT_ATTEMPT_DELAY_MS = 250;   // RFC 8305's recommended delay
+        static constexpr int64_t DEFAULT_TIMEOUT_MS = 5000;
+
+        CircuitBreakerRegistry& m_breakers;
+        std::atomic<uint64_t> m_probeCount;
+
+        // Guarded by m_mutex
+        std::mutex m_mutex;
+        std::condition_variable m_probed;
+        std::unordered_map<std::string, Entry> m_cache;
+        std::chrono::milliseconds m_cacheTtl;
+        std::chrono::milliseconds m_attemptDelay;
+        std::chrono::milliseconds m_timeout;
+        RetryPolicy m_retryPolicy;
+    };
+}
+
+#endif
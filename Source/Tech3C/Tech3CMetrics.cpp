@@ -0,0 +1,291 @@
+#include "Tech3CMetrics.h"
+#include "Tech3CJson.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+using namespace tech3c;
+
+namespace {
+
+    const uint64_t NO_MIN = std::numeric_limits<uint64_t>::max();
+
+    const size_t OPERATION_COUNT = static_cast<size_t>(MetricOperation::COUNT);
+
+    int highestBit(uint64_t value) {
+        return static_cast<int>(std::bit_width(value)) - 1;
+    }
+
+    int64_t epochMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    double rate(uint64_t part, uint64_t total) {
+        return total > 0 ? static_cast<double>(part) / static_cast<double>(total) : 0.0;
+    }
+}
+
+std::string tech3c::metricOperationToString(MetricOperation operation) {
+    switch (operation) {
+        case MetricOperation::INITIALIZE: return "initialize";
+        case MetricOperation::AUTH_SCREEN_OPEN: return "auth_screen_open";
+        case MetricOperation::AUTH_LOGIN: return "auth_login";
+        case MetricOperation::LOGOUT: return "logout";
+        case MetricOperation::TOKEN_REFRESH: return "token_refresh";
+        default: return "unknown";
+    }
+}
+
+//========================================================================
+// LatencyHistogram
+
+size_t LatencyHistogram::bucketIndex(uint64_t valueUs) {
+    if (valueUs < static_cast<uint64_t>(SUB_BUCKETS)) {
+        return static_cast<size_t>(valueUs);
+    }
+    if (valueUs > MAX_VALUE_US) {
+        return BUCKET_COUNT - 1;
+    }
+    // Row = power of two above the linear range, column = the next SUB_BUCKET_BITS bits
+    const int msb = highestBit(valueUs);
+    const int row = msb - SUB_BUCKET_BITS + 1;
+    const uint64_t column = (valueUs >> (msb - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+    return static_cast<size_t>(row) * SUB_BUCKETS + static_cast<size_t>(column);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < static_cast<size_t>(SUB_BUCKETS)) {
+        return index;
+    }
+    const int row = static_cast<int>(index / SUB_BUCKETS);
+    const uint64_t mantissa = SUB_BUCKETS + index % SUB_BUCKETS;
+    const uint64_t width = uint64_t(1) << (row - 1);
+    return mantissa * width + width - 1;
+}
+
+void LatencyHistogram::record(uint64_t valueUs) {
+    m_buckets[bucketIndex(valueUs)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumUs.fetch_add(valueUs, std::memory_order_relaxed);
+
+    uint64_t current = m_minUs.load(std::memory_order_relaxed);
+    while (valueUs < current && !m_minUs.compare_exchange_weak(current, valueUs, std::memory_order_relaxed)) {
+    }
+    current = m_maxUs.load(std::memory_order_relaxed);
+    while (valueUs > current && !m_maxUs.compare_exchange_weak(current, valueUs, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    // Relaxed reads of a histogram that may still be written: close enough for reporting
+    std::array<uint32_t, BUCKET_COUNT> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    Snapshot snapshot;
+    if (total == 0) {
+        return snapshot;
+    }
+
+    snapshot.count = total;
+    snapshot.minUs = m_minUs.load(std::memory_order_relaxed);
+    snapshot.maxUs = m_maxUs.load(std::memory_order_relaxed);
+    snapshot.meanUs = static_cast<double>(m_sumUs.load(std::memory_order_relaxed))
+                      / static_cast<double>(std::max<uint64_t>(m_count.load(std::memory_order_relaxed), 1));
+
+    const double quantiles[] = {0.50, 0.90, 0.99, 0.999};
+    uint64_t* targets[] = {&snapshot.p50Us, &snapshot.p90Us, &snapshot.p99Us, &snapshot.p999Us};
+    size_t next = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT && next < 4; ++i) {
+        seen += counts[i];
+        while (next < 4 && seen >= static_cast<uint64_t>(std::ceil(quantiles[next] * static_cast<double>(total)))) {
+            *targets[next++] = std::min(bucketUpperBound(i), snapshot.maxUs);
+        }
+    }
+    return snapshot;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sumUs.store(0, std::memory_order_relaxed);
+    m_minUs.store(NO_MIN, std::memory_order_relaxed);
+    m_maxUs.store(0, std::memory_order_relaxed);
+}
+
+//========================================================================
+// AuthFunnel / MetricsSnapshot
+
+double AuthFunnel::successRate() const {
+    return rate(loginSuccess + registerSuccess, screenOpened);
+}
+
+double AuthFunnel::cancelRate() const {
+    return rate(cancelled, screenOpened);
+}
+
+double AuthFunnel::errorRate() const {
+    return rate(errors, screenOpened);
+}
+
+std::string MetricsSnapshot::toJson() const {
+    std::string operations = "{";
+    for (size_t i = 0; i < OPERATION_COUNT; ++i) {
+        const LatencyHistogram::Snapshot& h = latency[i];
+        std::string entry = "{";
+        json::appendInt(entry, "count", static_cast<int64_t>(h.count));
+        json::appendInt(entry, "failures", static_cast<int64_t>(failures[i]));
+        json::appendInt(entry, "minUs", static_cast<int64_t>(h.minUs));
+        json::appendInt(entry, "p50Us", static_cast<int64_t>(h.p50Us));
+        json::appendInt(entry, "p90Us", static_cast<int64_t>(h.p90Us));
+        json::appendInt(entry, "p99Us", static_cast<int64_t>(h.p99Us));
+        json::appendInt(entry, "p999Us", static_cast<int64_t>(h.p999Us));
+        json::appendInt(entry, "maxUs", static_cast<int64_t>(h.maxUs));
+        json::appendDouble(entry, "meanUs", h.meanUs, 1);
+        entry += "}";
+        json::appendRaw(operations, metricOperationToString(static_cast<MetricOperation>(i)), entry);
+    }
+    operations += "}";
+
+    std::string errors = "{";
+    for (const auto& error : errorsByCode) {
+        json::appendInt(errors, std::to_string(error.first), static_cast<int64_t>(error.second));
+    }
+    errors += "}";
+
+    std::string auth = "{";
+    json::appendInt(auth, "shown", static_cast<int64_t>(funnel.shown));
+    json::appendInt(auth, "screenOpened", static_cast<int64_t>(funnel.screenOpened));
+    json::appendInt(auth, "loginSuccess", static_cast<int64_t>(funnel.loginSuccess));
+    json::appendInt(auth, "registerSuccess", static_cast<int64_t>(funnel.registerSuccess));
+    json::appendInt(auth, "cancelled", static_cast<int64_t>(funnel.cancelled));
+    json::appendInt(auth, "errors", static_cast<int64_t>(funnel.errors));
+    json::appendDouble(auth, "successRate", funnel.successRate());
+    json::appendDouble(auth, "cancelRate", funnel.cancelRate());
+    json::appendDouble(auth, "errorRate", funnel.errorRate());
+    auth += "}";
+
+    std::string contention = "{";
+    json::appendInt(contention, "count", static_cast<int64_t>(lockWait.count));
+    json::appendInt(contention, "p50Us", static_cast<int64_t>(lockWait.p50Us));
+    json::appendInt(contention, "p99Us", static_cast<int64_t>(lockWait.p99Us));
+    json::appendInt(contention, "maxUs", static_cast<int64_t>(lockWait.maxUs));
+    json::appendDouble(contention, "meanUs", lockWait.meanUs, 1);
+    contention += "}";
+
+    std::string out = "{";
+    json::appendInt(out, "sinceMs", sinceMs);
+    json::appendRaw(out, "operations", operations);
+    json::appendRaw(out, "errorsByCode", errors);
+    json::appendRaw(out, "authFunnel", auth);
+    json::appendRaw(out, "lockWait", contention);
+    out += "}";
+    return out;
+}
+
+//========================================================================
+// Metrics
+
+Metrics::Metrics() {
+    reset();
+}
+
+void Metrics::recordLatency(MetricOperation operation, uint64_t valueUs) {
+    m_latency[static_cast<size_t>(operation)].record(valueUs);
+}
+
+void Metrics::recordFailure(MetricOperation operation) {
+    m_failures[static_cast<size_t>(operation)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::recordError(int code) {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    ++m_errorsByCode[code];
+}
+
+void Metrics::authStarted() {
+    const uint64_t now = nowUs();
+    m_shown.fetch_add(1, std::memory_order_relaxed);
+    m_authStartUs.store(now, std::memory_order_relaxed);
+    m_authOpenStartUs.store(now, std::memory_order_relaxed);
+}
+
+void Metrics::authScreenOpened() {
+    m_screenOpened.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t start = m_authOpenStartUs.exchange(0, std::memory_order_relaxed);
+    if (start != 0) {
+        recordLatency(MetricOperation::AUTH_SCREEN_OPEN, nowUs() - start);
+    }
+}
+
+void Metrics::authSucceeded(bool registered) {
+    (registered ? m_registerSuccess : m_loginSuccess).fetch_add(1, std::memory_order_relaxed);
+    const uint64_t start = m_authStartUs.exchange(0, std::memory_order_relaxed);
+    if (start != 0) {
+        recordLatency(MetricOperation::AUTH_LOGIN, nowUs() - start);
+    }
+}
+
+void Metrics::authCancelled() {
+    m_cancelled.fetch_add(1, std::memory_order_relaxed);
+    m_authStartUs.store(0, std::memory_order_relaxed);
+    m_authOpenStartUs.store(0, std::memory_order_relaxed);
+}
+
+void Metrics::authFailed() {
+    // Errors outside a showAuth() (token refresh, bridge failures) only show up in errorsByCode
+    if (m_authStartUs.exchange(0, std::memory_order_relaxed) != 0) {
+        m_authErrors.fetch_add(1, std::memory_order_relaxed);
+        recordFailure(MetricOperation::AUTH_LOGIN);
+    }
+    m_authOpenStartUs.store(0, std::memory_order_relaxed);
+}
+
+MetricsSnapshot Metrics::snapshot() const {
+    MetricsSnapshot snapshot;
+    snapshot.sinceMs = m_sinceMs.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < OPERATION_COUNT; ++i) {
+        snapshot.latency[i] = m_latency[i].snapshot();
+        snapshot.failures[i] = m_failures[i].load(std::memory_order_relaxed);
+    }
+    snapshot.lockWait = m_lockWait.snapshot();
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        snapshot.errorsByCode = m_errorsByCode;
+    }
+    snapshot.funnel.shown = m_shown.load(std::memory_order_relaxed);
+    snapshot.funnel.screenOpened = m_screenOpened.load(std::memory_order_relaxed);
+    snapshot.funnel.loginSuccess = m_loginSuccess.load(std::memory_order_relaxed);
+    snapshot.funnel.registerSuccess = m_registerSuccess.load(std::memory_order_relaxed);
+    snapshot.funnel.cancelled = m_cancelled.load(std::memory_order_relaxed);
+    snapshot.funnel.errors = m_authErrors.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void Metrics::reset() {
+    for (size_t i = 0; i < OPERATION_COUNT; ++i) {
+        m_latency[i].reset();
+        m_failures[i].store(0, std::memory_order_relaxed);
+    }
+    m_lockWait.reset();
+    m_shown.store(0, std::memory_order_relaxed);
+    m_screenOpened.store(0, std::memory_order_relaxed);
+    m_loginSuccess.store(0, std::memory_order_relaxed);
+    m_registerSuccess.store(0, std::memory_order_relaxed);
+    m_cancelled.store(0, std::memory_order_relaxed);
+    m_authErrors.store(0, std::memory_order_relaxed);
+    m_authStartUs.store(0, std::memory_order_relaxed);
+    m_authOpenStartUs.store(0, std::memory_order_relaxed);
+    m_sinceMs.store(epochMs(), std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    m_errorsByCode.clear();
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace tech3c {
+
+    // Timed SDK operations
+    enum class MetricOperation {
+        INITIALIZE = 0,     // initialize() call
+        AUTH_SCREEN_OPEN,   // showAuth() -> onAuthScreenOpened
+        AUTH_LOGIN,         // showAuth() -> onLoginSuccess / onRegisterSuccess
+        LOGOUT,             // logout() call
+        TOKEN_REFRESH,      // refresh handler round trip
+        COUNT
+    };
+
+    std::string metricOperationToString(MetricOperation operation);
+
+    // Log-linear (HDR style) histogram of microsecond latencies: 16 linear sub-buckets per power
+    // of two, so any recorded value is reported within ~6%. Recording is a few relaxed atomic
+    // increments and never allocates; values above MAX_VALUE_US land in the last bucket.
+    class LatencyHistogram {
+    public:
+        static constexpr int SUB_BUCKET_BITS = 4;
+        static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static constexpr int MAX_EXPONENT = 32;     // 2^32 us, a bit over 71 minutes
+        static constexpr size_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+        static constexpr uint64_t MAX_VALUE_US = (uint64_t(1) << MAX_EXPONENT) - 1;
+
+        struct Snapshot {
+            uint64_t count = 0;
+            uint64_t minUs = 0;
+            uint64_t maxUs = 0;
+            double meanUs = 0.0;
+            uint64_t p50Us = 0;
+            uint64_t p90Us = 0;
+            uint64_t p99Us = 0;
+            uint64_t p999Us = 0;
+        };
+
+        LatencyHistogram() { reset(); }
+
+        void record(uint64_t valueUs);
+        Snapshot snapshot() const;
+        void reset();
+
+        static size_t bucketIndex(uint64_t valueUs);
+        // Highest value that maps to bucket index, used when reporting percentiles
+        static uint64_t bucketUpperBound(size_t index);
+
+    private:
+        LatencyHistogram(const LatencyHistogram&) = delete;
+        LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+        std::array<std::atomic<uint32_t>, BUCKET_COUNT> m_buckets;
+        std::atomic<uint64_t> m_count;
+        std::atomic<uint64_t> m_sumUs;
+        std::atomic<uint64_t> m_minUs;
+        std::atomic<uint64_t> m_maxUs;
+    };
+
+    // Counts for the auth funnel: every showAuth() should end in exactly one outcome
+    struct AuthFunnel {
+        uint64_t shown = 0;
+        uint64_t screenOpened = 0;
+        uint64_t loginSuccess = 0;
+        uint64_t registerSuccess = 0;
+        uint64_t cancelled = 0;
+        uint64_t errors = 0;
+
+        // Outcome rates relative to opened screens, 0 before the first one
+        double successRate() const;
+        double cancelRate() const;
+        double errorRate() const;
+    };
+
+    struct MetricsSnapshot {
+        int64_t sinceMs = 0;    // Unix epoch milliseconds of the last reset
+        std::array<LatencyHistogram::Snapshot, static_cast<size_t>(MetricOperation::COUNT)> latency;
+        std::array<uint64_t, static_cast<size_t>(MetricOperation::COUNT)> failures{};
+        std::map<int, uint64_t> errorsByCode;   // ErrorInfo::code -> occurrences
+        AuthFunnel funnel;
+        LatencyHistogram::Snapshot lockWait;    // Contended acquisitions of the session lock
+
+        std::string toJson() const;
+    };
+
+    // Runtime metrics for one Tech3CSession, recorded from any thread
+    class Metrics {
+    public:
+        Metrics();
+
+        void recordLatency(MetricOperation operation, uint64_t valueUs);
+        void recordFailure(MetricOperation operation);
+        void recordError(int code);
+        // Time a thread waited for the session lock, see ProfiledMutex
+        void recordLockWait(uint64_t valueUs) { m_lockWait.record(valueUs); }
+
+        // Auth funnel; authStarted() also starts the showAuth() timers
+        void authStarted();
+        void authScreenOpened();
+        void authSucceeded(bool registered);
+        void authCancelled();
+        void authFailed();
+
+        MetricsSnapshot snapshot() const;
+        void reset();
+
+        static uint64_t nowUs() {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        Metrics(const Metrics&) = delete;
+        Metrics& operator=(const Metrics&) = delete;
+
+        std::array<LatencyHistogram, static_cast<size_t>(MetricOperation::COUNT)> m_latency;
+        std::array<std::atomic<uint64_t>, static_cast<size_t>(MetricOperation::COUNT)> m_failures;
+        LatencyHistogram m_lockWait;
+
+        std::atomic<uint64_t> m_shown;
+        std::atomic<uint64_t> m_screenOpened;
+        std::atomic<uint64_t> m_loginSuccess;
+        std::atomic<uint64_t> m_registerSuccess;
+        std::atomic<uint64_t> m_cancelled;
+        std::atomic<uint64_t> m_authErrors;
+
+        // Start of the current showAuth(), 0 once the open/outcome was recorded
+        std::atomic<uint64_t> m_authStartUs;
+        std::atomic<uint64_t> m_authOpenStartUs;
+        std::atomic<int64_t> m_sinceMs;
+
+        // Errors are rare, a map behind a mutex is plenty
+        mutable std::mutex m_errorMutex;
+        std::map<int, uint64_t> m_errorsByCode;
+    };
+
+    // Records the lifetime of a scope into a histogram
+    class ScopedLatency {
+    public:
+        ScopedLatency(Metrics& metrics, MetricOperation operation)
+                : m_metrics(metrics), m_operation(operation), m_startUs(Metrics::nowUs()) {}
+        ~ScopedLatency() { m_metrics.recordLatency(m_operation, Metrics::nowUs() - m_startUs); }
+
+    private:
+        ScopedLatency(const ScopedLatency&) = delete;
+        ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+        Metrics& m_metrics;
+        MetricOperation m_operation;
+        uint64_t m_startUs;
+    };
+
+    // std::mutex that records into Metrics how long contended lock() calls waited. Uncontended it
+    // costs one try_lock, the same as a plain lock().
+    class ProfiledMutex {
+    public:
+        explicit ProfiledMutex(Metrics& metrics) : m_metrics(metrics) {}
+
+        void lock() {
+            if (m_mutex.try_lock()) {
+                return;
+            }
+            const uint64_t startUs = Metrics::nowUs();
+            m_mutex.lock();
+            m_metrics.recordLockWait(Metrics::nowUs() - startUs);
+        }
+        bool try_lock() { return m_mutex.try_lock(); }
+        void unlock() { m_mutex.unlock(); }
+
+    private:
+        ProfiledMutex(const ProfiledMutex&) = delete;
+        ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+        std::mutex m_mutex;
+        Metrics& m_metrics;
+    };
+}
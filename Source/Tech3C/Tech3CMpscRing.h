@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace tech3c {
+
+    // Bounded lock-free multi-producer / single-consumer ring (Vyukov style sequence cells).
+    // tryPush may be called from any thread, tryPop only from the consuming thread. The capacity
+    // is picked at construction, so rings of many sessions can be sized to what each one needs.
+    template <typename T>
+    class MpscRing {
+    public:
+        // capacity must be a power of two, at least 2
+        explicit MpscRing(size_t capacity)
+                : m_cells(new Cell[capacity])
+                , m_mask(capacity - 1)
+                , m_enqueuePos(0)
+                , m_dequeuePos(0) {
+            assert(capacity >= 2 && (capacity & (capacity - 1)) == 0 && "capacity must be a power of two");
+            for (size_t i = 0; i < capacity; ++i) {
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpscRing(const MpscRing&) = delete;
+        MpscRing& operator=(const MpscRing&) = delete;
+
+        // Returns false when the ring is full
+        bool tryPush(T&& value) {
+            Cell* cell;
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                cell = &m_cells[pos & m_mask];
+                size_t seq = cell->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only
+        bool tryPop(T& out) {
+            Cell& cell = m_cells[m_dequeuePos & m_mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(m_dequeuePos + 1) < 0) {
+                return false;
+            }
+
+            out = std::move(cell.value);
+            cell.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+            ++m_dequeuePos;
+            return true;
+        }
+
+        size_t capacity() const { return m_mask + 1; }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        const std::unique_ptr<Cell[]> m_cells;
+        const size_t m_mask;
+        alignas(64) std::atomic<size_t> m_enqueuePos;
+        alignas(64) size_t m_dequeuePos;
+    };
+}
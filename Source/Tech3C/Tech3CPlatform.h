@@ -0,0 +1,10 @@
+#pragma once
+
+#include "platform/PlatformConfig.h"
+
+// Desktop builds have no native Tech3C SDK, auth runs against an HTTP auth service instead
+#if AX_TARGET_PLATFORM == AX_PLATFORM_LINUX || AX_TARGET_PLATFORM == AX_PLATFORM_MAC
+#define TECH3C_DESKTOP_BACKEND 1
+#else
+#define TECH3C_DESKTOP_BACKEND 0
+#endif
@@ -0,0 +1,177 @@
+#include "Tech3CRetry.h"
+#include "Tech3CLog.h"
+#include <algorithm>
+#include <random>
+
+using namespace tech3c;
+
+namespace {
+
+    int64_t jitterMs(int64_t capMs) {
+        static thread_local std::mt19937_64 rng(std::random_device{}()
+                ^ (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count());
+        return std::uniform_int_distribution<int64_t>(0, capMs)(rng);
+    }
+}
+
+//========================================================================
+// RetryPolicy
+
+std::chrono::milliseconds RetryPolicy::delayBefore(int retry) const {
+    const int64_t maxMs = std::max<int64_t>(maxDelay.count(), 0);
+    int64_t capMs = std::min(std::max<int64_t>(initialDelay.count(), 0), maxMs);
+    for (int i = 1; i < retry && capMs < maxMs; ++i) {
+        capMs = std::min(capMs * std::max(multiplier, 1), maxMs);
+    }
+    return std::chrono::milliseconds(jitterMs(capMs));
+}
+
+//========================================================================
+// CircuitBreaker
+
+CircuitBreaker::CircuitBreaker(const std::string& endpoint, const CircuitBreakerPolicy& policy)
+        : m_endpoint(endpoint)
+        , m_state(CircuitState::CLOSED)
+        , m_rejected(0)
+        , m_policy(policy)
+        , m_failures(0) {
+}
+
+bool CircuitBreaker::allowRequest() {
+    if (m_state.load(std::memory_order_acquire) == CircuitState::CLOSED) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto now = std::chrono::steady_clock::now();
+    const CircuitState state = m_state.load(std::memory_order_relaxed);
+    if (state == CircuitState::CLOSED) {
+        return true;
+    }
+    // OPEN and its time is up, or HALF_OPEN and the trial never reported: this caller is the trial
+    if (now >= m_retryAt) {
+        if (state == CircuitState::OPEN) {
+            TECH3C_LOGD("Circuit for {} half open", m_endpoint);
+        }
+        m_state.store(CircuitState::HALF_OPEN, std::memory_order_release);
+        m_retryAt = now + m_policy.openDuration;
+        return true;
+    }
+    m_rejected.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void CircuitBreaker::recordSuccess() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_state.load(std::memory_order_relaxed) != CircuitState::CLOSED) {
+        TECH3C_LOGD("Circuit for {} closed", m_endpoint);
+    }
+    m_failures = 0;
+    m_state.store(CircuitState::CLOSED, std::memory_order_release);
+}
+
+void CircuitBreaker::recordFailure() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_failures;
+    const auto now = std::chrono::steady_clock::now();
+    switch (m_state.load(std::memory_order_relaxed)) {
+        case CircuitState::CLOSED:
+            if (m_failures >= static_cast<uint32_t>(std::max(m_policy.failureThreshold, 1))) {
+                openLocked(now);
+            }
+            break;
+        case CircuitState::HALF_OPEN:
+            openLocked(now);
+            break;
+        case CircuitState::OPEN:
+            // A request let through before it opened, the open period stays as it is
+            break;
+    }
+}
+
+void CircuitBreaker::recordCancelled() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_state.load(std::memory_order_relaxed) == CircuitState::HALF_OPEN) {
+        // The trial is free for the next caller
+        m_retryAt = std::chrono::steady_clock::now();
+    }
+}
+
+void CircuitBreaker::setPolicy(const CircuitBreakerPolicy& policy) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_policy = policy;
+}
+
+std::chrono::milliseconds CircuitBreaker::getRetryAfter() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return retryAfterLocked();
+}
+
+CircuitBreakerStatus CircuitBreaker::getStatus() const {
+    CircuitBreakerStatus status;
+    status.endpoint = m_endpoint;
+    status.rejected = m_rejected.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    status.state = m_state.load(std::memory_order_relaxed);
+    status.consecutiveFailures = m_failures;
+    status.retryAfterMs = retryAfterLocked().count();
+    return status;
+}
+
+std::chrono::milliseconds CircuitBreaker::retryAfterLocked() const {
+    if (m_state.load(std::memory_order_relaxed) != CircuitState::OPEN) {
+        return std::chrono::milliseconds(0);
+    }
+    const auto left = std::chrono::ceil<std::chrono::milliseconds>(m_retryAt - std::chrono::steady_clock::now());
+    return std::max(left, std::chrono::milliseconds(0));
+}
+
+void CircuitBreaker::openLocked(std::chrono::steady_clock::time_point now) {
+    TECH3C_LOGW("Circuit for {} open after {} failures, failing fast for {} ms",
+                m_endpoint, m_failures, m_policy.openDuration.count());
+    m_state.store(CircuitState::OPEN, std::memory_order_release);
+    m_retryAt = now + m_policy.openDuration;
+}
+
+//========================================================================
+// CircuitBreakerRegistry
+
+CircuitBreaker& CircuitBreakerRegistry::get(const std::string& endpoint) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<CircuitBreaker>& breaker = m_breakers[endpoint];
+    if (!breaker) {
+        breaker.reset(new CircuitBreaker(endpoint, m_policy));
+    }
+    return *breaker;
+}
+
+void CircuitBreakerRegistry::setPolicy(const CircuitBreakerPolicy& policy) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_policy = policy;
+    for (auto& entry : m_breakers) {
+        entry.second->setPolicy(policy);
+    }
+}
+
+std::vector<CircuitBreakerStatus> CircuitBreakerRegistry::getStatus() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<CircuitBreakerStatus> status;
+    status.reserve(m_breakers.size());
+    for (const auto& entry : m_breakers) {
+        status.push_back(entry.second->getStatus());
+    }
+    return status;
+}
+
+namespace tech3c {
+
+    std::string circuitStateToString(CircuitState state) {
+        switch (state) {
+            case CircuitState::CLOSED: return "Closed";
+            case CircuitState::OPEN: return "Open";
+            case CircuitState::HALF_OPEN: return "HalfOpen";
+            default: return "Closed";
+        }
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tech3c {
+
+    // Backoff between attempts of an idempotent operation (initialize, maintenance probe, token
+    // refresh). Delays grow exponentially and are drawn with full jitter, uniformly from
+    // [0, min(maxDelay, initialDelay * multiplier^(retry - 1))], so clients that failed together
+    // do not come back together.
+    struct RetryPolicy {
+        int maxAttempts = 3;                                // Including the first, 1 disables retries
+        std::chrono::milliseconds initialDelay{ 200 };
+        std::chrono::milliseconds maxDelay{ 30000 };
+        int multiplier = 2;
+
+        // Delay before retry number `retry`, 1 being the one after the first failure
+        std::chrono::milliseconds delayBefore(int retry) const;
+    };
+
+    enum class CircuitState {
+        CLOSED = 0,     // Requests go through
+        OPEN,           // Failing fast until the open duration is over
+        HALF_OPEN       // One trial request decides between CLOSED and OPEN
+    };
+
+    struct CircuitBreakerPolicy {
+        int failureThreshold = 5;                           // Consecutive failures that open it
+        std::chrono::milliseconds openDuration{ 30000 };
+    };
+
+    struct CircuitBreakerStatus {
+        std::string endpoint;
+        CircuitState state = CircuitState::CLOSED;
+        uint32_t consecutiveFailures = 0;
+        int64_t retryAfterMs = 0;       // Until the next trial while OPEN, else 0
+        uint64_t rejected = 0;          // Requests failed fast so far
+    };
+
+    // Health of one backend endpoint as its callers see it. Callers ask allowRequest() first and
+    // report how the request went; requests that never reached the endpoint report nothing.
+    // Thread-safe; allowRequest() takes no lock while closed.
+    class CircuitBreaker {
+    public:
+        CircuitBreaker(const std::string& endpoint, const CircuitBreakerPolicy& policy);
+
+        // False while open. Once the open duration is over one caller gets through as the trial,
+        // the others keep failing fast until it reports (or an open duration passes without a report).
+        bool allowRequest();
+        void recordSuccess();
+        void recordFailure();
+        // The request allowed last was abandoned before it had a result, e.g. a cancelled probe
+        void recordCancelled();
+
+        void setPolicy(const CircuitBreakerPolicy& policy);
+        CircuitState getState() const { return m_state.load(std::memory_order_acquire); }
+        // Until the next trial while OPEN, else 0
+        std::chrono::milliseconds getRetryAfter() const;
+        CircuitBreakerStatus getStatus() const;
+        const std::string& getEndpoint() const { return m_endpoint; }
+
+    private:
+        CircuitBreaker(const CircuitBreaker&) = delete;
+        CircuitBreaker& operator=(const CircuitBreaker&) = delete;
+
+        void openLocked(std::chrono::steady_clock::time_point now);
+        std::chrono::milliseconds retryAfterLocked() const;
+
+        const std::string m_endpoint;
+        std::atomic<CircuitState> m_state;
+        std::atomic<uint64_t> m_rejected;
+
+        // Guarded by m_mutex
+        mutable std::mutex m_mutex;
+        CircuitBreakerPolicy m_policy;
+        uint32_t m_failures;
+        std::chrono::steady_clock::time_point m_retryAt;     // Next trial once OPEN, trial expiry once HALF_OPEN
+    };
+
+    // The breakers of a SessionHost, one per endpoint, created on first use and kept as long as
+    // the registry; references stay valid
+    class CircuitBreakerRegistry {
+    public:
+        CircuitBreakerRegistry() = default;
+
+        CircuitBreaker& get(const std::string& endpoint);
+        // Applies to the breakers there are and the ones created later
+        void setPolicy(const CircuitBreakerPolicy& policy);
+        // Every breaker, sorted by endpoint
+        std::vector<CircuitBreakerStatus> getStatus() const;
+
+    private:
+        CircuitBreakerRegistry(const CircuitBreakerRegistry&) = delete;
+        CircuitBreakerRegistry& operator=(const CircuitBreakerRegistry&) = delete;
+
+        mutable std::mutex m_mutex;
+        CircuitBreakerPolicy m_policy;
+        std::map<std::string, std::unique_ptr<CircuitBreaker>> m_breakers;
+    };
+
+    std::string circuitStateToString(CircuitState state);
+}
@@ -0,0 +1,1626 @@
+#include "Tech3CSession.h"
+#include "Tech3CBridgeChannel.h"
+#include "Tech3CLog.h"
+#include "Tech3CTrace.h"
+#include "platform/PlatformConfig.h"
+#include <algorithm>
+#include <chrono>
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID
+#include "platform/android/jni/JniHelper.h"
+#include <jni.h>
+#include <cstdarg>
+#elif AX_TARGET_PLATFORM == AX_PLATFORM_IOS
+#include "Tech3C-iOS.h"
+#endif
+#include "Tech3CDesktopBackend.h"
+
+using namespace tech3c;
+
+static const char* JAVA_CLASS_NAME = "dev/axmol/lib/Tech3CHelper";
+static const char* JAVA_CHANNEL_CLASS_NAME = "dev/axmol/lib/Tech3CChannel";
+static const char* EVENT_DRAIN_KEY = "tech3c_event_drain";
+
+// acquireToken() result that needs no refresh
+static TokenFuture readyToken(AsyncResult<UserSnapshot> result) {
+    std::promise<AsyncResult<UserSnapshot>> promise;
+    promise.set_value(std::move(result));
+    return promise.get_future().share();
+}
+
+// MpscRing masks positions, so SessionOptions::eventQueueCapacity is rounded up to a power of two
+static size_t eventQueueCapacityFor(size_t requested) {
+    constexpr size_t MAX_EVENT_QUEUE_CAPACITY = 1 << 16;
+    size_t capacity = 2;
+    while (capacity < requested && capacity < MAX_EVENT_QUEUE_CAPACITY) {
+        capacity <<= 1;
+    }
+    if (capacity != requested) {
+        TECH3C_LOGW("eventQueueCapacity {} is not a power of two in [2, {}], using {}",
+                    requested, MAX_EVENT_QUEUE_CAPACITY, capacity);
+    }
+    return capacity;
+}
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID
+namespace {
+
+    struct BridgeMethodSpec {
+        const char* name;
+        const char* signature;
+        int errorCode;          // Reported when the Java call throws; errorCode + 1 when the method is missing
+        const char* errorMessage;
+    };
+
+    // Indexed by BridgeMethod, keep in the same order as the enum
+    constexpr BridgeMethodSpec BRIDGE_METHODS[] = {
+        { "initialize",                "(Ljava/lang/String;Ljava/lang/String;)V", 0,    "Failed to initialize" },
+        { "setDebugMode",              "(Z)V",                                     1010, "Failed to set debug mode" },
+        { "setUiMode",                 "(I)V",                                     1008, "Failed to set UI mode" },
+        { "setLanguage",               "(I)V",                                     1006, "Failed to set language" },
+        { "setOrientation",            "(I)V",                                     1004, "Failed to set orientation" },
+        { "setEnableGuestLogin",       "(Z)V",                                     1012, "Failed to set guest login" },
+        { "setDisableExitLogin",       "(Z)V",                                     1014, "Failed to set disable exit login" },
+        { "setRequireOtp",             "(Z)V",                                     1016, "Failed to set require OTP" },
+        { "setEnableMaintenanceCheck", "(Z)V",                                     1018, "Failed to set maintenance check" },
+        { "setIpMaintenanceCheck",     "(Ljava/lang/String;)V",                    1022, "Failed to set IP maintenance check" },
+        { "setEnableRequireBOD",       "(Z)V",                                     1018, "Failed to set enable Require BOD" },
+        { "showAuth",                  "()V",                                      1002, "Failed to show authentication screen" },
+        { "logout",                    "()V",                                      1020, "Failed to logout" },
+        { "applyConfig",               "(IZIIIZZZZLjava/lang/String;Z)V",          1025, "Failed to apply configuration" },
+    };
+    static_assert(sizeof(BRIDGE_METHODS) / sizeof(BRIDGE_METHODS[0]) == static_cast<size_t>(BridgeMethod::Count),
+                  "BRIDGE_METHODS must have one entry per BridgeMethod");
+
+    // Global class ref and method IDs for Tech3CHelper, resolved once so bridge calls
+    // skip the FindClass/GetStaticMethodID round trip of JniHelper::getStaticMethodInfo.
+    struct JniMethodRegistry {
+        jclass classRef = nullptr;
+        jmethodID methods[static_cast<size_t>(BridgeMethod::Count)] = {};
+        // Tech3CChannel.onCommands, null with helpers that predate the bridge channel
+        jclass channelClassRef = nullptr;
+        jmethodID onCommands = nullptr;
+
+        bool resolve() {
+            if (classRef) {
+                return true;
+            }
+
+            // Go through JniHelper once so the class is found with the app class loader
+            JniMethodInfo methodInfo;
+            const BridgeMethodSpec& init = BRIDGE_METHODS[static_cast<size_t>(BridgeMethod::Initialize)];
+            if (!JniHelper::getStaticMethodInfo(methodInfo, JAVA_CLASS_NAME, init.name, init.signature)) {
+                return false;
+            }
+
+            JNIEnv* env = methodInfo.env;
+            classRef = static_cast<jclass>(env->NewGlobalRef(methodInfo.classID));
+            env->DeleteLocalRef(methodInfo.classID);
+            methods[static_cast<size_t>(BridgeMethod::Initialize)] = methodInfo.methodID;
+
+            for (size_t i = 1; i < static_cast<size_t>(BridgeMethod::Count); ++i) {
+                methods[i] = env->GetStaticMethodID(classRef, BRIDGE_METHODS[i].name, BRIDGE_METHODS[i].signature);
+                if (env->ExceptionCheck()) {
+                    // Optional methods (e.g. setEnableRequireBOD) may not exist in older helpers
+                    env->ExceptionClear();
+                    methods[i] = nullptr;
+                }
+            }
+
+            JniMethodInfo channelInfo;
+            if (JniHelper::getStaticMethodInfo(channelInfo, JAVA_CHANNEL_CLASS_NAME, "onCommands", "(J)V")) {
+                channelClassRef = static_cast<jclass>(env->NewGlobalRef(channelInfo.classID));
+                env->DeleteLocalRef(channelInfo.classID);
+                onCommands = channelInfo.methodID;
+            }
+            return true;
+        }
+
+        void release() {
+            if (classRef) {
+                JniHelper::getEnv()->DeleteGlobalRef(classRef);
+                classRef = nullptr;
+            }
+            if (channelClassRef) {
+                JniHelper::getEnv()->DeleteGlobalRef(channelClassRef);
+                channelClassRef = nullptr;
+            }
+            onCommands = nullptr;
+            for (auto& method : methods) {
+                method = nullptr;
+            }
+        }
+
+        jmethodID get(BridgeMethod method) const {
+            return methods[static_cast<size_t>(method)];
+        }
+    };
+
+    JniMethodRegistry s_jniRegistry;
+
+    // Tech3CChannel's event positions, looked up once the ring is attached and kept for the
+    // process like the ring itself. Guarded by s_channelReadMutex, which serializes the readers:
+    // the frame drain and Tech3CChannel.flush() from an SDK thread.
+    struct ChannelEventPositions {
+        bool resolved = false;
+        jclass classRef = nullptr;
+        jfieldID tail = nullptr;
+        jfieldID head = nullptr;
+
+        bool resolve(JNIEnv* env) {
+            if (resolved) {
+                return tail != nullptr;
+            }
+            resolved = true;
+            JniMethodInfo methodInfo;
+            if (!JniHelper::getStaticMethodInfo(methodInfo, JAVA_CHANNEL_CLASS_NAME, "flush", "()V")) {
+                return false;
+            }
+            classRef = static_cast<jclass>(env->NewGlobalRef(methodInfo.classID));
+            env->DeleteLocalRef(methodInfo.classID);
+            tail = env->GetStaticFieldID(classRef, "sEventTail", "J");
+            head = env->GetStaticFieldID(classRef, "sEventHead", "J");
+            if (env->ExceptionCheck()) {
+                env->ExceptionClear();
+                tail = nullptr;
+                head = nullptr;
+            }
+            if (!tail || !head) {
+                TECH3C_LOGE("Tech3CChannel has no event positions, its events are not read");
+                tail = nullptr;
+            }
+            return tail != nullptr;
+        }
+    };
+
+    ChannelEventPositions s_channelEvents;
+    std::mutex s_channelReadMutex;
+
+    // Starts a command record in the bridge channel; null when Java has no channel attached or
+    // the record does not fit, the caller then makes the plain JNI call
+    ChannelWriter* beginChannelCommand(ChannelRecord type, size_t payloadBytes) {
+        ChannelWriter& commands = BridgeChannel::getInstance().getCommands();
+        if (!s_jniRegistry.onCommands || !commands.isAttached() || !commands.begin(type, payloadBytes)) {
+            return nullptr;
+        }
+        return &commands;
+    }
+}
+#endif
+
+namespace tech3c {
+
+    std::string loginTypeToString(LoginType type) {
+        switch (type) {
+            case LoginType::GUEST: return "guest";
+            case LoginType::ACCOUNT: return "account";
+            case LoginType::SOCIAL: return "social";
+            default: return "guest";
+        }
+    }
+
+    LoginType stringToLoginType(const std::string& str) {
+        if (str == "guest") return LoginType::GUEST;
+        if (str == "account") return LoginType::ACCOUNT;
+        if (str == "social") return LoginType::SOCIAL;
+        return LoginType::GUEST;
+    }
+
+    std::string languageToString(Language lang) {
+        switch (lang) {
+            case Language::ENGLISH: return "English";
+            case Language::VIETNAMESE: return "Vietnamese";
+            case Language::CHINESE: return "Chinese";
+            case Language::KHMER: return "Khmer";
+            case Language::LAO: return "Lao";
+            case Language::THAI: return "Thai";
+            default: return "English";
+        }
+    }
+
+    std::string uiModeToString(UiMode mode) {
+        switch (mode) {
+            case UiMode::DIALOG: return "Dialog";
+            case UiMode::FULLSCREEN: return "Fullscreen";
+            default: return "Dialog";
+        }
+    }
+
+    uint32_t diffConfig(const Config& from, const Config& to) {
+        uint32_t mask = 0;
+        if (from.debugMode != to.debugMode) mask |= CONFIG_FIELD_DEBUG_MODE;
+        if (from.uiMode != to.uiMode) mask |= CONFIG_FIELD_UI_MODE;
+        if (from.language != to.language) mask |= CONFIG_FIELD_LANGUAGE;
+        if (from.orientation != to.orientation) mask |= CONFIG_FIELD_ORIENTATION;
+        if (from.enableGuestLogin != to.enableGuestLogin) mask |= CONFIG_FIELD_GUEST_LOGIN;
+        if (from.disableExitLogin != to.disableExitLogin) mask |= CONFIG_FIELD_DISABLE_EXIT_LOGIN;
+        if (from.requireOtp != to.requireOtp) mask |= CONFIG_FIELD_REQUIRE_OTP;
+        if (from.enableMaintenanceCheck != to.enableMaintenanceCheck) mask |= CONFIG_FIELD_MAINTENANCE_CHECK;
+        if (from.ipMaintenanceCheck != to.ipMaintenanceCheck) mask |= CONFIG_FIELD_IP_MAINTENANCE_CHECK;
+        if (from.enableRequireBOD != to.enableRequireBOD) mask |= CONFIG_FIELD_REQUIRE_BOD;
+        return mask;
+    }
+
+    std::string joinEndpoints(const std::vector<std::string>& endpoints) {
+        std::string joined;
+        for (const std::string& endpoint : endpoints) {
+            if (!joined.empty()) {
+                joined += ',';
+            }
+            joined += endpoint;
+        }
+        return joined;
+    }
+
+    std::string_view firstEndpoint(std::string_view endpoints) {
+        endpoints = endpoints.substr(0, endpoints.find(','));
+        while (!endpoints.empty() && endpoints.front() == ' ') endpoints.remove_prefix(1);
+        while (!endpoints.empty() && endpoints.back() == ' ') endpoints.remove_suffix(1);
+        return endpoints;
+    }
+
+    std::string orientationModeToString(OrientationMode mode) {
+        switch (mode) {
+            case OrientationMode::AUTO: return "Auto";
+            case OrientationMode::PORTRAIT: return "Portrait";
+            case OrientationMode::LANDSCAPE: return "Landscape";
+            default: return "Auto";
+        }
+    }
+
+    std::string lifecycleStateToString(LifecycleState state) {
+        switch (state) {
+            case LifecycleState::UNINITIALIZED: return "Uninitialized";
+            case LifecycleState::INITIALIZING: return "Initializing";
+            case LifecycleState::READY: return "Ready";
+            case LifecycleState::AUTHENTICATING: return "Authenticating";
+            case LifecycleState::LOGGED_IN: return "LoggedIn";
+            case LifecycleState::SHUTTING_DOWN: return "ShuttingDown";
+            default: return "Uninitialized";
+        }
+    }
+}
+
+// iOS callbacks, defined with the default session in Tech3CManager.cpp
+#if AX_TARGET_PLATFORM == AX_PLATFORM_IOS
+void ios_onLoginSuccess(const char* userId, const char* accessToken, const char* refreshToken, int loginType, long expiryTime);
+void ios_onRegisterSuccess(const char* userId, const char* accessToken, const char* refreshToken, long expiryTime);
+void ios_onError(const char* error);
+void ios_onAuthCancelled();
+void ios_onAuthScreenOpened();
+#endif
+
+//========================================================================
+// Tech3CSession implementation
+
+Tech3CSession::Tech3CSession(const SessionOptions& options)
+        : Tech3CSession(options, false) {
+}
+
+Tech3CSession::Tech3CSession(const SessionOptions& options, bool nativeSdk)
+        : m_host(options.host ? options.host : std::make_shared<SessionHost>())
+        , m_nativeSdk(nativeSdk)
+        , m_dispatchOnFrame(options.dispatchOnFrame)
+        , m_hasPushedConfig(false)
+        , m_unpushedFields(0)
+        , m_configPushSeq(0)
+        , m_configPushFailed(false)
+        , m_state(LifecycleState::UNINITIALIZED)
+        , m_generation(1)
+        , m_initErrorReported(false)
+        , m_loggedIn(false)
+        , m_sessionStore(options.persistSession ? new SessionStore(options.sessionFile) : nullptr)
+        , m_refreshMarginMs(DEFAULT_REFRESH_MARGIN_MS)
+        , m_refreshScheduler(m_host->getRefreshTimer())
+        , m_refreshRunning(false)
+        , m_retryPolicy(options.retryPolicy)
+        , m_refreshFailures(0)
+        , m_refreshRetryAt(0)
+        , m_nextOperationId(1)
+        , m_eventQueue(eventQueueCapacityFor(options.eventQueueCapacity))
+        , m_droppedEvents(0)
+        , m_dispatchBudgetUs(DEFAULT_DISPATCH_BUDGET_US)
+        , m_drainScheduled(false)
+        , m_worker("tech3c bridge", m_host->getWorkerPool())
+        , m_mutex(m_metrics) {
+    TECH3C_LOGD("Tech3CSession created");
+}
+
+Tech3CSession::~Tech3CSession() {
+    cleanup();
+    TECH3C_LOGD("Tech3CSession destroyed");
+}
+
+bool Tech3CSession::initialize(const std::string& clientId, const std::string& clientSecret) {
+    TECH3C_TRACE_SCOPE("sdk", "Tech3CSession::initialize");
+    std::unique_lock<ProfiledMutex> lock(m_mutex);
+
+    if (isInitialized()) {
+        TECH3C_LOGD("Tech3CSession already initialized");
+        return true;
+    }
+
+    if (clientId.empty() || clientSecret.empty()) {
+        TECH3C_LOGE("Client ID or Client Secret is empty");
+        return false;
+    }
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID || AX_TARGET_PLATFORM == AX_PLATFORM_IOS
+    // The native SDK is process wide and reports to Tech3CManager only
+    if (!m_nativeSdk) {
+        TECH3C_LOGE("Only the default session can drive the native Tech3C SDK");
+        return false;
+    }
+#endif
+
+    // Fails while cleanup() is tearing the SDK down
+    if (!transitionState(lifecycleStateBit(LifecycleState::UNINITIALIZED), LifecycleState::INITIALIZING)) {
+        TECH3C_LOGE("Cannot initialize while {}", lifecycleStateToString(getLifecycleState()));
+        return false;
+    }
+    // Back to UNINITIALIZED on every failure return below
+    struct InitializingGuard {
+        Tech3CSession* manager;
+        ~InitializingGuard() {
+            manager->transitionState(lifecycleStateBit(LifecycleState::INITIALIZING), LifecycleState::UNINITIALIZED);
+        }
+    } initializingGuard{this};
+
+    m_config.clientId = clientId;
+    m_config.clientSecret = clientSecret;
+
+    TECH3C_LOGD("Initializing Tech3C SDK with clientId: {}", clientId);
+    ScopedLatency timer(m_metrics, MetricOperation::INITIALIZE);
+
+    // Deliver SDK callbacks, including errors raised while initializing
+    scheduleEventDrain();
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID
+    if (!s_jniRegistry.resolve()) {
+        TECH3C_LOGE("Failed to find initialize method in Java class");
+        m_metrics.recordFailure(MetricOperation::INITIALIZE);
+        return false;
+    }
+
+    // Tech3CHelper.initialize reports its failures (no context, bad credentials, SDK exceptions)
+    // through nativeOnError on this thread and returns normally
+    m_initErrorReported.store(false, std::memory_order_relaxed);
+    JNIEnv* env = JniHelper::getEnv();
+    jstring jClientId = env->NewStringUTF(clientId.c_str());
+    jstring jClientSecret = env->NewStringUTF(clientSecret.c_str());
+
+    env->CallStaticVoidMethod(s_jniRegistry.classRef, s_jniRegistry.get(BridgeMethod::Initialize), jClientId, jClientSecret);
+
+    env->DeleteLocalRef(jClientId);
+    env->DeleteLocalRef(jClientSecret);
+
+    // Check for Java exceptions
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        TECH3C_LOGE("Java exception occurred during initialization");
+        m_metrics.recordFailure(MetricOperation::INITIALIZE);
+        return false;
+    }
+    if (m_initErrorReported.load(std::memory_order_relaxed)) {
+        TECH3C_LOGE("Tech3C SDK reported an error during initialization");
+        m_metrics.recordFailure(MetricOperation::INITIALIZE);
+        return false;
+    }
+
+    TECH3C_LOGD("Tech3C SDK initialized successfully");
+    return finishInitializeLocked();
+#elif AX_TARGET_PLATFORM == AX_PLATFORM_IOS
+    // iOS implementation
+    TECH3C_TRACE_SCOPE("bridge", "tech3c_ios_initialize");
+    bool success = tech3c_ios_initialize(clientId.c_str(), clientSecret.c_str());
+    
+    if (success) {
+        // Set up callbacks
+        tech3c_ios_setLoginSuccessCallback(ios_onLoginSuccess);
+        tech3c_ios_setRegisterSuccessCallback(ios_onRegisterSuccess);
+        tech3c_ios_setErrorCallback(ios_onError);
+        tech3c_ios_setCancelCallback(ios_onAuthCancelled);
+        tech3c_ios_setAuthScreenOpenedCallback(ios_onAuthScreenOpened);
+        
+        TECH3C_LOGD("Tech3C SDK initialized successfully on iOS");
+        return finishInitializeLocked();
+    } else {
+        TECH3C_LOGE("Failed to initialize Tech3C SDK on iOS");
+        m_metrics.recordFailure(MetricOperation::INITIALIZE);
+        return false;
+    }
+#elif TECH3C_DESKTOP_BACKEND
+    if (!m_desktopBackend) {
+        m_desktopBackend.reset(new DesktopBackend(this, *m_host));
+    }
+    m_desktopBackend->setRetryPolicy(m_retryPolicy);
+
+    // Connecting and the init request, retries and their backoff included, run without m_mutex
+    // so backend callbacks, logout() and token refreshes are not held up; INITIALIZING keeps
+    // other initialize() calls out, and a cleanup() meanwhile makes finishInitializeLocked() fail
+    DesktopBackend* backend = m_desktopBackend.get();
+    std::string error;
+    lock.unlock();
+    const bool connected = backend->initialize(clientId, clientSecret, error);
+    lock.lock();
+    if (!connected) {
+        TECH3C_LOGE("Failed to initialize Tech3C desktop backend: {}", error);
+        m_metrics.recordFailure(MetricOperation::INITIALIZE);
+        return false;
+    }
+
+    TECH3C_LOGD("Tech3C SDK initialized with desktop backend at {}", m_desktopBackend->getServerUrl());
+    return finishInitializeLocked();
+#else
+    // For other platforms, just mark as initialized for testing
+    TECH3C_LOGD("Tech3C SDK initialized (non-Android/iOS platform)");
+    return finishInitializeLocked();
+#endif
+}
+
+void Tech3CSession::cleanup() {
+    // From here on SDK callbacks are dropped and showAuth() / logout() are rejected; whatever is
+    // already queued belongs to the old generation and is never dispatched
+    const LifecycleState previous = m_state.exchange(LifecycleState::SHUTTING_DOWN, std::memory_order_acq_rel);
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+
+    // Let awaiting coroutines finish before anything goes away, they may call back into the manager
+    completeInitOperations(ErrorInfo(ERROR_OPERATION_CANCELLED, "Tech3C SDK cleaned up"));
+    completeAuthOperations(ErrorInfo(ERROR_OPERATION_CANCELLED, "Tech3C SDK cleaned up"));
+    completeLogoutOperations(ErrorInfo(ERROR_OPERATION_CANCELLED, "Tech3C SDK cleaned up"));
+
+    // Like the backend thread below, a running refresh needs m_mutex to finish
+    m_refreshScheduler.stop();
+    {
+        // A refresh cancelled before it started would leave its waiters blocked for good
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        completeTokenWaitersLocked(ErrorInfo(ERROR_OPERATION_CANCELLED, "Tech3C SDK cleaned up"));
+    }
+
+    // Makes the queued bridge calls first, a final logout still reaches the SDK
+    m_worker.stop();
+
+#if TECH3C_DESKTOP_BACKEND
+    // Stop the backend thread before taking m_mutex, it may be delivering a callback
+    if (m_desktopBackend) {
+        m_desktopBackend->shutdown();
+    }
+#endif
+
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+
+    // Stop the per-frame drain even if initialize() failed half way
+    unscheduleEventDrain();
+
+    if (previous == LifecycleState::UNINITIALIZED || previous == LifecycleState::SHUTTING_DOWN) {
+        m_state.store(LifecycleState::UNINITIALIZED, std::memory_order_release);
+        return;
+    }
+
+    // Clear user data
+    m_currentUser.clear();
+    publishUserLocked();
+
+    // Clear callbacks
+    m_loginSuccessCallback = nullptr;
+    m_registerSuccessCallback = nullptr;
+    m_errorCallback = nullptr;
+    m_cancelCallback = nullptr;
+    m_authScreenOpenedCallback = nullptr;
+    m_tokenRefreshedCallback = nullptr;
+
+    // Queued events stay put: only the dispatching thread may pop the ring, and it drops them as
+    // stale since the generation moved on
+
+    m_hasPushedConfig = false;
+    m_unpushedFields = 0;
+    m_configPushFailed.store(false, std::memory_order_relaxed);
+    
+#if AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID
+    if (m_nativeSdk) {
+        s_jniRegistry.release();
+    }
+#elif AX_TARGET_PLATFORM == AX_PLATFORM_IOS
+    if (m_nativeSdk) {
+        tech3c_ios_cleanup();
+    }
+#endif
+
+    m_state.store(LifecycleState::UNINITIALIZED, std::memory_order_release);
+    TECH3C_LOGD("Tech3CSession cleaned up");
+}
+
+bool Tech3CSession::finishInitializeLocked() {
+    // cleanup() may have started meanwhile, it tears down what was just set up
+    if (!transitionState(lifecycleStateBit(LifecycleState::INITIALIZING), settledState())) {
+        return false;
+    }
+    pushConfigLocked();
+    scheduleTokenRefreshLocked();
+    return true;
+}
+
+bool Tech3CSession::transitionState(uint32_t from, LifecycleState to) {
+    LifecycleState current = m_state.load(std::memory_order_acquire);
+    do {
+        if (!(lifecycleStateBit(current) & from)) {
+            return false;
+        }
+    } while (!m_state.compare_exchange_weak(current, to, std::memory_order_acq_rel, std::memory_order_acquire));
+    return true;
+}
+
+LifecycleState Tech3CSession::settledState() const {
+    return m_loggedIn.load(std::memory_order_acquire) ? LifecycleState::LOGGED_IN : LifecycleState::READY;
+}
+
+void Tech3CSession::applyConfig(const Config& config) {
+    TECH3C_TRACE_SCOPE("sdk", "Tech3CSession::applyConfig");
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+
+    // Credentials are owned by initialize(), everything else is taken from config
+    std::string clientId = m_config.clientId;
+    std::string clientSecret = m_config.clientSecret;
+    m_config = config;
+    m_config.clientId = clientId;
+    m_config.clientSecret = clientSecret;
+    applyLogLevelLocked();
+
+    TECH3C_LOGD("Config applied");
+    pushConfigLocked();
+}
+
+void Tech3CSession::setDebugMode(bool debug) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_config.debugMode = debug;
+    applyLogLevelLocked();
+    TECH3C_LOGD("Debug mode set to: {}", debug);
+    pushConfigLocked();
+}
+
+void Tech3CSession::applyLogLevelLocked() {
+    if (m_nativeSdk) {
+        setLogLevel(m_config.debugMode ? LogLevel::Debug : LogLevel::Warn);
+    }
+}
+
+void Tech3CSession::setUiMode(UiMode mode) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_config.uiMode = mode;
+    TECH3C_LOGD("UI mode set to: {}", uiModeToString(mode));
+    pushConfigLocked();
+}
+
+void Tech3CSession::setLanguage(Language language) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_config.language = language;
+    TECH3C_LOGD("Language set to: {}", languageToString(language));
+    pushConfigLocked();
+}
+
+void Tech3CSession::setOrientation(OrientationMode orientation) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_config.orientation = orientation;
+    TECH3C_LOGD("Orientation set to: {}", orientationModeToString(orientation));
+    pushConfigLocked();
+}
+
+void Tech3CSession::setIpMaintenanceCheck(const std::string& ip) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_config.ipMaintenanceCheck = ip;
+    TECH3C_LOGD("Setting IP maintenance check to: {}", ip.empty() ? "empty" : ip.c_str());
+    pushConfigLocked();
+}
+
+void Tech3CSession::setMaintenanceEndpoints(const std::vector<std::string>& endpoints) {
+    setIpMaintenanceCheck(joinEndpoints(endpoints));
+}
+
+void Tech3CSession::setEnableGuestLogin(bool enable) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_config.enableGuestLogin = enable;
+    TECH3C_LOGD("Guest login enabled: {}", enable);
+    pushConfigLocked();
+}
+
+void Tech3CSession::setDisableExitLogin(bool disable) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_config.disableExitLogin = disable;
+    TECH3C_LOGD("Exit login disabled: {}", disable);
+    pushConfigLocked();
+}
+
+void Tech3CSession::setRequireOtp(bool require) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_config.requireOtp = require;
+    TECH3C_LOGD("Require OTP: {}", require);
+    pushConfigLocked();
+}
+
+void Tech3CSession::setEnableMaintenanceCheck(bool enable) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_config.enableMaintenanceCheck = enable;
+    TECH3C_LOGD("Maintenance check enabled: {}", enable);
+    pushConfigLocked();
+}
+
+void Tech3CSession::setEnableRequireBOD(bool enable) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_config.enableRequireBOD = enable;
+    TECH3C_LOGD("Enable Require BOD: {}", enable);
+    pushConfigLocked();
+}
+
+void Tech3CSession::pushConfigLocked() {
+    // Before initialize() the values are only buffered in m_config; initialize() pushes them
+    if (!isInitialized()) {
+        return;
+    }
+
+    uint32_t mask = CONFIG_FIELD_ALL;
+    if (m_hasPushedConfig) {
+        // Fields still in flight go again: an earlier push may yet fail, or a field set and then
+        // set back would otherwise be left at the value in flight
+        mask = diffConfig(m_pushedConfig, m_config) | m_unpushedFields;
+    } else if (m_config.ipMaintenanceCheck.empty()) {
+        // Keep the SDK's own server IP until the game sets one
+        mask &= ~CONFIG_FIELD_IP_MAINTENANCE_CHECK;
+    }
+    if (mask == 0) {
+        return;
+    }
+
+    TECH3C_LOGD("Pushing config fields: {:#x}", mask);
+    m_unpushedFields |= mask;
+    const uint64_t seq = ++m_configPushSeq;
+    m_worker.post([this, mask, seq, config = m_config]() {
+        const bool sent = sendConfig(mask, config);
+
+        // Pushes run in order, so a successful one leaves the SDK with its whole snapshot; a
+        // failed one leaves its fields unconfirmed for the next push to send
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        if (!isInitialized()) {
+            return;
+        }
+        if (!sent) {
+            TECH3C_LOGW("Config push failed, fields {:#x} go again before the auth screen opens", mask);
+            m_configPushFailed.store(true, std::memory_order_relaxed);
+            return;
+        }
+        m_pushedConfig = config;
+        m_hasPushedConfig = true;
+        if (seq == m_configPushSeq) {
+            m_unpushedFields = 0;
+            m_configPushFailed.store(false, std::memory_order_relaxed);
+        }
+    });
+}
+
+bool Tech3CSession::sendConfig(uint32_t mask, const Config& config) {
+    TECH3C_TRACE_SCOPE("bridge", "pushConfig");
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID
+    // The SDK checks a single server
+    const std::string ip(firstEndpoint(config.ipMaintenanceCheck));
+    if (ChannelWriter* commands = beginChannelCommand(ChannelRecord::APPLY_CONFIG,
+                                                      10 * CHANNEL_LONG_BYTES + channelStringBytes(ip))) {
+        commands->putLong(mask);
+        commands->putLong(config.debugMode);
+        commands->putLong((int64_t)config.uiMode);
+        commands->putLong((int64_t)config.language);
+        commands->putLong((int64_t)config.orientation);
+        commands->putLong(config.enableGuestLogin);
+        commands->putLong(config.disableExitLogin);
+        commands->putLong(config.requireOtp);
+        commands->putLong(config.enableMaintenanceCheck);
+        commands->putString(ip);
+        commands->putLong(config.enableRequireBOD);
+        return sendChannelCommand(BridgeMethod::ApplyConfig);
+    }
+
+    JNIEnv* env = JniHelper::getEnv();
+    jstring jIp = env->NewStringUTF(ip.c_str());
+
+    bool sent = true;
+    if (s_jniRegistry.get(BridgeMethod::ApplyConfig)) {
+        sent = callJavaMethod(BridgeMethod::ApplyConfig, (jint)mask,
+                       (jboolean)config.debugMode, (jint)config.uiMode, (jint)config.language,
+                       (jint)config.orientation, (jboolean)config.enableGuestLogin,
+                       (jboolean)config.disableExitLogin, (jboolean)config.requireOtp,
+                       (jboolean)config.enableMaintenanceCheck, jIp, (jboolean)config.enableRequireBOD);
+    } else {
+        // Older Tech3CHelper without applyConfig, fall back to one call per changed field
+        if (mask & CONFIG_FIELD_DEBUG_MODE) sent &= callJavaMethod(BridgeMethod::SetDebugMode, (jboolean)config.debugMode);
+        if (mask & CONFIG_FIELD_UI_MODE) sent &= callJavaMethod(BridgeMethod::SetUiMode, (jint)config.uiMode);
+        if (mask & CONFIG_FIELD_LANGUAGE) sent &= callJavaMethod(BridgeMethod::SetLanguage, (jint)config.language);
+        if (mask & CONFIG_FIELD_ORIENTATION) sent &= callJavaMethod(BridgeMethod::SetOrientation, (jint)config.orientation);
+        if (mask & CONFIG_FIELD_GUEST_LOGIN) sent &= callJavaMethod(BridgeMethod::SetEnableGuestLogin, (jboolean)config.enableGuestLogin);
+        if (mask & CONFIG_FIELD_DISABLE_EXIT_LOGIN) sent &= callJavaMethod(BridgeMethod::SetDisableExitLogin, (jboolean)config.disableExitLogin);
+        if (mask & CONFIG_FIELD_REQUIRE_OTP) sent &= callJavaMethod(BridgeMethod::SetRequireOtp, (jboolean)config.requireOtp);
+        if (mask & CONFIG_FIELD_MAINTENANCE_CHECK) sent &= callJavaMethod(BridgeMethod::SetEnableMaintenanceCheck, (jboolean)config.enableMaintenanceCheck);
+        if (mask & CONFIG_FIELD_IP_MAINTENANCE_CHECK) sent &= callJavaMethod(BridgeMethod::SetIpMaintenanceCheck, jIp);
+        // Optional, helpers older than setEnableRequireBOD leave the SDK default
+        if ((mask & CONFIG_FIELD_REQUIRE_BOD) && s_jniRegistry.get(BridgeMethod::SetEnableRequireBOD)) {
+            sent &= callJavaMethod(BridgeMethod::SetEnableRequireBOD, (jboolean)config.enableRequireBOD);
+        }
+    }
+
+    env->DeleteLocalRef(jIp);
+    return sent;
+#elif AX_TARGET_PLATFORM == AX_PLATFORM_IOS
+    tech3c_ios_config iosConfig;
+    iosConfig.mask = mask;
+    iosConfig.debugMode = config.debugMode;
+    iosConfig.uiMode = (int)config.uiMode;
+    iosConfig.language = (int)config.language;
+    iosConfig.orientation = (int)config.orientation;
+    iosConfig.enableGuestLogin = config.enableGuestLogin;
+    iosConfig.disableExitLogin = config.disableExitLogin;
+    iosConfig.requireOtp = config.requireOtp;
+    iosConfig.enableMaintenanceCheck = config.enableMaintenanceCheck;
+    const std::string ip(firstEndpoint(config.ipMaintenanceCheck));
+    iosConfig.ipMaintenanceCheck = ip.c_str();
+    iosConfig.enableRequireBOD = config.enableRequireBOD;
+    tech3c_ios_applyConfig(&iosConfig);
+    return true;
+#elif TECH3C_DESKTOP_BACKEND
+    m_desktopBackend->applyConfig(config);
+    return true;
+#else
+    // Sending it again could not help, the push counts as done
+    if ((mask & CONFIG_FIELD_IP_MAINTENANCE_CHECK) && !config.ipMaintenanceCheck.empty()) {
+        TECH3C_LOGE("setIpMaintenanceCheck not supported on this platform");
+        postEvent(SdkEvent(ErrorInfo(1024, "Platform not supported for IP maintenance check")));
+    }
+    return true;
+#endif
+}
+
+void Tech3CSession::showAuth() {
+    TECH3C_TRACE_SCOPE("sdk", "Tech3CSession::showAuth");
+    // Showing the screen again while it is open is allowed, the SDK brings it to the front
+    if (!transitionState(INITIALIZED_STATES, LifecycleState::AUTHENTICATING)) {
+        TECH3C_LOGE("SDK not initialized");
+        postEvent(SdkEvent(ErrorInfo(1001, "SDK not initialized")));
+        return;
+    }
+
+    TECH3C_LOGD("Showing authentication screen");
+    m_metrics.authStarted();
+
+    // A failed config push would otherwise wait for the next setter; queued ahead of the screen
+    if (m_configPushFailed.load(std::memory_order_relaxed)) {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        pushConfigLocked();
+    }
+
+    m_worker.post([this]() {
+#if AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID
+        if (beginChannelCommand(ChannelRecord::SHOW_AUTH, 0)) {
+            sendChannelCommand(BridgeMethod::ShowAuth);
+        } else {
+            callJavaMethod(BridgeMethod::ShowAuth);
+        }
+#elif AX_TARGET_PLATFORM == AX_PLATFORM_IOS
+        TECH3C_TRACE_SCOPE("bridge", "tech3c_ios_showAuth");
+        tech3c_ios_showAuth();
+#elif TECH3C_DESKTOP_BACKEND
+        m_desktopBackend->showAuth();
+#endif
+    });
+}
+
+bool Tech3CSession::restoreSession() {
+    TECH3C_TRACE_SCOPE("sdk", "Tech3CSession::restoreSession");
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+
+    UserInfo user;
+    if (!m_sessionStore || !m_sessionStore->load(user) || !user.isValid()) {
+        return false;
+    }
+
+    const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    if (user.expiryTime <= now) {
+        TECH3C_LOGD("Saved session for {} has expired", user.getUserId());
+        return false;
+    }
+
+    m_currentUser = user;
+    publishUserLocked();
+    // Restoring after initialize() skips the auth screen the same way a login would
+    transitionState(lifecycleStateBit(LifecycleState::READY), LifecycleState::LOGGED_IN);
+    TECH3C_LOGD("Session restored for user: {}", m_currentUser.getUserId());
+    scheduleTokenRefreshLocked();
+    return true;
+}
+
+void Tech3CSession::setTokenRefreshMargin(std::chrono::seconds margin) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_refreshMarginMs = std::chrono::duration_cast<std::chrono::milliseconds>(margin).count();
+    scheduleTokenRefreshLocked();
+}
+
+void Tech3CSession::setTokenRefreshHandler(TokenRefreshHandler handler) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_refreshHandler = handler;
+    scheduleTokenRefreshLocked();
+}
+
+void Tech3CSession::setRetryPolicy(const RetryPolicy& policy) {
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_retryPolicy = policy;
+#if TECH3C_DESKTOP_BACKEND
+    if (m_desktopBackend) {
+        m_desktopBackend->setRetryPolicy(policy);
+    }
+#endif
+}
+
+void Tech3CSession::reportServerTime(int64_t serverTimeMs, int64_t requestSentMs, int64_t responseReceivedMs) {
+    m_clockSkew.addSample(serverTimeMs, requestSentMs, responseReceivedMs);
+}
+
+TokenFuture Tech3CSession::acquireToken(std::chrono::seconds minValidity) {
+    const int64_t minValidityMs = std::chrono::duration_cast<std::chrono::milliseconds>(minValidity).count();
+
+    // Callers holding a good token share one ready future per snapshot
+    UserSnapshot user = m_userSnapshot.load();
+    if (user->isValid() && isTokenValid(*user, minValidityMs)) {
+        std::shared_ptr<const ReadyToken> ready = m_readyToken.load();
+        if (ready->user != user) {
+            // First caller since the token changed; racing ones build the same result, either
+            // will do, so none of them waits for another to publish
+            ready = std::make_shared<const ReadyToken>(ReadyToken{ user, readyToken(user) });
+            m_readyToken.tryStore(ready);
+        }
+        return ready->future;
+    }
+
+    TECH3C_TRACE_SCOPE("sdk", "Tech3CSession::acquireToken");
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+
+    if (!m_currentUser.isValid()) {
+        return readyToken(ErrorInfo(ERROR_NOT_LOGGED_IN, "Not logged in"));
+    }
+    // Refreshed while this caller waited for the lock
+    user = m_userSnapshot.load();
+    if (isTokenValid(*user, minValidityMs)) {
+        return readyToken(user);
+    }
+    if (m_tokenFuture.valid()) {
+        return m_tokenFuture;
+    }
+    if (!canRefreshLocked()) {
+        // Nothing can renew it; a token that has not expired yet still beats none
+        return isTokenValid(*user, 0)
+                ? readyToken(user)
+                : readyToken(ErrorInfo(2001, "Token refresh failed", "no token refresh handler"));
+    }
+    // The backend is failing; waiting would only park the caller until the breaker's next trial
+    CircuitBreaker* breaker = refreshBreakerLocked();
+    const int64_t retryAfterMs = breaker ? breaker->getRetryAfter().count() : 0;
+    if (retryAfterMs > 0) {
+        return isTokenValid(*user, 0)
+                ? readyToken(user)
+                : readyToken(ErrorInfo(ERROR_CIRCUIT_OPEN, "Token refresh unavailable",
+                                       "retry in " + std::to_string(retryAfterMs) + " ms"));
+    }
+
+    m_tokenPromise = std::promise<AsyncResult<UserSnapshot>>();
+    m_tokenFuture = m_tokenPromise.get_future().share();
+    // A running refresh completes the new waiters too; otherwise pull the scheduled one forward
+    if (!m_refreshRunning) {
+        scheduleTokenRefreshLocked();
+    }
+    return m_tokenFuture;
+}
+
+bool Tech3CSession::canRefreshLocked() const {
+    bool canRefresh = m_refreshHandler != nullptr;
+#if TECH3C_DESKTOP_BACKEND
+    canRefresh = true;
+#endif
+    return canRefresh && m_currentUser.isValid() && !m_currentUser.refreshToken.empty()
+           && m_currentUser.expiryTime > 0;
+}
+
+CircuitBreaker* Tech3CSession::refreshBreakerLocked() {
+    if (m_refreshHandler) {
+        return &m_host->getCircuitBreakers().get(REFRESH_HANDLER_ENDPOINT);
+    }
+#if TECH3C_DESKTOP_BACKEND
+    if (m_desktopBackend && isInitialized()) {
+        return m_desktopBackend->getCircuitBreaker();
+    }
+#endif
+    return nullptr;
+}
+
+bool Tech3CSession::isTokenValid(const UserInfo& user, int64_t minValidityMs) const {
+    return user.expiryTime <= 0 || m_clockSkew.toDeviceTime(user.expiryTime) - deviceTimeMs() >= minValidityMs;
+}
+
+void Tech3CSession::completeTokenWaitersLocked(const AsyncResult<UserSnapshot>& result) {
+    if (!m_tokenFuture.valid()) {
+        return;
+    }
+    // Waiters only block on the shared state, nothing runs here
+    m_tokenPromise.set_value(result);
+    m_tokenFuture = TokenFuture();
+}
+
+void Tech3CSession::scheduleTokenRefreshLocked() {
+    if (!canRefreshLocked()) {
+        m_refreshScheduler.cancel();
+        completeTokenWaitersLocked(m_currentUser.isValid()
+                ? AsyncResult<UserSnapshot>(ErrorInfo(2001, "Token refresh failed", "no token refresh handler"))
+                : AsyncResult<UserSnapshot>(ErrorInfo(ERROR_NOT_LOGGED_IN, "Not logged in")));
+        return;
+    }
+
+    // expiryTime is on the server clock; never wait past half of what is left, so short lived
+    // tokens are not refreshed in a tight loop either
+    const int64_t now = deviceTimeMs();
+    const int64_t expiry = m_clockSkew.toDeviceTime(m_currentUser.expiryTime);
+    const int64_t margin = std::min(m_refreshMarginMs, std::max<int64_t>((expiry - now) / 2, 0));
+    // Waiters pull the refresh forward, but never into the backoff of one that just failed
+    const int64_t due = m_tokenFuture.valid() && !m_refreshRunning ? now : expiry - margin;
+    const int64_t deadline = std::max({ now, due, m_refreshRetryAt });
+
+    TECH3C_LOGD("Token refresh scheduled in {} ms", deadline - now);
+    m_refreshScheduler.scheduleAt(deadline, [this]() { refreshTokens(); });
+}
+
+void Tech3CSession::refreshTokens() {
+    TECH3C_TRACE_SCOPE("sdk", "Tech3CSession::refreshTokens");
+    UserInfo user;
+    TokenRefreshHandler handler;
+    CircuitBreaker* handlerBreaker = nullptr;
+#if TECH3C_DESKTOP_BACKEND
+    DesktopBackend* backend = nullptr;
+#endif
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        user = m_currentUser;
+        handler = m_refreshHandler;
+        handlerBreaker = handler ? refreshBreakerLocked() : nullptr;
+#if TECH3C_DESKTOP_BACKEND
+        // cleanup() stops this thread before it resets anything, the pointer stays valid
+        backend = isInitialized() ? m_desktopBackend.get() : nullptr;
+#endif
+        if (!user.isValid()) {
+            completeTokenWaitersLocked(ErrorInfo(ERROR_NOT_LOGGED_IN, "Not logged in"));
+            return;
+        }
+        // acquireToken() callers arriving from here on wait for this refresh instead of starting one
+        m_refreshRunning = true;
+    }
+
+    // The handler may block on the network, nothing is locked while it runs
+    const int64_t sentAt = deviceTimeMs();
+    const uint64_t startUs = Metrics::nowUs();
+    TokenRefreshResult result;
+    if (handler) {
+        if (handlerBreaker->allowRequest()) {
+            result = handler(user);
+            // A handler turning the token down still reached a healthy backend
+            if (result.success || !result.retryable) {
+                handlerBreaker->recordSuccess();
+            } else {
+                handlerBreaker->recordFailure();
+            }
+        } else {
+            result.retryAfterMs = handlerBreaker->getRetryAfter().count();
+            result.error = "refresh backend unavailable, retry in " + std::to_string(result.retryAfterMs) + " ms";
+        }
+#if TECH3C_DESKTOP_BACKEND
+    } else if (backend) {
+        result = backend->refreshTokens(user.refreshToken);
+#endif
+    } else {
+        result.error = "SDK not initialized";
+    }
+    const int64_t receivedAt = deviceTimeMs();
+    m_metrics.recordLatency(MetricOperation::TOKEN_REFRESH, Metrics::nowUs() - startUs);
+    if (result.serverTime > 0) {
+        m_clockSkew.addSample(result.serverTime, sentAt, receivedAt);
+    }
+
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+    m_refreshRunning = false;
+
+    // Logged out or logged in again meanwhile, the result belongs to a session that is gone; the
+    // new login's token is fresh, so waiters get that instead
+    if (m_currentUser.userId != user.userId || m_currentUser.refreshToken != user.refreshToken) {
+        completeTokenWaitersLocked(m_currentUser.isValid()
+                ? AsyncResult<UserSnapshot>(m_userSnapshot.load())
+                : AsyncResult<UserSnapshot>(ErrorInfo(ERROR_NOT_LOGGED_IN, "Not logged in")));
+        return;
+    }
+
+    if (result.success && (result.accessToken.size() > m_currentUser.accessToken.capacity()
+                           || result.refreshToken.size() > m_currentUser.refreshToken.capacity())) {
+        result.success = false;
+        result.error = "refreshed token exceeds UserInfo capacity";
+    }
+    if (!result.success || result.accessToken.empty()) {
+        TECH3C_LOGE("Token refresh failed: {}", result.error);
+        const ErrorInfo error = result.retryAfterMs > 0
+                ? ErrorInfo(ERROR_CIRCUIT_OPEN, "Token refresh unavailable", result.error)
+                : ErrorInfo(2001, "Token refresh failed", result.error);
+        m_metrics.recordFailure(MetricOperation::TOKEN_REFRESH);
+        postEvent(SdkEvent(error, EventType::TOKEN_REFRESH_FAILED));
+        completeTokenWaitersLocked(error);
+        if (!result.retryable) {
+            m_refreshScheduler.cancel();
+            return;
+        }
+
+        // Keep trying while the current token is still good, backing off; no sooner than the
+        // breaker's next trial (this failure may just have opened it), earlier attempts would
+        // only fail fast again
+        ++m_refreshFailures;
+        CircuitBreaker* breaker = refreshBreakerLocked();
+        const int64_t retryAfterMs = breaker ? breaker->getRetryAfter().count() : result.retryAfterMs;
+        const int64_t delay = std::max<int64_t>(m_retryPolicy.delayBefore(m_refreshFailures).count(), retryAfterMs);
+        m_refreshRetryAt = receivedAt + delay;
+        if (m_clockSkew.toDeviceTime(m_currentUser.expiryTime) > m_refreshRetryAt) {
+            m_refreshScheduler.scheduleAt(m_refreshRetryAt, [this]() { refreshTokens(); });
+        }
+        return;
+    }
+
+    UserInfo previous = m_currentUser;
+    m_currentUser.accessToken.assign(result.accessToken);
+    if (!result.refreshToken.empty()) {
+        m_currentUser.refreshToken.assign(result.refreshToken);
+    }
+    m_currentUser.expiryTime = result.expiryTime;
+    publishUserLocked();
+    TECH3C_LOGD("Access token refreshed for user: {}", m_currentUser.getUserId());
+    completeTokenWaitersLocked(m_userSnapshot.load());
+
+    saveSessionLocked(previous);
+    scheduleTokenRefreshLocked();
+    postEvent(SdkEvent(EventType::TOKEN_REFRESHED, m_userSnapshot.load()));
+}
+
+void Tech3CSession::publishUserLocked() {
+    // A new token starts the refresh backoff over
+    m_refreshFailures = 0;
+    m_refreshRetryAt = 0;
+    // Readers keep whichever snapshot they already loaded; this one is never modified again
+    m_userSnapshot.store(std::make_shared<const UserInfo>(m_currentUser));
+    m_loggedIn.store(m_currentUser.isValid(), std::memory_order_release);
+}
+
+void Tech3CSession::saveSessionLocked(const UserInfo& previous) {
+    if (!m_sessionStore) {
+        return;
+    }
+
+    // SDKs re-deliver the same login on resume, only touch the disk when something changed
+    if (previous.userId == m_currentUser.userId && previous.accessToken == m_currentUser.accessToken
+        && previous.refreshToken == m_currentUser.refreshToken && previous.loginType == m_currentUser.loginType
+        && previous.expiryTime == m_currentUser.expiryTime) {
+        return;
+    }
+
+    if (!m_sessionStore->save(m_currentUser)) {
+        TECH3C_LOGE("Failed to save session to {}", m_sessionStore->getPath());
+    }
+}
+
+AsyncOperation<Done> Tech3CSession::logout() {
+    TECH3C_TRACE_SCOPE("sdk", "Tech3CSession::logout");
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+
+    // A rejected logout leaves the user and the saved session alone
+    if (!transitionState(INITIALIZED_STATES, LifecycleState::READY)) {
+        TECH3C_LOGE("SDK not initialized");
+        postEvent(SdkEvent(ErrorInfo(1001, "SDK not initialized")));
+        return AsyncOperation<Done>::completed(ErrorInfo(1001, "SDK not initialized"));
+    }
+
+    TECH3C_LOGD("User logged out");
+    m_currentUser.clear();
+    publishUserLocked();
+    if (m_sessionStore) {
+        m_sessionStore->clear();
+    }
+    m_refreshScheduler.cancel();
+    completeTokenWaitersLocked(ErrorInfo(ERROR_NOT_LOGGED_IN, "Logged out"));
+
+    auto state = std::make_shared<detail::OperationState<Done>>();
+    state->id = m_nextOperationId.fetch_add(1, std::memory_order_relaxed);
+    m_pendingLogout.push_back(state);
+
+    const uint64_t operationId = state->id;
+    const uint64_t startUs = Metrics::nowUs();
+    m_worker.post([this, operationId, startUs]() {
+        SdkEvent event(EventType::LOGOUT_COMPLETED, operationId);
+#if AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID
+        const bool sent = beginChannelCommand(ChannelRecord::LOGOUT, 0)
+                ? sendChannelCommand(BridgeMethod::Logout)
+                : callJavaMethod(BridgeMethod::Logout);
+        if (!sent) {
+            m_metrics.recordFailure(MetricOperation::LOGOUT);
+            event.error = ErrorInfo(1020, "Failed to logout");
+        }
+#elif AX_TARGET_PLATFORM == AX_PLATFORM_IOS
+        TECH3C_TRACE_SCOPE("bridge", "tech3c_ios_logout");
+        tech3c_ios_logout();
+#elif TECH3C_DESKTOP_BACKEND
+        m_desktopBackend->logout();
+#endif
+        m_metrics.recordLatency(MetricOperation::LOGOUT, Metrics::nowUs() - startUs);
+        postEvent(std::move(event));
+    });
+    return AsyncOperation<Done>(state);
+}
+
+AsyncOperation<Done> Tech3CSession::initializeAsync(const std::string& clientId, const std::string& clientSecret) {
+#if AX_TARGET_PLATFORM == AX_PLATFORM_IOS
+    if (!initialize(clientId, clientSecret)) {
+        return AsyncOperation<Done>::completed(ErrorInfo(1000, "Failed to initialize Tech3C SDK"));
+    }
+    return AsyncOperation<Done>::completed(Done());
+#else
+    if (isInitialized()) {
+        return AsyncOperation<Done>::completed(Done());
+    }
+
+    auto state = std::make_shared<detail::OperationState<Done>>();
+    state->id = m_nextOperationId.fetch_add(1, std::memory_order_relaxed);
+    bool running;
+    {
+        std::lock_guard<std::mutex> lock(m_operationsMutex);
+        running = !m_pendingInit.empty();
+        m_pendingInit.push_back(state);
+    }
+    if (running) {
+        // Already initializing, resolve with the running attempt
+        return AsyncOperation<Done>(state);
+    }
+
+    {
+        // The scheduler may only be touched from here, initialize() then finds the drain running
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        scheduleEventDrain();
+    }
+
+    m_worker.post([this, clientId, clientSecret]() {
+        SdkEvent event(EventType::INITIALIZED);
+        if (!initialize(clientId, clientSecret)) {
+            event.error = ErrorInfo(1000, "Failed to initialize Tech3C SDK");
+        }
+        postEvent(std::move(event));
+    });
+    return AsyncOperation<Done>(state);
+#endif
+}
+
+AsyncOperation<UserInfo> Tech3CSession::authenticate(CancellationToken cancel) {
+    auto state = std::make_shared<detail::OperationState<UserInfo>>();
+    state->id = m_nextOperationId.fetch_add(1, std::memory_order_relaxed);
+    if (cancel.isCancelled()) {
+        state->complete(ErrorInfo(ERROR_OPERATION_CANCELLED, "Operation cancelled"));
+        return AsyncOperation<UserInfo>(state);
+    }
+
+    // Cancellation may come from any thread, route it through the event ring to the axmol thread.
+    // Completing the operation (cleanup() completes them all) unsubscribes and waits for a running
+    // callback, so the captured this never outlives the manager.
+    state->cancelToken = cancel;
+    const uint64_t operationId = state->id;
+    state->cancelSubscription = cancel.subscribe([this, operationId]() {
+        postEvent(SdkEvent(EventType::OPERATION_CANCELLED, operationId));
+    });
+    {
+        std::lock_guard<std::mutex> lock(m_operationsMutex);
+        m_pendingAuth.push_back(state);
+    }
+
+    showAuth();
+    return AsyncOperation<UserInfo>(state);
+}
+
+void Tech3CSession::completeInitOperations(const AsyncResult<Done>& result) {
+    std::vector<std::shared_ptr<detail::OperationState<Done>>> completed;
+    {
+        std::lock_guard<std::mutex> lock(m_operationsMutex);
+        completed.swap(m_pendingInit);
+    }
+    for (auto& state : completed) {
+        state->complete(result);
+    }
+}
+
+void Tech3CSession::completeLogoutOperations(const AsyncResult<Done>& result, uint64_t operationId) {
+    std::vector<std::shared_ptr<detail::OperationState<Done>>> completed;
+    {
+        std::lock_guard<ProfiledMutex> lock(m_mutex);
+        if (operationId == 0) {
+            completed.swap(m_pendingLogout);
+        } else {
+            for (auto it = m_pendingLogout.begin(); it != m_pendingLogout.end(); ++it) {
+                if ((*it)->id == operationId) {
+                    completed.push_back(*it);
+                    m_pendingLogout.erase(it);
+                    break;
+                }
+            }
+        }
+    }
+    // Continuations may call logout() again, m_mutex must not be held
+    for (auto& state : completed) {
+        state->complete(result);
+    }
+}
+
+void Tech3CSession::completeAuthOperations(const AsyncResult<UserInfo>& result, uint64_t operationId) {
+    // Completing resumes coroutines that may start another authenticate(), work on a detached list
+    std::vector<std::shared_ptr<detail::OperationState<UserInfo>>> completed;
+    {
+        // cleanup() may race a dispatch; whichever detaches an operation completes it
+        std::lock_guard<std::mutex> lock(m_operationsMutex);
+        if (operationId == 0) {
+            completed.swap(m_pendingAuth);
+        } else {
+            for (auto it = m_pendingAuth.begin(); it != m_pendingAuth.end(); ++it) {
+                if ((*it)->id == operationId) {
+                    completed.push_back(*it);
+                    m_pendingAuth.erase(it);
+                    break;
+                }
+            }
+        }
+    }
+
+    for (auto& state : completed) {
+        state->complete(result);
+    }
+}
+
+bool Tech3CSession::hasPendingAuth() {
+    std::lock_guard<std::mutex> lock(m_operationsMutex);
+    return !m_pendingAuth.empty();
+}
+
+void Tech3CSession::onLoginSuccess(std::string_view userId, std::string_view accessToken,
+                                   std::string_view refreshToken, int loginType, int64_t expiryTime) {
+    TECH3C_TRACE_SCOPE("callback", "onLoginSuccess");
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+
+    if (!transitionState(INITIALIZED_STATES, LifecycleState::LOGGED_IN)) {
+        TECH3C_LOGW("Dropping login success while {}", lifecycleStateToString(getLifecycleState()));
+        return;
+    }
+    TECH3C_LOGD("Login success for user: {}", userId);
+
+    UserInfo previous = m_currentUser;
+    if (!m_currentUser.setCredentials(userId, accessToken, refreshToken)) {
+        TECH3C_LOGE("Login rejected, credentials exceed UserInfo capacity ({} / {} / {} bytes)",
+                    userId.size(), accessToken.size(), refreshToken.size());
+        m_metrics.authFailed();
+        // The previous user, if any, is still the published one
+        transitionState(lifecycleStateBit(LifecycleState::LOGGED_IN), settledState());
+        postEvent(SdkEvent(ErrorInfo(2002, "Credentials too long")));
+        return;
+    }
+    m_metrics.authSucceeded(false);
+    m_currentUser.loginType = static_cast<LoginType>(loginType);
+    m_currentUser.expiryTime = expiryTime;
+    publishUserLocked();
+    saveSessionLocked(previous);
+    scheduleTokenRefreshLocked();
+
+    postEvent(SdkEvent(EventType::LOGIN_SUCCESS, m_userSnapshot.load()));
+}
+
+void Tech3CSession::onRegisterSuccess(std::string_view userId, std::string_view accessToken,
+                                      std::string_view refreshToken, int64_t expiryTime) {
+    TECH3C_TRACE_SCOPE("callback", "onRegisterSuccess");
+    std::lock_guard<ProfiledMutex> lock(m_mutex);
+
+    if (!transitionState(INITIALIZED_STATES, LifecycleState::LOGGED_IN)) {
+        TECH3C_LOGW("Dropping register success while {}", lifecycleStateToString(getLifecycleState()));
+        return;
+    }
+    TECH3C_LOGD("Register success for user: {}", userId);
+
+    UserInfo previous = m_currentUser;
+    if (!m_currentUser.setCredentials(userId, accessToken, refreshToken)) {
+        TECH3C_LOGE("Register rejected, credentials exceed UserInfo capacity ({} / {} / {} bytes)",
+                    userId.size(), accessToken.size(), refreshToken.size());
+        m_metrics.authFailed();
+        // The previous user, if any, is still the published one
+        transitionState(lifecycleStateBit(LifecycleState::LOGGED_IN), settledState());
+        postEvent(SdkEvent(ErrorInfo(2002, "Credentials too long")));
+        return;
+    }
+    m_metrics.authSucceeded(true);
+    m_currentUser.loginType = LoginType::ACCOUNT; // Default for registration
+    m_currentUser.expiryTime = expiryTime;
+    publishUserLocked();
+    saveSessionLocked(previous);
+    scheduleTokenRefreshLocked();
+
+    postEvent(SdkEvent(EventType::REGISTER_SUCCESS, m_userSnapshot.load()));
+}
+
+void Tech3CSession::onError(const std::string& error) {
+    TECH3C_TRACE_SCOPE("callback", "onError");
+    const LifecycleState state = getLifecycleState();
+    if (state == LifecycleState::INITIALIZING) {
+        // initialize() fails on it, the error callback still gets the reason
+        TECH3C_LOGE("Initialization error: {}", error);
+        m_initErrorReported.store(true, std::memory_order_relaxed);
+        postEvent(SdkEvent(ErrorInfo(2000, error)));
+        return;
+    }
+    if (!isInitialized()) {
+        TECH3C_LOGW("Dropping auth error while {}: {}", lifecycleStateToString(state), error);
+        return;
+    }
+    TECH3C_LOGE("Auth error: {}", error);
+    m_metrics.authFailed();
+    transitionState(lifecycleStateBit(LifecycleState::AUTHENTICATING), settledState());
+
+    postEvent(SdkEvent(ErrorInfo(2000, error)));
+}
+
+void Tech3CSession::onAuthCancelled() {
+    TECH3C_TRACE_SCOPE("callback", "onAuthCancelled");
+    if (!isInitialized()) {
+        TECH3C_LOGW("Dropping auth cancel while {}", lifecycleStateToString(getLifecycleState()));
+        return;
+    }
+    TECH3C_LOGD("Auth cancelled by user");
+    m_metrics.authCancelled();
+    transitionState(lifecycleStateBit(LifecycleState::AUTHENTICATING), settledState());
+
+    postEvent(SdkEvent(EventType::AUTH_CANCELLED));
+}
+
+void Tech3CSession::onAuthScreenOpened() {
+    TECH3C_TRACE_SCOPE("callback", "onAuthScreenOpened");
+    if (!isInitialized()) {
+        TECH3C_LOGW("Dropping auth screen opened while {}", lifecycleStateToString(getLifecycleState()));
+        return;
+    }
+    TECH3C_LOGD("Auth screen opened");
+    m_metrics.authScreenOpened();
+
+    postEvent(SdkEvent(EventType::AUTH_SCREEN_OPENED));
+}
+
+void Tech3CSession::onChannelEvent(ChannelFields& fields) {
+    std::string_view userId;
+    std::string_view accessToken;
+    std::string_view refreshToken;
+    std::string_view message;
+    int64_t loginType = 0;
+    int64_t expiryTime = 0;
+
+    switch (fields.getType()) {
+        case ChannelRecord::LOGIN_SUCCESS:
+            if (fields.getString(userId) && fields.getString(accessToken) && fields.getString(refreshToken)
+                    && fields.getLong(loginType) && fields.getLong(expiryTime)) {
+                onLoginSuccess(userId, accessToken, refreshToken, static_cast<int>(loginType), expiryTime);
+                return;
+            }
+            break;
+        case ChannelRecord::REGISTER_SUCCESS:
+            if (fields.getString(userId) && fields.getString(accessToken) && fields.getString(refreshToken)
+                    && fields.getLong(expiryTime)) {
+                onRegisterSuccess(userId, accessToken, refreshToken, expiryTime);
+                return;
+            }
+            break;
+        case ChannelRecord::AUTH_ERROR:
+            if (fields.getString(message)) {
+                onError(std::string(message));
+                return;
+            }
+            break;
+        case ChannelRecord::AUTH_CANCELLED:
+            onAuthCancelled();
+            return;
+        case ChannelRecord::AUTH_SCREEN_OPENED:
+            onAuthScreenOpened();
+            return;
+        default:
+            break;
+    }
+    // A newer helper's event type, or a record cut short
+    TECH3C_LOGE("Dropping bridge channel event of type {}", static_cast<int>(fields.getType()));
+}
+
+void Tech3CSession::readChannelEvents() {
+#if AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID
+    ChannelReader& events = BridgeChannel::getInstance().getEvents();
+    if (!m_nativeSdk || !events.isAttached()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(s_channelReadMutex);
+    JNIEnv* env = JniHelper::getEnv();
+    if (!s_channelEvents.resolve(env)) {
+        return;
+    }
+    const jlong tail = env->GetStaticLongField(s_channelEvents.classRef, s_channelEvents.tail);
+    if (static_cast<uint64_t>(tail) == events.getHead()) {
+        return;
+    }
+    // Tokens go from the ring straight into UserInfo
+    const uint64_t head = events.read(static_cast<uint64_t>(tail), [this](ChannelFields& fields) { onChannelEvent(fields); });
+    env->SetStaticLongField(s_channelEvents.classRef, s_channelEvents.head, static_cast<jlong>(head));
+#endif
+}
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_ANDROID
+bool Tech3CSession::sendChannelCommand(BridgeMethod method) {
+    const BridgeMethodSpec& spec = BRIDGE_METHODS[static_cast<size_t>(method)];
+    TECH3C_TRACE_SCOPE("bridge", spec.name);
+    ChannelWriter& commands = BridgeChannel::getInstance().getCommands();
+    const uint64_t tail = commands.commit();
+
+    JNIEnv* env = JniHelper::getEnv();
+    env->CallStaticVoidMethod(s_jniRegistry.channelClassRef, s_jniRegistry.onCommands, static_cast<jlong>(tail));
+    // Tech3CChannel consumes every record up to tail, even when one of the commands throws
+    commands.setHead(tail);
+
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        TECH3C_LOGE("Java exception occurred in {}", spec.name);
+
+        postEvent(SdkEvent(ErrorInfo(spec.errorCode, spec.errorMessage)));
+        return false;
+    }
+    return true;
+}
+
+bool Tech3CSession::callJavaMethod(BridgeMethod method, ...) {
+    const BridgeMethodSpec& spec = BRIDGE_METHODS[static_cast<size_t>(method)];
+    TECH3C_TRACE_SCOPE("bridge", spec.name);
+    jmethodID methodID = s_jniRegistry.get(method);
+
+    if (!methodID) {
+        TECH3C_LOGE("Failed to find {} method", spec.name);
+        postEvent(SdkEvent(ErrorInfo(spec.errorCode + 1, std::string("Failed to find ") + spec.name + " method")));
+        return false;
+    }
+
+    JNIEnv* env = JniHelper::getEnv();
+    va_list args;
+    va_start(args, method);
+    env->CallStaticVoidMethodV(s_jniRegistry.classRef, methodID, args);
+    va_end(args);
+
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        TECH3C_LOGE("Java exception occurred in {}", spec.name);
+
+        postEvent(SdkEvent(ErrorInfo(spec.errorCode, spec.errorMessage)));
+        return false;
+    }
+    return true;
+}
+#endif
+
+void Tech3CSession::postEvent(SdkEvent&& event) {
+    if (event.type == EventType::AUTH_ERROR || event.type == EventType::TOKEN_REFRESH_FAILED) {
+        m_metrics.recordError(event.error.code);
+    }
+    event.generation = m_generation.load(std::memory_order_acquire);
+    event.traceFlowId = Tracer::getInstance().flowBegin("callback", eventTypeName(event.type));
+    if (!m_eventQueue.tryPush(std::move(event))) {
+        // Never block the producer: on iOS it may be the axmol thread itself
+        uint32_t dropped = m_droppedEvents.fetch_add(1, std::memory_order_relaxed) + 1;
+        TECH3C_LOGW("SDK event queue full, dropped events: {}", dropped);
+    }
+}
+
+void Tech3CSession::scheduleEventDrain() {
+    if (m_drainScheduled || !m_dispatchOnFrame) {
+        return;
+    }
+    m_drainScheduled = true;
+
+    // Drain once per frame on the axmol thread
+    Director::getInstance()->getScheduler()->schedule([this](float) { dispatchPendingEvents(); },
+                                                     this, 0.0f, false, EVENT_DRAIN_KEY);
+}
+
+void Tech3CSession::unscheduleEventDrain() {
+    if (!m_drainScheduled) {
+        return;
+    }
+    m_drainScheduled = false;
+    Director::getInstance()->getScheduler()->unschedule(EVENT_DRAIN_KEY, this);
+}
+
+size_t Tech3CSession::dispatchPendingEvents() {
+    TECH3C_TRACE_SCOPE("callback", "Tech3CSession::dispatchPendingEvents");
+    const auto start = std::chrono::steady_clock::now();
+    const auto budget = std::chrono::microseconds(m_dispatchBudgetUs.load(std::memory_order_relaxed));
+
+    readChannelEvents();
+    size_t dispatched = 0;
+    SdkEvent event;
+    while (m_eventQueue.tryPop(event)) {
+        // Posted before the last cleanup(), its session and callbacks are gone
+        if (event.generation == m_generation.load(std::memory_order_acquire)) {
+            dispatchEvent(event);
+        } else {
+            TECH3C_LOGD("Dropping stale {} event", eventTypeName(event.type));
+        }
+        ++dispatched;
+
+        // Always make progress, then stop once the frame budget is spent; the rest waits for next frame
+        if (std::chrono::steady_clock::now() - start >= budget) {
+            break;
+        }
+    }
+    return dispatched;
+}
+
+void Tech3CSession::dispatchEvent(const SdkEvent& event) {
+    TECH3C_TRACE_SCOPE("callback", eventTypeName(event.type));
+    Tracer::getInstance().flowEnd("callback", eventTypeName(event.type), event.traceFlowId);
+
+    // Results for awaiting operations copy the user or build an ErrorInfo; skipped when nothing
+    // awaits, so delivering to the callbacks alone never allocates
+    switch (event.type) {
+        case EventType::LOGIN_SUCCESS:
+            if (m_loginSuccessCallback) m_loginSuccessCallback(*event.user);
+            if (hasPendingAuth()) completeAuthOperations(*event.user);
+            break;
+        case EventType::REGISTER_SUCCESS:
+            if (m_registerSuccessCallback) m_registerSuccessCallback(*event.user);
+            if (hasPendingAuth()) completeAuthOperations(*event.user);
+            break;
+        case EventType::AUTH_ERROR:
+            if (m_errorCallback) m_errorCallback(event.error);
+            if (hasPendingAuth()) {
+                completeAuthOperations(event.error);
+            }
+            break;
+        case EventType::TOKEN_REFRESH_FAILED:
+            // A failed background refresh says nothing about the auth screen
+            if (m_errorCallback) m_errorCallback(event.error);
+            break;
+        case EventType::AUTH_CANCELLED:
+            if (m_cancelCallback) m_cancelCallback();
+            if (hasPendingAuth()) completeAuthOperations(ErrorInfo(ERROR_AUTH_CANCELLED, "Authentication cancelled"));
+            break;
+        case EventType::AUTH_SCREEN_OPENED:
+            if (m_authScreenOpenedCallback) m_authScreenOpenedCallback();
+            break;
+        case EventType::TOKEN_REFRESHED:
+            if (m_tokenRefreshedCallback) m_tokenRefreshedCallback(*event.user);
+            break;
+        case EventType::OPERATION_CANCELLED:
+            completeAuthOperations(ErrorInfo(ERROR_OPERATION_CANCELLED, "Operation cancelled"), event.operationId);
+            break;
+        case EventType::INITIALIZED:
+            if (event.error.code != 0) {
+                completeInitOperations(event.error);
+            } else {
+                completeInitOperations(Done());
+            }
+            break;
+        case EventType::LOGOUT_COMPLETED:
+            if (event.error.code != 0) {
+                completeLogoutOperations(event.error, event.operationId);
+            } else {
+                completeLogoutOperations(Done(), event.operationId);
+            }
+            break;
+    }
+}
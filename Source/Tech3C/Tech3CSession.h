@@ -0,0 +1,386 @@
+#pragma once
+
+#include "axmol.h"
+#include "Tech3CPlatform.h"
+#include "Tech3CTypes.h"
+#include "Tech3CAsync.h"
+#include "Tech3CEventQueue.h"
+#include "Tech3CMetrics.h"
+#include "Tech3CRetry.h"
+#include "Tech3CSessionHost.h"
+#include "Tech3CSessionStore.h"
+#include "Tech3CSnapshot.h"
+#include "Tech3CTokenRefresher.h"
+#include "Tech3CWorker.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+
+USING_NS_AX;
+
+namespace tech3c {
+
+    // Native SDK entry points, resolved once per initialize() on platforms with a method registry
+    enum class BridgeMethod {
+        Initialize = 0,
+        SetDebugMode,
+        SetUiMode,
+        SetLanguage,
+        SetOrientation,
+        SetEnableGuestLogin,
+        SetDisableExitLogin,
+        SetRequireOtp,
+        SetEnableMaintenanceCheck,
+        SetIpMaintenanceCheck,
+        SetEnableRequireBOD,
+        ShowAuth,
+        Logout,
+        ApplyConfig,
+        Count
+    };
+
+    class ChannelFields;
+    class DesktopBackend;
+
+    // acquireToken() result, shared by every caller waiting on the same refresh
+    using TokenFuture = std::shared_future<AsyncResult<UserSnapshot>>;
+
+    struct SessionOptions {
+        // Threads and connections shared with other sessions; null gives the session its own host
+        std::shared_ptr<SessionHost> host;
+        // Saves the logged in user for restoreSession(), to sessionFile (empty: tech3c_session.bin
+        // in the writable path). Off by default, sessions of one process would share the file.
+        bool persistSession = false;
+        std::string sessionFile;
+        // SDK events beyond it are dropped until the next dispatch; rounded up to a power of two
+        // (at most 65536), with a warning
+        size_t eventQueueCapacity = DEFAULT_EVENT_QUEUE_CAPACITY;
+        // Dispatch SDK events once per frame from the axmol scheduler; headless owners (bots, test
+        // harnesses) turn it off and call dispatchPendingEvents() from one thread of their own
+        bool dispatchOnFrame = true;
+        // Backoff for the idempotent requests: the init request and the auth service's maintenance
+        // query (desktop), and token refreshes. Refreshes keep retrying while the token is good,
+        // maxAttempts does not bound them.
+        RetryPolicy retryPolicy;
+    };
+
+    // One player session against one Tech3C client: its Config, user, callbacks and lifecycle.
+    // Sessions are independent, each has its own lock, so a process can run thousands of them on
+    // a shared SessionHost. Only the default session (Tech3CManager) drives the native Android / iOS
+    // SDK, which is process wide; other sessions need the desktop backend.
+    class Tech3CSession {
+    public:
+        explicit Tech3CSession(const SessionOptions& options = SessionOptions());
+        virtual ~Tech3CSession();
+
+        // Initialize SDK
+        bool initialize(const std::string& clientId, const std::string& clientSecret);
+        void cleanup();
+
+        // Configuration
+        // Values set before initialize() are buffered and pushed in one bridge call once the SDK
+        // is up; afterwards only the fields that changed since the last push are sent.
+        void applyConfig(const Config& config);
+        // Also sets the log level on the default session; the level is process wide, so other
+        // sessions only record debugMode in their Config
+        void setDebugMode(bool debug);
+        void setUiMode(UiMode mode);
+        void setLanguage(Language language);
+        void setOrientation(OrientationMode orientation);
+        void setEnableGuestLogin(bool enable);
+        void setDisableExitLogin(bool disable);
+        void setRequireOtp(bool require);
+        void setEnableMaintenanceCheck(bool enable);
+        void setIpMaintenanceCheck(const std::string& ip);
+        // Several endpoints for the maintenance check, see Config::ipMaintenanceCheck
+        void setMaintenanceEndpoints(const std::vector<std::string>& endpoints);
+        void setEnableRequireBOD(bool enable);
+
+        // Authentication
+        void showAuth();
+        // Completes once the bridge call was made, the SDK does not report when its own logout finishes.
+        // Safe from any thread; the operation still resolves on the dispatching thread.
+        AsyncOperation<Done> logout();
+
+        // Async API
+        // Call on the axmol thread; results are delivered there too, from the per-frame event drain,
+        // so awaiting coroutines resume without any extra thread hop. The set*Callback slots still fire.
+        // Runs initialize() on the SDK worker thread (on iOS in place, the SDK sets itself up on the
+        // main queue), so the game can keep building its first scene meanwhile.
+        AsyncOperation<Done> initializeAsync(const std::string& clientId, const std::string& clientSecret);
+        // Shows the auth screen and resolves with the logged in (or registered) user, or with the error;
+        // closing the screen yields ERROR_AUTH_CANCELLED, cancelling the token ERROR_OPERATION_CANCELLED
+        AsyncOperation<UserInfo> authenticate(CancellationToken cancel = CancellationToken());
+
+        // User Info
+        // Safe from any thread without locking. Hot paths (e.g. attaching the access token to every
+        // request) should hold on to getUserSnapshot() instead of copying the strings each time.
+        UserInfo getCurrentUser() const { return *m_userSnapshot.load(); }
+        UserSnapshot getUserSnapshot() const { return m_userSnapshot.load(); }
+        bool isLoggedIn() const { return m_loggedIn.load(std::memory_order_acquire); }
+
+        // Session persistence
+        // Loads the session saved by the last login/register; if its token has not expired the
+        // user is logged in right away, without any bridge call. Call once before the first scene.
+        bool restoreSession();
+
+        // Token refresh
+        // The access token is renewed on a background thread `margin` before expiryTime (at most half
+        // way through its remaining lifetime), with the server/device clock offset taken into account.
+        // Refreshed users are delivered through the token refreshed callback, failures as error 2001.
+        void setTokenRefreshMargin(std::chrono::seconds margin);
+        // Performs the refresh; desktop builds default to the auth service, mobile builds need one
+        void setTokenRefreshHandler(TokenRefreshHandler handler);
+        void setTokenRefreshedCallback(TokenRefreshedCallback callback) { m_tokenRefreshedCallback = std::move(callback); }
+        // Failed refreshes are retried with SessionOptions::retryPolicy's backoff while the token
+        // is still good; ones the backend turned down for good (TokenRefreshResult::retryable) are not
+        void setRetryPolicy(const RetryPolicy& policy);
+        // Access token for game network code, from any thread. While the current token is good for
+        // minValidity more, the future is ready right away and takes no lock. Otherwise the caller
+        // joins the refresh in flight (scheduled or started by another caller) or starts it, so an
+        // expiry boundary costs the auth backend one request however many threads hit it; every
+        // waiter wakes with the refreshed user, error 2001 or ERROR_NOT_LOGGED_IN. A refresh that
+        // failed recently is retried once its backoff is over, not right away. While the refresh
+        // backend's circuit breaker is open nobody waits: the caller gets the current token if it
+        // has not expired yet, else ERROR_CIRCUIT_OPEN.
+        TokenFuture acquireToken(std::chrono::seconds minValidity = std::chrono::seconds(30));
+        // Estimated server clock minus device clock
+        int64_t getClockSkewMs() const { return m_clockSkew.getOffsetMs(); }
+        // Feeds the skew estimate with a server timestamp seen in a response (all times epoch ms)
+        void reportServerTime(int64_t serverTimeMs, int64_t requestSentMs, int64_t responseReceivedMs);
+
+        // Callbacks
+        void setLoginSuccessCallback(LoginSuccessCallback callback) { m_loginSuccessCallback = std::move(callback); }
+        void setRegisterSuccessCallback(RegisterSuccessCallback callback) { m_registerSuccessCallback = std::move(callback); }
+        void setErrorCallback(ErrorCallback callback) { m_errorCallback = std::move(callback); }
+        void setCancelCallback(CancelCallback callback) { m_cancelCallback = std::move(callback); }
+        void setAuthScreenOpenedCallback(AuthScreenOpenedCallback callback) { m_authScreenOpenedCallback = std::move(callback); }
+
+        // JNI Callbacks (called from Java)
+        // Values are copied into UserInfo; ones longer than its capacities fail the login (error 2002)
+        void onLoginSuccess(std::string_view userId, std::string_view accessToken,
+                          std::string_view refreshToken, int loginType, int64_t expiryTime);
+        void onRegisterSuccess(std::string_view userId, std::string_view accessToken,
+                             std::string_view refreshToken, int64_t expiryTime);
+        void onError(const std::string& error);
+        void onAuthCancelled();
+        void onAuthScreenOpened();
+        // One event record from Tech3CChannel.java (Tech3CBridgeChannel.h), its strings read in place
+        void onChannelEvent(ChannelFields& fields);
+        // Queues the records Tech3CChannel.java published since the last call. Android default
+        // session only; every dispatchPendingEvents() and Tech3CChannel.flush() runs it.
+        void readChannelEvents();
+
+        // Event delivery
+        // SDK callbacks are queued from any thread and dispatched on the axmol thread once per frame,
+        // spending at most the given budget per frame (at least one event is always dispatched).
+        void setEventDispatchBudget(std::chrono::microseconds budget) { m_dispatchBudgetUs = budget.count(); }
+        // Dispatches queued events on the calling thread, normally driven by the scheduler; with
+        // SessionOptions::dispatchOnFrame off, always call it from the same thread
+        size_t dispatchPendingEvents();
+        uint32_t getDroppedEventCount() const { return m_droppedEvents.load(std::memory_order_relaxed); }
+
+        // Bridge calls
+        // showAuth(), logout() and the config setters return right away: their JNI / iOS bridge calls
+        // run on one SDK worker thread, in the order the methods were called, so a setter always reaches
+        // the SDK before a later showAuth(). Failures are reported through the error callback.
+        // Blocks until every bridge call queued so far has been made; for tests, never from a callback
+        void flushBridgeCalls() { m_worker.flush(); }
+
+        // Metrics
+        // Latency histograms per operation, error counts per ErrorInfo::code and the auth funnel since
+        // the last reset; recording is lock-free, reading is safe from any thread
+        MetricsSnapshot getMetrics() const { return m_metrics.snapshot(); }
+        std::string getMetricsJson() const { return m_metrics.snapshot().toJson(); }
+        void resetMetrics() { m_metrics.reset(); }
+        // Circuit breakers of the host's backend endpoints, shared with its other sessions; a
+        // game can show them (e.g. "servers unreachable, retrying in 20 s") instead of spinning
+        std::vector<CircuitBreakerStatus> getCircuitBreakers() const { return m_host->getCircuitBreakers().getStatus(); }
+
+        // Lifecycle
+        // Wait-free, from any thread. Operations the current state does not allow are rejected up
+        // front: showAuth() / authenticate() / logout() with error 1001, SDK callbacks arriving while
+        // uninitialized or shutting down are dropped. Events queued before a cleanup() are discarded.
+        LifecycleState getLifecycleState() const { return m_state.load(std::memory_order_acquire); }
+        bool isInitialized() const { return (lifecycleStateBit(getLifecycleState()) & INITIALIZED_STATES) != 0; }
+
+        // Utility
+        const Config& getConfig() const { return m_config; }
+        SessionHost& getHost() { return *m_host; }
+#if TECH3C_DESKTOP_BACKEND
+        // Desktop auth service backend, e.g. to pick the simulated auth flow (set by initialize())
+        DesktopBackend* getDesktopBackend() { return m_desktopBackend.get(); }
+#endif
+
+    protected:
+        // nativeSdk: the session receiving the native SDK callbacks, there is only one
+        Tech3CSession(const SessionOptions& options, bool nativeSdk);
+
+    private:
+        // Prevent copy
+        Tech3CSession(const Tech3CSession&) = delete;
+        Tech3CSession& operator=(const Tech3CSession&) = delete;
+
+        static constexpr uint32_t INITIALIZED_STATES = lifecycleStateBit(LifecycleState::READY)
+                | lifecycleStateBit(LifecycleState::AUTHENTICATING) | lifecycleStateBit(LifecycleState::LOGGED_IN);
+
+        // Moves to `to` in one atomic step if the current state is one of the `from` bits
+        bool transitionState(uint32_t from, LifecycleState to);
+        // INITIALIZING -> READY / LOGGED_IN and the first config push, caller must hold m_mutex
+        bool finishInitializeLocked();
+        // Where a finished auth flow leaves the SDK: LOGGED_IN while a user is logged in, else READY
+        LifecycleState settledState() const;
+
+        // Internal methods
+        // Calls a cached Tech3CHelper static void method, reporting missing methods and Java exceptions
+        bool callJavaMethod(BridgeMethod method, ...);
+        // Hands the command record begun in the bridge channel to Tech3CChannel.onCommands, reporting
+        // a Java exception like callJavaMethod() would for method
+        bool sendChannelCommand(BridgeMethod method);
+
+        // Makes m_currentUser visible to readers, caller must hold m_mutex
+        void publishUserLocked();
+        // Stores m_currentUser for the next launch if it changed, caller must hold m_mutex
+        void saveSessionLocked(const UserInfo& previous);
+
+        // Plans the next refresh of m_currentUser, right away while acquireToken() callers wait;
+        // caller must hold m_mutex
+        void scheduleTokenRefreshLocked();
+        // A handler (or the desktop backend) and a refresh token, caller must hold m_mutex
+        bool canRefreshLocked() const;
+        // The breaker in front of whatever performs the refresh, null if nothing does yet; caller
+        // must hold m_mutex
+        CircuitBreaker* refreshBreakerLocked();
+        // Runs on the token refresh thread
+        void refreshTokens();
+        // user's token stays good for minValidityMs more; tokens without an expiry always do
+        bool isTokenValid(const UserInfo& user, int64_t minValidityMs) const;
+        // Wakes the acquireToken() callers waiting on a refresh, caller must hold m_mutex
+        void completeTokenWaitersLocked(const AsyncResult<UserSnapshot>& result);
+
+        // Queues the fields of m_config that differ from m_pushedConfig, plus those not confirmed
+        // yet; caller must hold m_mutex
+        void pushConfigLocked();
+        // Sets the process wide log level from m_config.debugMode, default session only (other
+        // sessions leave it to tech3c::setLogLevel()); caller must hold m_mutex
+        void applyLogLevelLocked();
+        // Makes the bridge calls for the fields in mask, SDK worker thread only; false when any
+        // of them failed
+        bool sendConfig(uint32_t mask, const Config& config);
+
+        // Resolves pending authenticate() operations, axmol thread only
+        void completeAuthOperations(const AsyncResult<UserInfo>& result, uint64_t operationId = 0);
+        bool hasPendingAuth();
+        // Resolves pending initializeAsync() operations, axmol thread only
+        void completeInitOperations(const AsyncResult<Done>& result);
+        // Resolves the logout() operation with this id (0: all of them), axmol thread only
+        void completeLogoutOperations(const AsyncResult<Done>& result, uint64_t operationId = 0);
+
+        // Thread-safe callback execution
+        void postEvent(SdkEvent&& event);
+        void dispatchEvent(const SdkEvent& event);
+        void scheduleEventDrain();
+        void unscheduleEventDrain();
+
+        static constexpr int64_t DEFAULT_DISPATCH_BUDGET_US = 2000;
+        static constexpr int64_t DEFAULT_REFRESH_MARGIN_MS = 5 * 60 * 1000;
+        // Registry key of the breaker in front of the game's TokenRefreshHandler
+        static constexpr const char* REFRESH_HANDLER_ENDPOINT = "tokenRefreshHandler";
+
+        // Declared first, the workers and timers below run on its threads
+        std::shared_ptr<SessionHost> m_host;
+        const bool m_nativeSdk;
+        const bool m_dispatchOnFrame;
+
+        // Configuration, guarded by m_mutex. m_pushedConfig is what the SDK confirmed it has;
+        // m_unpushedFields were queued since and are sent again until a push of them succeeds,
+        // m_configPushSeq tells the latest push apart
+        Config m_config;
+        Config m_pushedConfig;
+        bool m_hasPushedConfig;
+        uint32_t m_unpushedFields;
+        uint64_t m_configPushSeq;
+        // The last push failed; showAuth() sends m_unpushedFields again before the screen opens
+        std::atomic<bool> m_configPushFailed;
+
+        // Lifecycle
+        std::atomic<LifecycleState> m_state;
+        // Bumped by cleanup(); events carry the generation they were posted in and stale ones are
+        // dropped at dispatch, so nothing from a torn down session reaches the callbacks
+        std::atomic<uint32_t> m_generation;
+        // Set by onError() while INITIALIZING: the SDK reported a failed init from inside the
+        // initialize call, which itself returns normally
+        std::atomic<bool> m_initErrorReported;
+
+        // User data
+        // m_currentUser is the writer's copy, guarded by m_mutex; readers only see published snapshots
+        UserInfo m_currentUser;
+        AtomicSnapshot<UserInfo> m_userSnapshot;
+        std::atomic<bool> m_loggedIn;
+        // Null when SessionOptions::persistSession is off
+        std::unique_ptr<SessionStore> m_sessionStore;
+
+        // Callbacks
+        LoginSuccessCallback m_loginSuccessCallback;
+        RegisterSuccessCallback m_registerSuccessCallback;
+        ErrorCallback m_errorCallback;
+        CancelCallback m_cancelCallback;
+        AuthScreenOpenedCallback m_authScreenOpenedCallback;
+        TokenRefreshedCallback m_tokenRefreshedCallback;
+
+        // Token refresh
+        TokenRefreshHandler m_refreshHandler;
+        int64_t m_refreshMarginMs;
+        ClockSkewEstimator m_clockSkew;
+        TokenRefreshScheduler m_refreshScheduler;
+        // Guarded by m_mutex: refreshTokens() is between reading m_currentUser and applying the
+        // result; the backoff after failed refreshes of the current token (device time, 0: none)
+        bool m_refreshRunning;
+        RetryPolicy m_retryPolicy;
+        int m_refreshFailures;
+        int64_t m_refreshRetryAt;
+
+        // acquireToken(): the ready result handed out for one snapshot, built by the first caller
+        // after the token changes; and the refresh callers wait on (m_tokenFuture valid while one
+        // is pending), guarded by m_mutex
+        struct ReadyToken {
+            UserSnapshot user;
+            TokenFuture future;
+        };
+        AtomicSnapshot<ReadyToken> m_readyToken;
+        std::promise<AsyncResult<UserSnapshot>> m_tokenPromise;
+        TokenFuture m_tokenFuture;
+
+        // Pending authenticate() and initializeAsync() operations, completed on the axmol thread
+        // or by cleanup() from any thread; guarded by m_operationsMutex, which is never held while
+        // an operation completes
+        std::mutex m_operationsMutex;
+        std::vector<std::shared_ptr<detail::OperationState<UserInfo>>> m_pendingAuth;
+        std::vector<std::shared_ptr<detail::OperationState<Done>>> m_pendingInit;
+        std::atomic<uint64_t> m_nextOperationId;
+
+        // logout() may come from any thread, guarded by m_mutex
+        std::vector<std::shared_ptr<detail::OperationState<Done>>> m_pendingLogout;
+
+        Metrics m_metrics;
+
+        // Pending SDK events
+        SdkEventQueue m_eventQueue;
+        std::atomic<uint32_t> m_droppedEvents;
+        std::atomic<int64_t> m_dispatchBudgetUs;
+        bool m_drainScheduled;
+
+        // Makes the bridge calls off the axmol thread
+        Worker m_worker;
+
+#if TECH3C_DESKTOP_BACKEND
+        // Auth service backend for platforms without a native SDK
+        std::unique_ptr<DesktopBackend> m_desktopBackend;
+#endif
+
+        // Thread safety; contended acquisitions show up in getMetrics().lockWait
+        mutable ProfiledMutex m_mutex;
+    };
+}
@@ -0,0 +1,87 @@
+#include "Tech3CSessionHost.h"
+#include "Tech3CLog.h"
+#include <atomic>
+#include <cstdlib>
+
+using namespace tech3c;
+
+#if TECH3C_DESKTOP_BACKEND
+namespace {
+    // TECH3C_AUTH_URL value that asks for the stand-in server
+    constexpr const char* STAND_IN_AUTH_URL = "standin";
+
+    std::atomic<bool> s_standInServerEnabled(false);
+    std::atomic<bool> s_standInServerWarned(false);
+}
+#endif
+
+SessionHost::SessionHost(size_t threadCount)
+#if TECH3C_DESKTOP_BACKEND
+        : m_connected(false)
+        , m_maintenanceProbe(m_circuitBreakers)
+#endif
+{
+    if (threadCount > 0) {
+        m_pool.reset(new WorkerPool("tech3c pool", threadCount));
+        m_refreshTimer.reset(new RefreshTimer(m_pool.get()));
+    }
+}
+
+SessionHost::~SessionHost() {
+    // The timer posts to the pool, so it goes first
+    m_refreshTimer.reset();
+    m_pool.reset();
+
+#if TECH3C_DESKTOP_BACKEND
+    if (m_standInServer) {
+        m_standInServer->stop();
+    }
+#endif
+}
+
+#if TECH3C_DESKTOP_BACKEND
+HttpClient* SessionHost::connectAuthService(std::string& error) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_connected) {
+        return &m_client;
+    }
+
+    const char* value = std::getenv("TECH3C_AUTH_URL");
+    std::string url = (value && *value) ? value : "";
+    if (url.empty() && !s_standInServerEnabled.load(std::memory_order_relaxed)) {
+        error = "TECH3C_AUTH_URL is not set (TECH3C_AUTH_URL=standin runs a stand-in auth server)";
+        return nullptr;
+    }
+    if (url.empty() || url == STAND_IN_AUTH_URL) {
+        if (!m_standInServer) {
+            m_standInServer.reset(new StandInAuthServer());
+        }
+        if (!m_standInServer->isRunning() && !m_standInServer->start()) {
+            error = "Failed to start stand-in auth server";
+            return nullptr;
+        }
+        url = m_standInServer->getUrl();
+        // Its logins are not real ones, which must not go unnoticed outside a bench or test
+        if (!s_standInServerWarned.exchange(true)) {
+            TECH3C_LOGW("No auth service, using the in-process stand-in server at {}", url);
+        }
+    }
+
+    if (!m_client.setBaseUrl(url)) {
+        error = "Invalid auth service URL: " + url;
+        return nullptr;
+    }
+    m_client.setCircuitBreaker(&m_circuitBreakers.get(url));
+    m_connected = true;
+    return &m_client;
+}
+
+void SessionHost::setStandInServerEnabled(bool enabled) {
+    s_standInServerEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+StandInAuthServer* SessionHost::getStandInServer() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_standInServer.get();
+}
+#endif
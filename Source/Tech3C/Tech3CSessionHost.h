@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Tech3CPlatform.h"
+#include "Tech3CRetry.h"
+#include "Tech3CTokenRefresher.h"
+#include "Tech3CWorker.h"
+#include <memory>
+#include <mutex>
+#include <string>
+
+#if TECH3C_DESKTOP_BACKEND
+#include "Tech3CHttpClient.h"
+#include "Tech3CMaintenanceProbe.h"
+#include "Tech3CStandInServer.h"
+#endif
+
+namespace tech3c {
+
+    // What the sessions of one process share: the threads making bridge calls and backend requests,
+    // the token refresh timer and, on desktop, the auth service client and maintenance probe.
+    // Sessions keep a shared_ptr, so the host goes away with the last of them.
+    //
+    //   auto host = std::make_shared<SessionHost>(8);
+    //   SessionOptions options;
+    //   options.host = host;
+    //   auto session = std::make_unique<Tech3CSession>(options);
+    class SessionHost {
+    public:
+        // threadCount 0 gives every session dedicated threads, what the default session uses;
+        // otherwise all sessions run on that many pool threads plus one timer thread
+        explicit SessionHost(size_t threadCount = 0);
+        ~SessionHost();
+
+        // Null when sessions use dedicated threads
+        WorkerPool* getWorkerPool() { return m_pool.get(); }
+        RefreshTimer* getRefreshTimer() { return m_refreshTimer.get(); }
+        // One breaker per backend endpoint, shared by every session so they all stop at once when
+        // it fails: the auth service URL on desktop, each maintenance endpoint, "tokenRefreshHandler"
+        CircuitBreakerRegistry& getCircuitBreakers() { return m_circuitBreakers; }
+
+#if TECH3C_DESKTOP_BACKEND
+        // Points the shared client at TECH3C_AUTH_URL; later calls return the same client. Null with
+        // error on failure, including TECH3C_AUTH_URL unset while the stand-in server is off.
+        HttpClient* connectAuthService(std::string& error);
+        // Lets connectAuthService() start an in-process StandInAuthServer when TECH3C_AUTH_URL is
+        // unset, for benches and tests; process wide, off by default. TECH3C_AUTH_URL=standin
+        // does the same for a game run without an auth service.
+        static void setStandInServerEnabled(bool enabled);
+        // The stand-in server connectAuthService() started, if any
+        StandInAuthServer* getStandInServer();
+        // Probes Config::ipMaintenanceCheck endpoints, one answer cache for every session
+        MaintenanceProbe& getMaintenanceProbe() { return m_maintenanceProbe; }
+#endif
+
+    private:
+        SessionHost(const SessionHost&) = delete;
+        SessionHost& operator=(const SessionHost&) = delete;
+
+        // Declared first, the clients below hold on to its breakers
+        CircuitBreakerRegistry m_circuitBreakers;
+        std::unique_ptr<WorkerPool> m_pool;
+        std::unique_ptr<RefreshTimer> m_refreshTimer;
+
+#if TECH3C_DESKTOP_BACKEND
+        std::mutex m_mutex;
+        // Request paths are thread-safe once the base URL is set, which happens under m_mutex
+        HttpClient m_client;
+        bool m_connected;
+        std::unique_ptr<StandInAuthServer> m_standInServer;
+        MaintenanceProbe m_maintenanceProbe;    // After m_circuitBreakers, it keeps a reference
+#endif
+    };
+}
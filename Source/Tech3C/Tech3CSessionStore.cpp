@@ -0,0 +1,221 @@
+#include "Tech3CSessionStore.h"
+#include "axmol.h"
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#if AX_TARGET_PLATFORM == AX_PLATFORM_WIN32 || AX_TARGET_PLATFORM == AX_PLATFORM_WINRT
+#include <windows.h>
+#define TECH3C_WINDOWS_MAPPING 1
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+USING_NS_AX;
+using namespace tech3c;
+
+static_assert(sizeof(SessionFileHeader) == 40, "SessionFileHeader layout is part of the file format");
+
+namespace {
+
+    const char* SESSION_FILE_NAME = "tech3c_session.bin";
+
+    // Upper bound for a sane file, the SDK tokens are a few KB at most
+    const size_t MAX_SESSION_FILE_SIZE = 64 * 1024;
+
+    // Largest file save() writes
+    constexpr size_t MAX_SESSION_RECORD_SIZE = sizeof(SessionFileHeader) + USER_ID_CAPACITY
+                                               + ACCESS_TOKEN_CAPACITY + REFRESH_TOKEN_CAPACITY;
+
+    uint32_t fnv1a(const void* data, size_t size, uint32_t hash = 2166136261u) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    uint32_t checksum(const SessionFileHeader& header, const char* payload, size_t payloadSize) {
+        SessionFileHeader copy = header;
+        copy.checksum = 0;
+        return fnv1a(payload, payloadSize, fnv1a(&copy, sizeof(copy)));
+    }
+
+    // Validates a mapped file and copies it into user
+    bool decode(const char* data, size_t size, UserInfo& user) {
+        if (size < sizeof(SessionFileHeader)) {
+            return false;
+        }
+
+        SessionFileHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (header.magic != SESSION_FILE_MAGIC || header.version != SESSION_FILE_VERSION
+            || header.headerSize != sizeof(SessionFileHeader)) {
+            return false;
+        }
+
+        const size_t payloadSize = (size_t)header.userIdLength + header.accessTokenLength + header.refreshTokenLength;
+        if (payloadSize != size - sizeof(header)) {
+            return false;
+        }
+
+        const char* payload = data + sizeof(header);
+        if (checksum(header, payload, payloadSize) != header.checksum) {
+            return false;
+        }
+
+        // Fails for values longer than UserInfo holds, a file from a build with larger capacities
+        const std::string_view userId(payload, header.userIdLength);
+        payload += header.userIdLength;
+        const std::string_view accessToken(payload, header.accessTokenLength);
+        payload += header.accessTokenLength;
+        const std::string_view refreshToken(payload, header.refreshTokenLength);
+        if (!user.setCredentials(userId, accessToken, refreshToken)) {
+            return false;
+        }
+        user.loginType = static_cast<LoginType>(header.loginType);
+        user.expiryTime = header.expiryTime;
+        return true;
+    }
+
+    // Writes a new file holding data, flushed to disk. The file has tokens in it: on POSIX it is
+    // created owner-only rather than with the umask default.
+    bool writeFile(const std::string& path, const char* data, size_t size) {
+#if TECH3C_WINDOWS_MAPPING
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        bool written = std::fwrite(data, 1, size, file) == size;
+        return (std::fclose(file) == 0) && written;
+#else
+        int fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            return false;
+        }
+        // The mode only applies on creation, a temp file left by an older build keeps its own
+        bool written = ::fchmod(fd, 0600) == 0;
+        while (written && size > 0) {
+            ssize_t n = ::write(fd, data, size);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            written = n > 0;
+            if (written) {
+                data += n;
+                size -= static_cast<size_t>(n);
+            }
+        }
+        // On disk before the rename makes it the session file
+        written = written && ::fsync(fd) == 0;
+        return (::close(fd) == 0) && written;
+#endif
+    }
+
+    bool replaceFile(const std::string& from, const std::string& to) {
+#if TECH3C_WINDOWS_MAPPING
+        return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+    }
+}
+
+SessionStore::SessionStore(const std::string& path)
+        : m_path(path) {
+}
+
+const std::string& SessionStore::getPath() {
+    // Resolved lazily, FileUtils is not usable before the engine is up on every platform
+    if (m_path.empty()) {
+        m_path = FileUtils::getInstance()->getWritablePath() + SESSION_FILE_NAME;
+    }
+    return m_path;
+}
+
+bool SessionStore::load(UserInfo& user) {
+    const std::string& path = getPath();
+    bool loaded = false;
+
+#if TECH3C_WINDOWS_MAPPING
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0 && (size_t)size.QuadPart <= MAX_SESSION_FILE_SIZE) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (data) {
+                loaded = decode(static_cast<const char*>(data), (size_t)size.QuadPart, user);
+                UnmapViewOfFile(data);
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0 && (size_t)st.st_size <= MAX_SESSION_FILE_SIZE) {
+        void* data = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            loaded = decode(static_cast<const char*>(data), (size_t)st.st_size, user);
+            ::munmap(data, (size_t)st.st_size);
+        }
+    }
+    ::close(fd);
+#endif
+
+    return loaded;
+}
+
+bool SessionStore::save(const UserInfo& user) {
+    SessionFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = SESSION_FILE_MAGIC;
+    header.version = SESSION_FILE_VERSION;
+    header.headerSize = sizeof(SessionFileHeader);
+    header.loginType = static_cast<int32_t>(user.loginType);
+    header.expiryTime = user.expiryTime;
+    header.userIdLength = (uint32_t)user.userId.size();
+    header.accessTokenLength = (uint32_t)user.accessToken.size();
+    header.refreshTokenLength = (uint32_t)user.refreshToken.size();
+
+    // UserInfo is bounded, the whole file is assembled on the stack
+    char buffer[MAX_SESSION_RECORD_SIZE];
+    size_t size = sizeof(header);
+    for (std::string_view value : { user.getUserId(), user.getAccessToken(), user.getRefreshToken() }) {
+        std::memcpy(buffer + size, value.data(), value.size());
+        size += value.size();
+    }
+
+    header.checksum = checksum(header, buffer + sizeof(header), size - sizeof(header));
+    std::memcpy(buffer, &header, sizeof(header));
+
+    // Write next to the target and rename over it so a crash never leaves a torn file
+    const std::string& path = getPath();
+    const std::string tempPath = path + ".tmp";
+    if (!writeFile(tempPath, buffer, size) || !replaceFile(tempPath, path)) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SessionStore::clear() {
+    const std::string& path = getPath();
+    return std::remove(path.c_str()) == 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Tech3CTypes.h"
+#include <cstdint>
+#include <string>
+
+namespace tech3c {
+
+    // On-disk layout of a saved session, native endianness (the file never leaves the device).
+    // The three strings follow the header back to back, without terminators.
+    struct SessionFileHeader {
+        uint32_t magic;                 // SESSION_FILE_MAGIC
+        uint16_t version;               // SESSION_FILE_VERSION
+        uint16_t headerSize;            // sizeof(SessionFileHeader)
+        uint32_t checksum;              // FNV-1a over the header (checksum zeroed) and the strings
+        int32_t loginType;
+        int64_t expiryTime;             // Unix epoch milliseconds
+        uint32_t userIdLength;
+        uint32_t accessTokenLength;
+        uint32_t refreshTokenLength;
+        uint32_t reserved;
+    };
+
+    constexpr uint32_t SESSION_FILE_MAGIC = 0x53433354; // "T3CS"
+    constexpr uint16_t SESSION_FILE_VERSION = 1;
+
+    // Persists the logged in UserInfo so returning players skip showAuth() on a cold start.
+    // Files are replaced atomically and read through a read-only memory map.
+    class SessionStore {
+    public:
+        // Empty path uses tech3c_session.bin in the writable path
+        explicit SessionStore(const std::string& path = "");
+
+        // Reads the saved session into user, false if there is none or it is damaged
+        bool load(UserInfo& user);
+        bool save(const UserInfo& user);
+        bool clear();
+
+        const std::string& getPath();
+
+    private:
+        std::string m_path;
+    };
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace tech3c {
+
+    // Immutable, reference counted value published by writers and read from any thread (RCU
+    // style): a writer builds a new T and publishes it, readers keep whatever snapshot they loaded
+    // alive for as long as they hold it.
+    //
+    // std::atomic<std::shared_ptr> and the atomic_load / atomic_store free functions take a lock
+    // inside every standard library we ship with (libstdc++, libc++, MSVC), so the pointer is
+    // published through a few slots instead. load() pins the current slot, checks it is still the
+    // current one and copies the shared_ptr out: no lock, and it only goes round again when a
+    // store landed in between. Writers are serialized by a mutex readers never touch, and only
+    // fill a slot that is neither current nor pinned.
+    template <typename T>
+    class AtomicSnapshot {
+    public:
+        using Ptr = std::shared_ptr<const T>;
+
+        AtomicSnapshot() : AtomicSnapshot(std::make_shared<const T>()) {}
+        explicit AtomicSnapshot(Ptr value) : m_current(0) {
+            m_slots[0].value = std::move(value);
+        }
+
+        AtomicSnapshot(const AtomicSnapshot&) = delete;
+        AtomicSnapshot& operator=(const AtomicSnapshot&) = delete;
+
+        Ptr load() const {
+            // seq_cst on the pin and both loads of m_current: a writer that sees no reader on a
+            // slot has already moved m_current off it, so the check below fails for a late pin
+            uint64_t current = m_current.load(std::memory_order_seq_cst);
+            for (;;) {
+                const Slot& slot = m_slots[current & SLOT_MASK];
+                slot.readers.fetch_add(1, std::memory_order_seq_cst);
+                const uint64_t check = m_current.load(std::memory_order_seq_cst);
+                if (check == current) {
+                    Ptr value = slot.value;
+                    slot.readers.fetch_sub(1, std::memory_order_release);
+                    return value;
+                }
+                slot.readers.fetch_sub(1, std::memory_order_relaxed);
+                current = check;
+            }
+        }
+
+        void store(Ptr value) {
+            std::lock_guard<std::mutex> lock(m_writerMutex);
+            publish(std::move(value));
+        }
+
+        // store() unless another writer is publishing right now, for callers racing to publish
+        // equivalent values that would rather not wait on each other
+        bool tryStore(Ptr value) {
+            std::unique_lock<std::mutex> lock(m_writerMutex, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                return false;
+            }
+            publish(std::move(value));
+            return true;
+        }
+
+    private:
+        static constexpr uint64_t SLOT_BITS = 2;
+        static constexpr uint64_t SLOT_COUNT = uint64_t(1) << SLOT_BITS;
+        static constexpr uint64_t SLOT_MASK = SLOT_COUNT - 1;
+
+        struct Slot {
+            mutable std::atomic<uint32_t> readers{0};
+            Ptr value;
+        };
+
+        // Caller holds m_writerMutex
+        void publish(Ptr value) {
+            const uint64_t current = m_current.load(std::memory_order_relaxed);
+            const uint64_t currentIndex = current & SLOT_MASK;
+            for (uint64_t index = (currentIndex + 1) & SLOT_MASK;; index = (index + 1) & SLOT_MASK) {
+                if (index == currentIndex) {
+                    // Every other slot is pinned by a reader halfway through load()
+                    std::this_thread::yield();
+                    continue;
+                }
+                Slot& slot = m_slots[index];
+                if (slot.readers.load(std::memory_order_seq_cst) != 0) {
+                    continue;
+                }
+                slot.value = std::move(value);
+                // The version in the upper bits tells a reused slot from the one a reader pinned
+                m_current.store((((current >> SLOT_BITS) + 1) << SLOT_BITS) | index, std::memory_order_seq_cst);
+                break;
+            }
+
+            // Let go of the older values, so a logged out user does not linger in a spare slot;
+            // one still pinned is released by a later store
+            const uint64_t published = m_current.load(std::memory_order_relaxed) & SLOT_MASK;
+            for (uint64_t index = 0; index < SLOT_COUNT; ++index) {
+                if (index != published && m_slots[index].readers.load(std::memory_order_seq_cst) == 0) {
+                    m_slots[index].value.reset();
+                }
+            }
+        }
+
+        Slot m_slots[SLOT_COUNT];
+        std::atomic<uint64_t> m_current;
+        std::mutex m_writerMutex;
+    };
+}
@@ -0,0 +1,282 @@
+#include "Tech3CStandInServer.h"
+
+#if TECH3C_DESKTOP_BACKEND
+
+#include "Tech3CHttp.h"
+#include "Tech3CJson.h"
+#include "Tech3CTypes.h"
+#include <chrono>
+#include <poll.h>
+#include <random>
+#include <sys/socket.h>
+
+using namespace tech3c;
+
+namespace {
+    const std::chrono::milliseconds IDLE_TIMEOUT(30000);
+    const std::chrono::milliseconds SEND_TIMEOUT(5000);
+
+    std::string errorBody(const char* message) {
+        std::string body = "{";
+        json::appendField(body, "error", message);
+        body += "}";
+        return body;
+    }
+
+    int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+}
+
+StandInAuthServer::StandInAuthServer()
+        : m_listenFd(-1)
+        , m_port(0)
+        , m_requestCount(0)
+        , m_stopping(false)
+        , m_nextUserId(1)
+        , m_tokenCounter(0) {
+}
+
+StandInAuthServer::~StandInAuthServer() {
+    stop();
+}
+
+bool StandInAuthServer::start(uint16_t port) {
+    if (m_listenFd >= 0) {
+        return true;
+    }
+
+    m_port = port;
+    m_stopping.store(false, std::memory_order_relaxed);
+    m_listenFd = http::listenTcp("127.0.0.1", m_port);
+    if (m_listenFd < 0) {
+        return false;
+    }
+
+    m_acceptThread = std::thread(&StandInAuthServer::acceptLoop, this);
+    return true;
+}
+
+void StandInAuthServer::stop() {
+    if (m_listenFd < 0) {
+        return;
+    }
+
+    // Stop accepting, unblock every connection read, then wait for the threads
+    m_stopping.store(true, std::memory_order_release);
+    if (m_acceptThread.joinable()) {
+        m_acceptThread.join();
+    }
+    http::closeSocket(m_listenFd);
+    m_listenFd = -1;
+
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int fd : m_connections) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+        threads.swap(m_connectionThreads);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+std::string StandInAuthServer::getUrl() const {
+    return "http://127.0.0.1:" + std::to_string(m_port);
+}
+
+void StandInAuthServer::setOptions(const Options& options) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options = options;
+}
+
+StandInAuthServer::Options StandInAuthServer::getOptions() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_options;
+}
+
+void StandInAuthServer::acceptLoop() {
+    while (!m_stopping.load(std::memory_order_acquire)) {
+        // Poll with a short timeout, shutdown() does not wake accept() on every platform
+        pollfd pfd = { m_listenFd, POLLIN, 0 };
+        if (::poll(&pfd, 1, 100) != 1) {
+            continue;
+        }
+
+        int fd = http::acceptTcp(m_listenFd);
+        if (fd < 0) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_connections.push_back(fd);
+        m_connectionThreads.emplace_back(&StandInAuthServer::serveConnection, this, fd);
+    }
+}
+
+void StandInAuthServer::serveConnection(int fd) {
+    http::Reader reader(fd);
+    http::Message request;
+
+    // Keep-alive: serve requests until the client closes or goes idle
+    while (reader.readRequest(request, IDLE_TIMEOUT)) {
+        m_requestCount.fetch_add(1, std::memory_order_relaxed);
+
+        std::string body;
+        int status = handle(request.method, request.path, request.body, body);
+        if (!http::sendAll(fd, http::buildResponse(status, body, request.keepAlive), SEND_TIMEOUT)
+            || !request.keepAlive) {
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
+        if (*it == fd) {
+            m_connections.erase(it);
+            break;
+        }
+    }
+    http::closeSocket(fd);
+}
+
+int StandInAuthServer::handle(const std::string& method, const std::string& path, const std::string& body,
+                              std::string& response) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (m_options.failRequests > 0) {
+        --m_options.failRequests;
+        response = errorBody("Internal server error");
+        return 500;
+    }
+
+    if (method == "GET" && path.compare(0, 15, "/v1/maintenance") == 0) {
+        response = "{";
+        json::appendBool(response, "maintenance", m_options.maintenance);
+        response += "}";
+        return 200;
+    }
+
+    if (method != "POST") {
+        response = errorBody("Not found");
+        return 404;
+    }
+
+    if (path == "/v1/auth/init") {
+        std::string_view clientId, clientSecret;
+        if (!json::getString(body, "clientId", clientId) || clientId.empty()
+            || !json::getString(body, "clientSecret", clientSecret) || clientSecret.empty()) {
+            response = errorBody("Client ID or Client Secret is empty");
+            return 400;
+        }
+        if (!m_options.clientSecret.empty() && clientSecret != m_options.clientSecret) {
+            response = errorBody("Invalid client credentials");
+            return 401;
+        }
+        response = "{";
+        json::appendBool(response, "ok", true);
+        response += "}";
+        return 200;
+    }
+
+    if (m_options.maintenance) {
+        response = "{";
+        json::appendField(response, "error", "Server is under maintenance");
+        json::appendBool(response, "maintenance", true);
+        response += "}";
+        return 503;
+    }
+
+    if (path == "/v1/auth/login") {
+        std::string_view flow;
+        json::getString(body, "flow", flow);
+
+        if (flow == "guest") {
+            return issueTokens("guest_" + std::to_string(m_nextUserId++), (int)LoginType::GUEST, response);
+        }
+        if (flow == "social") {
+            return issueTokens("social_" + std::to_string(m_nextUserId++), (int)LoginType::SOCIAL, response);
+        }
+
+        std::string_view username, password;
+        if (!json::getString(body, "username", username) || username.empty()
+            || !json::getString(body, "password", password) || password != m_options.accountPassword) {
+            response = errorBody("Invalid username or password");
+            return 401;
+        }
+        return issueTokens("acc_" + std::string(username), (int)LoginType::ACCOUNT, response);
+    }
+
+    if (path == "/v1/auth/register") {
+        std::string_view username, password;
+        if (!json::getString(body, "username", username) || username.empty()
+            || !json::getString(body, "password", password) || password.empty()) {
+            response = errorBody("Username and password are required");
+            return 400;
+        }
+        return issueTokens("acc_" + std::string(username), (int)LoginType::ACCOUNT, response);
+    }
+
+    if (path == "/v1/auth/refresh") {
+        std::string_view refreshToken;
+        json::getString(body, "refreshToken", refreshToken);
+        auto it = m_refreshTokens.find(std::string(refreshToken));
+        if (it == m_refreshTokens.end()) {
+            response = errorBody("Invalid refresh token");
+            return 401;
+        }
+        std::string userId = it->second;
+        m_refreshTokens.erase(it);
+        return issueTokens(userId, m_loginTypes[userId], response);
+    }
+
+    if (path == "/v1/auth/logout") {
+        std::string_view refreshToken;
+        json::getString(body, "refreshToken", refreshToken);
+        m_refreshTokens.erase(std::string(refreshToken));
+        response = "{";
+        json::appendBool(response, "ok", true);
+        response += "}";
+        return 200;
+    }
+
+    response = errorBody("Not found");
+    return 404;
+}
+
+int StandInAuthServer::issueTokens(const std::string& userId, int loginType, std::string& response) {
+    std::string accessToken = randomToken(48);
+    std::string refreshToken = randomToken(32);
+    m_refreshTokens[refreshToken] = userId;
+    m_loginTypes[userId] = loginType;
+
+    response = "{";
+    json::appendField(response, "userId", userId);
+    json::appendField(response, "accessToken", accessToken);
+    json::appendField(response, "refreshToken", refreshToken);
+    json::appendInt(response, "loginType", loginType);
+    const int64_t serverTime = nowMs() + m_options.clockOffsetMs;
+    json::appendInt(response, "expiryTime", serverTime + m_options.tokenLifetimeMs);
+    json::appendInt(response, "serverTime", serverTime);
+    response += "}";
+    return 200;
+}
+
+std::string StandInAuthServer::randomToken(size_t length) {
+    static const char* HEX = "0123456789abcdef";
+    static thread_local std::mt19937_64 rng(std::random_device{}() ^ (uint64_t)nowMs());
+
+    std::string token = std::to_string(++m_tokenCounter) + ".";
+    while (token.size() < length) {
+        uint64_t bits = rng();
+        for (int i = 0; i < 16 && token.size() < length; ++i, bits >>= 4) {
+            token += HEX[bits & 0xf];
+        }
+    }
+    return token;
+}
+
+#endif
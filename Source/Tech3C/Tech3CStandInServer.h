@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Tech3CPlatform.h"
+
+#if TECH3C_DESKTOP_BACKEND
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace tech3c {
+
+    // Local stand-in for the Tech3C auth service so desktop builds can run the whole
+    // login flow without the mobile SDK. Serves a small JSON API on 127.0.0.1:
+    //   POST /v1/auth/init      {clientId, clientSecret}
+    //   POST /v1/auth/login     {flow: guest|account|social, username, password}
+    //   POST /v1/auth/register  {username, password}
+    //   POST /v1/auth/refresh   {refreshToken}
+    //   POST /v1/auth/logout    {refreshToken}
+    //   GET  /v1/maintenance
+    // Token responses carry {userId, accessToken, refreshToken, loginType, expiryTime, serverTime},
+    // times in epoch milliseconds of the server clock.
+    // Under maintenance everything but init and the maintenance query answers 503 {error, maintenance}.
+    // failRequests makes the next requests, whatever they are, answer 500 as a failing backend would.
+    class StandInAuthServer {
+    public:
+        struct Options {
+            std::string clientSecret;           // Required secret, empty accepts any
+            std::string accountPassword;        // Password accepted for account logins
+            int64_t tokenLifetimeMs;
+            int64_t clockOffsetMs;              // Server clock minus device clock, to simulate skew
+            bool maintenance;
+            int failRequests;                   // Counts down as requests fail
+
+            Options()
+                : accountPassword("password")
+                , tokenLifetimeMs(3600 * 1000)
+                , clockOffsetMs(0)
+                , maintenance(false)
+                , failRequests(0) {}
+        };
+
+        StandInAuthServer();
+        ~StandInAuthServer();
+
+        // Binds to 127.0.0.1 on the given port (0 picks a free one) and starts serving
+        bool start(uint16_t port = 0);
+        void stop();
+
+        bool isRunning() const { return m_listenFd >= 0; }
+        uint16_t getPort() const { return m_port; }
+        std::string getUrl() const;
+
+        // Options may be changed while running, e.g. to flip maintenance mode
+        void setOptions(const Options& options);
+        Options getOptions() const;
+
+        uint64_t getRequestCount() const { return m_requestCount.load(std::memory_order_relaxed); }
+
+    private:
+        StandInAuthServer(const StandInAuthServer&) = delete;
+        StandInAuthServer& operator=(const StandInAuthServer&) = delete;
+
+        void acceptLoop();
+        void serveConnection(int fd);
+        int handle(const std::string& method, const std::string& path, const std::string& body, std::string& response);
+        int issueTokens(const std::string& userId, int loginType, std::string& response);
+        std::string randomToken(size_t length);
+
+        int m_listenFd;
+        uint16_t m_port;
+        std::thread m_acceptThread;
+        std::atomic<uint64_t> m_requestCount;
+        std::atomic<bool> m_stopping;
+
+        mutable std::mutex m_mutex;
+        Options m_options;
+        std::vector<int> m_connections;
+        std::vector<std::thread> m_connectionThreads;
+        std::unordered_map<std::string, std::string> m_refreshTokens; // refreshToken -> userId
+        std::unordered_map<std::string, int> m_loginTypes;             // userId -> loginType
+        uint64_t m_nextUserId;
+        uint64_t m_tokenCounter;
+    };
+}
+
+#endif
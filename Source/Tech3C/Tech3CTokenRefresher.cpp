@@ -0,0 +1,172 @@
+#include "Tech3CTokenRefresher.h"
+#include "Tech3CTrace.h"
+#include <algorithm>
+
+using namespace tech3c;
+
+namespace {
+    // Re-check the wall clock at least this often, it may jump while we sleep (NTP, user change)
+    const int64_t MAX_WAIT_MS = 30000;
+}
+
+//========================================================================
+// ClockSkewEstimator
+
+void ClockSkewEstimator::addSample(int64_t serverTimeMs, int64_t requestSentMs, int64_t responseReceivedMs) {
+    const int64_t sample = serverTimeMs - (requestSentMs + responseReceivedMs) / 2;
+    if (!m_hasSample.load(std::memory_order_relaxed)) {
+        m_offsetMs.store(sample, std::memory_order_relaxed);
+        m_hasSample.store(true, std::memory_order_relaxed);
+        return;
+    }
+
+    // Smooth out network jitter, a real clock change still converges within a few refreshes
+    const int64_t offset = m_offsetMs.load(std::memory_order_relaxed);
+    m_offsetMs.store(offset + (sample - offset) / 4, std::memory_order_relaxed);
+}
+
+void ClockSkewEstimator::reset() {
+    m_offsetMs.store(0, std::memory_order_relaxed);
+    m_hasSample.store(false, std::memory_order_relaxed);
+}
+
+//========================================================================
+// RefreshTimer
+
+RefreshTimer::RefreshTimer(WorkerPool* pool)
+        : m_pool(pool)
+        , m_running(false)
+        , m_inlineTask(nullptr) {
+}
+
+RefreshTimer::~RefreshTimer() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void RefreshTimer::arm(TokenRefreshScheduler* scheduler, int64_t deadlineMs) {
+    scheduler->m_entry = m_entries.emplace(deadlineMs, scheduler);
+
+    // Started on first use, most sessions never get this far
+    if (!m_running) {
+        m_running = true;
+        m_thread = std::thread(&RefreshTimer::run, this);
+    }
+    if (scheduler->m_entry == m_entries.begin()) {
+        m_condition.notify_one();
+    }
+}
+
+void RefreshTimer::disarm(TokenRefreshScheduler* scheduler) {
+    if (scheduler->m_hasTask) {
+        m_entries.erase(scheduler->m_entry);
+        scheduler->m_entry = m_entries.end();
+    }
+}
+
+void RefreshTimer::run() {
+    Tracer::getInstance().setThreadName("tech3c token refresh");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running) {
+        if (m_entries.empty()) {
+            m_condition.wait(lock);
+            continue;
+        }
+
+        const int64_t now = deviceTimeMs();
+        const int64_t deadline = m_entries.begin()->first;
+        if (now < deadline) {
+            const int64_t waitMs = std::min(deadline - now, MAX_WAIT_MS);
+            m_condition.wait_for(lock, std::chrono::milliseconds(waitMs));
+            continue;
+        }
+
+        TokenRefreshScheduler* scheduler = m_entries.begin()->second;
+        m_entries.erase(m_entries.begin());
+        scheduler->m_entry = m_entries.end();
+        scheduler->m_hasTask = false;
+        TokenRefreshScheduler::Task task = std::move(scheduler->m_task);
+        scheduler->m_task = nullptr;
+
+        if (scheduler->m_runner) {
+            // stop() waits for the runner, so the scheduler outlives the posted task
+            scheduler->m_runner->post(std::move(task));
+            continue;
+        }
+
+        m_inlineTask = scheduler;
+        lock.unlock();
+
+        task();
+        task = nullptr;
+
+        lock.lock();
+        m_inlineTask = nullptr;
+        m_taskDone.notify_all();
+    }
+}
+
+//========================================================================
+// TokenRefreshScheduler
+
+TokenRefreshScheduler::TokenRefreshScheduler(RefreshTimer* timer)
+        : m_ownTimer(timer ? nullptr : new RefreshTimer())
+        , m_timer(timer ? timer : m_ownTimer.get())
+        , m_hasTask(false)
+        , m_entry(m_timer->m_entries.end()) {
+    if (m_timer->m_pool) {
+        m_runner.reset(new Worker("tech3c token refresh", m_timer->m_pool));
+    }
+}
+
+TokenRefreshScheduler::~TokenRefreshScheduler() {
+    stop();
+}
+
+void TokenRefreshScheduler::scheduleAt(int64_t deadlineMs, Task task) {
+    std::lock_guard<std::mutex> lock(m_timer->m_mutex);
+    cancelLocked();
+    m_task = std::move(task);
+    m_hasTask = true;
+    m_timer->arm(this, deadlineMs);
+}
+
+void TokenRefreshScheduler::cancel() {
+    std::lock_guard<std::mutex> lock(m_timer->m_mutex);
+    cancelLocked();
+}
+
+void TokenRefreshScheduler::cancelLocked() {
+    m_timer->disarm(this);
+    m_hasTask = false;
+    m_task = nullptr;
+}
+
+void TokenRefreshScheduler::stop() {
+    {
+        std::unique_lock<std::mutex> lock(m_timer->m_mutex);
+        cancelLocked();
+        // A task running on the timer thread may still use whatever it captured
+        if (m_timer->m_thread.get_id() != std::this_thread::get_id()) {
+            m_timer->m_taskDone.wait(lock, [this]() { return m_timer->m_inlineTask != this; });
+        }
+        // The task may have scheduled itself again meanwhile
+        cancelLocked();
+    }
+    if (m_runner) {
+        m_runner->stop();
+        cancel();
+    }
+}
+
+bool TokenRefreshScheduler::isPending() const {
+    std::lock_guard<std::mutex> lock(m_timer->m_mutex);
+    return m_hasTask;
+}
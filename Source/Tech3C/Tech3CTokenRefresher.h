@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Tech3CWorker.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace tech3c {
+
+    // Estimates the offset between the auth server clock and the device clock from timestamped
+    // responses, so server-issued expiry times can be turned into device deadlines.
+    class ClockSkewEstimator {
+    public:
+        ClockSkewEstimator() : m_offsetMs(0), m_hasSample(false) {}
+
+        // serverTimeMs was read from the response to a request sent at requestSentMs and received
+        // at responseReceivedMs (device clock); the server is assumed to answer half way through.
+        void addSample(int64_t serverTimeMs, int64_t requestSentMs, int64_t responseReceivedMs);
+        void reset();
+
+        // Server clock minus device clock
+        int64_t getOffsetMs() const { return m_offsetMs.load(std::memory_order_relaxed); }
+        bool hasSample() const { return m_hasSample.load(std::memory_order_relaxed); }
+        int64_t toDeviceTime(int64_t serverTimeMs) const { return serverTimeMs - getOffsetMs(); }
+
+    private:
+        std::atomic<int64_t> m_offsetMs;
+        std::atomic<bool> m_hasSample;
+    };
+
+    class TokenRefreshScheduler;
+
+    // One thread waking many TokenRefreshSchedulers at their deadlines. With a pool the due tasks
+    // run on a Worker of their scheduler, so a refresh stuck on the network never delays another
+    // session's; without one they run on the timer thread itself.
+    class RefreshTimer {
+    public:
+        // pool must outlive the timer and its schedulers
+        explicit RefreshTimer(WorkerPool* pool = nullptr);
+        // Every scheduler using the timer must be gone by now
+        ~RefreshTimer();
+
+    private:
+        friend class TokenRefreshScheduler;
+
+        RefreshTimer(const RefreshTimer&) = delete;
+        RefreshTimer& operator=(const RefreshTimer&) = delete;
+
+        using Entries = std::multimap<int64_t, TokenRefreshScheduler*>;
+
+        // Caller must hold m_mutex
+        void arm(TokenRefreshScheduler* scheduler, int64_t deadlineMs);
+        void disarm(TokenRefreshScheduler* scheduler);
+        void run();
+
+        WorkerPool* m_pool;
+        std::mutex m_mutex;     // Also guards the state of every scheduler on this timer
+        std::condition_variable m_condition;
+        std::condition_variable m_taskDone;
+        std::thread m_thread;
+        bool m_running;
+        Entries m_entries;
+        TokenRefreshScheduler* m_inlineTask;    // Whose task runs on the timer thread right now
+    };
+
+    // Runs a task at a wall clock deadline. Scheduling again replaces the pending task; the task
+    // runs without any scheduler lock held and may reschedule itself.
+    class TokenRefreshScheduler {
+    public:
+        using Task = std::function<void()>;
+
+        // On a timer shared with other schedulers, which must outlive this one; null runs on a
+        // thread of its own, started on first use
+        explicit TokenRefreshScheduler(RefreshTimer* timer = nullptr);
+        ~TokenRefreshScheduler();
+
+        // deadlineMs is device epoch milliseconds, a deadline in the past runs right away
+        void scheduleAt(int64_t deadlineMs, Task task);
+        void cancel();
+        // Cancels and waits for a running task; never call from a task
+        void stop();
+
+        bool isPending() const;
+
+    private:
+        friend class RefreshTimer;
+
+        TokenRefreshScheduler(const TokenRefreshScheduler&) = delete;
+        TokenRefreshScheduler& operator=(const TokenRefreshScheduler&) = delete;
+
+        // Caller must hold the timer mutex
+        void cancelLocked();
+
+        std::unique_ptr<RefreshTimer> m_ownTimer;
+        RefreshTimer* m_timer;
+        // Runs the due task when the timer has a pool
+        std::unique_ptr<Worker> m_runner;
+
+        // Guarded by m_timer->m_mutex
+        bool m_hasTask;
+        Task m_task;
+        RefreshTimer::Entries::iterator m_entry;
+    };
+
+    inline int64_t deviceTimeMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+}
@@ -0,0 +1,252 @@
+#include "Tech3CTrace.h"
+#include "Tech3CJson.h"
+#include "axmol.h"
+#include <cstdio>
+
+USING_NS_AX;
+
+namespace tech3c {
+
+    struct Tracer::ThreadBuffer {
+        // The owning thread appends and publishes with count; readers only look below count
+        std::atomic<uint32_t> generation;
+        std::atomic<size_t> count;
+        std::atomic<bool> inUse;
+        std::atomic<const char*> name;
+        uint32_t threadId;
+        TraceEvent events[EVENTS_PER_THREAD];
+
+        ThreadBuffer(uint32_t id) : generation(0), count(0), inUse(true), name(nullptr), threadId(id) {}
+    };
+
+    // Hands the buffer back when its thread exits, the events stay exportable
+    struct ThreadBufferHolder {
+        Tracer::ThreadBuffer* buffer = nullptr;
+        const char* name = nullptr;
+        ~ThreadBufferHolder() {
+            if (buffer) {
+                buffer->inUse.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    namespace {
+        thread_local ThreadBufferHolder t_buffer;
+
+        const char* FRAME_CATEGORY = "frame";
+    }
+
+    Tracer& Tracer::getInstance() {
+        // Never destroyed, threads may still trace during static destruction
+        static Tracer* tracer = new Tracer();
+        return *tracer;
+    }
+
+    Tracer::Tracer()
+            : m_enabled(false)
+            , m_generation(1)
+            , m_nextFlowId(1)
+            , m_dropped(0)
+            , m_frameListeners{nullptr, nullptr, nullptr}
+            , m_frameStartUs(0)
+            , m_updateEndUs(0) {
+    }
+
+    void Tracer::start() {
+        m_generation.fetch_add(1, std::memory_order_acq_rel);
+        m_dropped.store(0, std::memory_order_relaxed);
+        m_enabled.store(true, std::memory_order_release);
+    }
+
+    void Tracer::stop() {
+        m_enabled.store(false, std::memory_order_release);
+    }
+
+    void Tracer::setThreadName(const char* name) {
+        // Kept until the thread records its first event, threads that never trace cost nothing
+        t_buffer.name = name;
+        if (t_buffer.buffer) {
+            t_buffer.buffer->name.store(name, std::memory_order_release);
+        }
+    }
+
+    void Tracer::traceFrames(bool enable) {
+        auto dispatcher = Director::getInstance()->getEventDispatcher();
+        for (void*& listener : m_frameListeners) {
+            if (listener) {
+                dispatcher->removeEventListener(static_cast<EventListener*>(listener));
+                listener = nullptr;
+            }
+        }
+        m_frameStartUs = 0;
+        if (!enable) {
+            return;
+        }
+
+        m_frameListeners[0] = dispatcher->addCustomEventListener(Director::EVENT_BEFORE_UPDATE, [this](EventCustom*) {
+            m_frameStartUs = isEnabled() ? nowUs() : 0;
+        });
+        m_frameListeners[1] = dispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom*) {
+            if (m_frameStartUs != 0) {
+                m_updateEndUs = nowUs();
+                complete(FRAME_CATEGORY, "update", m_frameStartUs, m_updateEndUs);
+            }
+        });
+        m_frameListeners[2] = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom*) {
+            if (m_frameStartUs != 0 && isEnabled()) {
+                const int64_t now = nowUs();
+                complete(FRAME_CATEGORY, "render", m_updateEndUs, now);
+                complete(FRAME_CATEGORY, "frame", m_frameStartUs, now);
+            }
+            m_frameStartUs = 0;
+        });
+    }
+
+    void Tracer::complete(const char* category, const char* name, int64_t startUs, int64_t endUs) {
+        if (!isEnabled()) {
+            return;
+        }
+        record(TraceEvent{name, category, startUs, endUs - startUs, 0, 'X'});
+    }
+
+    void Tracer::instant(const char* category, const char* name) {
+        if (!isEnabled()) {
+            return;
+        }
+        record(TraceEvent{name, category, nowUs(), 0, 0, 'i'});
+    }
+
+    uint64_t Tracer::flowBegin(const char* category, const char* name) {
+        if (!isEnabled()) {
+            return 0;
+        }
+        const uint64_t id = m_nextFlowId.fetch_add(1, std::memory_order_relaxed);
+        record(TraceEvent{name, category, nowUs(), 0, id, 's'});
+        return id;
+    }
+
+    void Tracer::flowEnd(const char* category, const char* name, uint64_t flowId) {
+        if (flowId == 0 || !isEnabled()) {
+            return;
+        }
+        record(TraceEvent{name, category, nowUs(), 0, flowId, 'f'});
+    }
+
+    Tracer::ThreadBuffer* Tracer::currentBuffer() {
+        if (t_buffer.buffer) {
+            return t_buffer.buffer;
+        }
+
+        // Once per thread: reuse a buffer of a finished thread if its events are from an older trace
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        const uint32_t generation = m_generation.load(std::memory_order_acquire);
+        for (auto& buffer : m_buffers) {
+            if (!buffer->inUse.load(std::memory_order_acquire)
+                && buffer->generation.load(std::memory_order_relaxed) != generation) {
+                buffer->name.store(t_buffer.name, std::memory_order_relaxed);
+                buffer->inUse.store(true, std::memory_order_relaxed);
+                t_buffer.buffer = buffer.get();
+                return t_buffer.buffer;
+            }
+        }
+        m_buffers.emplace_back(new ThreadBuffer(static_cast<uint32_t>(m_buffers.size() + 1)));
+        t_buffer.buffer = m_buffers.back().get();
+        t_buffer.buffer->name.store(t_buffer.name, std::memory_order_relaxed);
+        return t_buffer.buffer;
+    }
+
+    void Tracer::record(const TraceEvent& event) {
+        ThreadBuffer* buffer = currentBuffer();
+
+        const uint32_t generation = m_generation.load(std::memory_order_acquire);
+        if (buffer->generation.load(std::memory_order_relaxed) != generation) {
+            // First event of a new trace on this thread, drop what the last one left behind
+            buffer->count.store(0, std::memory_order_relaxed);
+            buffer->generation.store(generation, std::memory_order_release);
+        }
+
+        const size_t count = buffer->count.load(std::memory_order_relaxed);
+        if (count >= EVENTS_PER_THREAD) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffer->events[count] = event;
+        buffer->count.store(count + 1, std::memory_order_release);
+    }
+
+    std::string Tracer::toJson() const {
+        const uint32_t generation = m_generation.load(std::memory_order_acquire);
+        std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        auto next = [&out, &first]() -> std::string& {
+            if (!first) {
+                out += ",\n";
+            }
+            first = false;
+            return out;
+        };
+
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        for (const auto& buffer : m_buffers) {
+            if (buffer->generation.load(std::memory_order_acquire) != generation) {
+                continue;
+            }
+            const size_t count = buffer->count.load(std::memory_order_acquire);
+            const std::string tid = std::to_string(buffer->threadId);
+
+            if (const char* name = buffer->name.load(std::memory_order_acquire)) {
+                std::string meta = "{";
+                json::appendField(meta, "name", "thread_name");
+                json::appendField(meta, "ph", "M");
+                json::appendInt(meta, "pid", 1);
+                json::appendInt(meta, "tid", buffer->threadId);
+                std::string args = "{";
+                json::appendField(args, "name", name);
+                args += "}";
+                json::appendRaw(meta, "args", args);
+                meta += "}";
+                next() += meta;
+            }
+
+            for (size_t i = 0; i < count; ++i) {
+                const TraceEvent& event = buffer->events[i];
+                std::string entry = "{";
+                json::appendField(entry, "name", event.name);
+                json::appendField(entry, "cat", event.category);
+                json::appendField(entry, "ph", std::string(1, event.phase));
+                json::appendInt(entry, "ts", event.timestampUs);
+                switch (event.phase) {
+                    case 'X':
+                        json::appendInt(entry, "dur", event.durationUs);
+                        break;
+                    case 'i':
+                        json::appendField(entry, "s", "t");
+                        break;
+                    case 'f':
+                        // Bind to the enclosing slice, i.e. the span that handles the event
+                        json::appendField(entry, "bp", "e");
+                        json::appendInt(entry, "id", static_cast<int64_t>(event.flowId));
+                        break;
+                    default:
+                        json::appendInt(entry, "id", static_cast<int64_t>(event.flowId));
+                        break;
+                }
+                entry += ",\"pid\":1,\"tid\":" + tid + "}";
+                next() += entry;
+            }
+        }
+
+        out += "]}";
+        return out;
+    }
+
+    bool Tracer::writeJson(const std::string& path) const {
+        std::string json = toJson();
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+        return std::fclose(file) == 0 && ok;
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 0 compiles the TECH3C_TRACE_* macros out of the binary
+#ifndef TECH3C_TRACING
+#define TECH3C_TRACING 1
+#endif
+
+namespace tech3c {
+
+    struct TraceEvent {
+        const char* name;       // String literals only, events keep the pointer
+        const char* category;
+        int64_t timestampUs;
+        int64_t durationUs;     // 'X' events
+        uint64_t flowId;        // 's' / 'f' events
+        char phase;             // Chrome trace phase: 'X' complete, 'i' instant, 's' / 'f' flow
+    };
+
+    // Records spans into per-thread buffers and exports them as Chrome Trace Event JSON, which
+    // chrome://tracing and ui.perfetto.dev open directly. Off until start(); while off every
+    // probe is a single relaxed load. Recording never locks or allocates once a thread has its
+    // buffer, a full buffer drops events (getDroppedCount()).
+    class Tracer {
+    public:
+        static constexpr size_t EVENTS_PER_THREAD = 8192;
+
+        static Tracer& getInstance();
+
+        // Discards the previous trace and starts recording
+        void start();
+        void stop();
+        bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+        // Label for the calling thread in the trace, must outlive the tracer (a literal); cheap enough
+        // to call at thread start whether or not tracing is on
+        void setThreadName(const char* name);
+
+        // Spans of the axmol main loop (update / render / frame) from the Director's events
+        void traceFrames(bool enable);
+
+        void complete(const char* category, const char* name, int64_t startUs, int64_t endUs);
+        void instant(const char* category, const char* name);
+        // Links an event handed to another thread with where it is handled, 0 while disabled
+        uint64_t flowBegin(const char* category, const char* name);
+        void flowEnd(const char* category, const char* name, uint64_t flowId);
+
+        // Events recorded since start(), readable while other threads keep recording
+        std::string toJson() const;
+        bool writeJson(const std::string& path) const;
+
+        uint64_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+        static int64_t nowUs() {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        struct ThreadBuffer;
+        friend struct ThreadBufferHolder;
+
+        Tracer();
+        Tracer(const Tracer&) = delete;
+        Tracer& operator=(const Tracer&) = delete;
+
+        void record(const TraceEvent& event);
+        ThreadBuffer* currentBuffer();
+
+        std::atomic<bool> m_enabled;
+        std::atomic<uint32_t> m_generation;
+        std::atomic<uint64_t> m_nextFlowId;
+        std::atomic<uint64_t> m_dropped;
+
+        // Buffers outlive their threads so a trace still shows threads that have finished
+        mutable std::mutex m_buffersMutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+
+        // traceFrames() state, axmol thread only
+        void* m_frameListeners[3];
+        int64_t m_frameStartUs;
+        int64_t m_updateEndUs;
+    };
+
+    // Records its own lifetime as a complete event
+    class TraceScope {
+    public:
+        TraceScope(const char* category, const char* name)
+                : m_category(category), m_name(name)
+                , m_startUs(Tracer::getInstance().isEnabled() ? Tracer::nowUs() : 0) {}
+        ~TraceScope() {
+            if (m_startUs != 0) {
+                Tracer::getInstance().complete(m_category, m_name, m_startUs, Tracer::nowUs());
+            }
+        }
+
+    private:
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+        const char* m_category;
+        const char* m_name;
+        int64_t m_startUs;
+    };
+}
+
+#define TECH3C_TRACE_CONCAT_INNER(a, b) a##b
+#define TECH3C_TRACE_CONCAT(a, b) TECH3C_TRACE_CONCAT_INNER(a, b)
+
+#if TECH3C_TRACING
+// TECH3C_TRACE_SCOPE("sdk", "Tech3CManager::initialize"); traces until the end of the block
+#define TECH3C_TRACE_SCOPE(category, name) \
+    ::tech3c::TraceScope TECH3C_TRACE_CONCAT(tech3cTraceScope, __LINE__)(category, name)
+#define TECH3C_TRACE_INSTANT(category, name) \
+    do { if (::tech3c::Tracer::getInstance().isEnabled()) ::tech3c::Tracer::getInstance().instant(category, name); } while (0)
+#else
+#define TECH3C_TRACE_SCOPE(category, name) do {} while (0)
+#define TECH3C_TRACE_INSTANT(category, name) do {} while (0)
+#endif
@@ -1,7 +1,15 @@
 #pragma once
 
+#include "Tech3CFixedString.h"
+#include "Tech3CInplaceFunction.h"
 #include <string>
 #include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 namespace tech3c {
 
@@ -35,16 +43,57 @@ namespace tech3c {
         LANDSCAPE = 2
     };
 
-    // User Information
+    // SDK lifecycle, see Tech3CSession::getLifecycleState
+    //   UNINITIALIZED -> INITIALIZING -> READY / LOGGED_IN     initialize()
+    //   READY / LOGGED_IN -> AUTHENTICATING                    showAuth()
+    //   AUTHENTICATING -> LOGGED_IN                            login / register success
+    //   AUTHENTICATING -> READY / LOGGED_IN                    auth error or cancel
+    //   AUTHENTICATING / LOGGED_IN -> READY                    logout()
+    //   any -> SHUTTING_DOWN -> UNINITIALIZED                  cleanup()
+    enum class LifecycleState : uint8_t {
+        UNINITIALIZED = 0,
+        INITIALIZING,
+        READY,
+        AUTHENTICATING,
+        LOGGED_IN,
+        SHUTTING_DOWN
+    };
+
+    // Sets of lifecycle states as bit masks
+    constexpr uint32_t lifecycleStateBit(LifecycleState state) { return 1u << static_cast<uint32_t>(state); }
+
+    // Longest values UserInfo stores, sized for the tokens the Tech3C servers issue
+    constexpr size_t USER_ID_CAPACITY = 128;
+    constexpr size_t ACCESS_TOKEN_CAPACITY = 2048;
+    constexpr size_t REFRESH_TOKEN_CAPACITY = 1024;
+
+    // User Information. Stored inline and trivially copyable: copies for callbacks, snapshots
+    // and the event queue are a memcpy, never an allocation.
     struct UserInfo {
-        std::string userId;
-        std::string accessToken;
-        std::string refreshToken;
+        FixedString<USER_ID_CAPACITY> userId;
+        FixedString<ACCESS_TOKEN_CAPACITY> accessToken;
+        FixedString<REFRESH_TOKEN_CAPACITY> refreshToken;
         LoginType loginType;
-        long expiryTime;
+        int64_t expiryTime;             // Unix epoch milliseconds, server clock
 
         UserInfo() : loginType(LoginType::GUEST), expiryTime(0) {}
 
+        std::string_view getUserId() const { return userId.view(); }
+        std::string_view getAccessToken() const { return accessToken.view(); }
+        std::string_view getRefreshToken() const { return refreshToken.view(); }
+
+        // Returns false, leaving the user unchanged, if a value exceeds its capacity
+        bool setCredentials(std::string_view id, std::string_view access, std::string_view refresh) {
+            if (id.size() > userId.capacity() || access.size() > accessToken.capacity()
+                || refresh.size() > refreshToken.capacity()) {
+                return false;
+            }
+            userId.assign(id);
+            accessToken.assign(access);
+            refreshToken.assign(refresh);
+            return true;
+        }
+
         bool isValid() const {
             return !userId.empty() && !accessToken.empty();
         }
@@ -57,6 +106,10 @@ namespace tech3c {
             expiryTime = 0;
         }
     };
+    static_assert(std::is_trivially_copyable_v<UserInfo>, "UserInfo must stay memcpy-copyable");
+
+    // Immutable view of the current user, see Tech3CSession::getUserSnapshot
+    using UserSnapshot = std::shared_ptr<const UserInfo>;
 
     // Error Information
     struct ErrorInfo {
@@ -69,12 +122,33 @@ namespace tech3c {
             : code(c), message(msg), details(det) {}
     };
 
-    // Callback Types
-    using LoginSuccessCallback = std::function<void(const UserInfo& userInfo)>;
-    using RegisterSuccessCallback = std::function<void(const UserInfo& userInfo)>;
-    using ErrorCallback = std::function<void(const ErrorInfo& error)>;
-    using CancelCallback = std::function<void()>;
-    using AuthScreenOpenedCallback = std::function<void()>;
+    // Outcome of one access token refresh
+    struct TokenRefreshResult {
+        bool success;
+        std::string accessToken;
+        std::string refreshToken;       // Empty keeps the current refresh token
+        int64_t expiryTime;             // Unix epoch milliseconds, server clock
+        int64_t serverTime;             // Server clock when it answered, epoch ms, 0 if unknown
+        std::string error;
+        // Failures only. False when trying again cannot help (e.g. the refresh token was revoked),
+        // the session then waits for a new login instead of retrying
+        bool retryable;
+        int64_t retryAfterMs;           // Failed fast on an open circuit breaker: until its next trial
+
+        TokenRefreshResult() : success(false), expiryTime(0), serverTime(0), retryable(true), retryAfterMs(0) {}
+    };
+
+    // Callback Types. Stored inline so delivering an event never allocates: a lambda may capture
+    // up to CALLBACK_CAPACITY bytes (this plus a few pointers), larger captures fail to compile.
+    constexpr size_t CALLBACK_CAPACITY = 8 * sizeof(void*);
+    using LoginSuccessCallback = InplaceFunction<void(const UserInfo& userInfo), CALLBACK_CAPACITY>;
+    using RegisterSuccessCallback = InplaceFunction<void(const UserInfo& userInfo), CALLBACK_CAPACITY>;
+    using ErrorCallback = InplaceFunction<void(const ErrorInfo& error), CALLBACK_CAPACITY>;
+    using CancelCallback = InplaceFunction<void(), CALLBACK_CAPACITY>;
+    using AuthScreenOpenedCallback = InplaceFunction<void(), CALLBACK_CAPACITY>;
+    using TokenRefreshedCallback = InplaceFunction<void(const UserInfo& userInfo), CALLBACK_CAPACITY>;
+    // Renews the tokens of user, called on the token refresh thread and may block
+    using TokenRefreshHandler = std::function<TokenRefreshResult(const UserInfo& user)>;
 
     // Configuration
     struct Config {
@@ -88,6 +162,9 @@ namespace tech3c {
         bool disableExitLogin;
         bool requireOtp;
         bool enableMaintenanceCheck;
+        // One IP, or a comma-separated list of maintenance endpoints: the desktop backend probes them
+        // all at once, the native SDKs take the first
+        std::string ipMaintenanceCheck;
         bool enableRequireBOD;
 
         Config()
@@ -102,10 +179,61 @@ namespace tech3c {
             , enableRequireBOD(true) {}
     };
 
+    // Config fields, used as a bit mask when pushing changes across the bridge.
+    // Keep in sync with Tech3CHelper.applyConfig and tech3c_ios_applyConfig.
+    enum ConfigField : uint32_t {
+        CONFIG_FIELD_DEBUG_MODE = 1u << 0,
+        CONFIG_FIELD_UI_MODE = 1u << 1,
+        CONFIG_FIELD_LANGUAGE = 1u << 2,
+        CONFIG_FIELD_ORIENTATION = 1u << 3,
+        CONFIG_FIELD_GUEST_LOGIN = 1u << 4,
+        CONFIG_FIELD_DISABLE_EXIT_LOGIN = 1u << 5,
+        CONFIG_FIELD_REQUIRE_OTP = 1u << 6,
+        CONFIG_FIELD_MAINTENANCE_CHECK = 1u << 7,
+        CONFIG_FIELD_IP_MAINTENANCE_CHECK = 1u << 8,
+        CONFIG_FIELD_REQUIRE_BOD = 1u << 9,
+        CONFIG_FIELD_ALL = (1u << 10) - 1
+    };
+
+    // Comma-separated form of an endpoint list, as Config::ipMaintenanceCheck holds it
+    std::string joinEndpoints(const std::vector<std::string>& endpoints);
+    // The first entry of such a list, trimmed
+    std::string_view firstEndpoint(std::string_view endpoints);
+
+    // Builder for a complete Config, applied with Tech3CSession::applyConfig
+    class ConfigBuilder {
+    public:
+        ConfigBuilder() = default;
+        explicit ConfigBuilder(const Config& base) : m_config(base) {}
+
+        ConfigBuilder& debugMode(bool debug) { m_config.debugMode = debug; return *this; }
+        ConfigBuilder& uiMode(UiMode mode) { m_config.uiMode = mode; return *this; }
+        ConfigBuilder& language(Language lang) { m_config.language = lang; return *this; }
+        ConfigBuilder& orientation(OrientationMode mode) { m_config.orientation = mode; return *this; }
+        ConfigBuilder& enableGuestLogin(bool enable) { m_config.enableGuestLogin = enable; return *this; }
+        ConfigBuilder& disableExitLogin(bool disable) { m_config.disableExitLogin = disable; return *this; }
+        ConfigBuilder& requireOtp(bool require) { m_config.requireOtp = require; return *this; }
+        ConfigBuilder& enableMaintenanceCheck(bool enable) { m_config.enableMaintenanceCheck = enable; return *this; }
+        ConfigBuilder& ipMaintenanceCheck(const std::string& ip) { m_config.ipMaintenanceCheck = ip; return *this; }
+        ConfigBuilder& maintenanceEndpoints(const std::vector<std::string>& endpoints) {
+            m_config.ipMaintenanceCheck = joinEndpoints(endpoints);
+            return *this;
+        }
+        ConfigBuilder& enableRequireBOD(bool enable) { m_config.enableRequireBOD = enable; return *this; }
+
+        // A copy, so the result outlives a temporary builder
+        Config build() const { return m_config; }
+
+    private:
+        Config m_config;
+    };
+
     // Helper functions
+    uint32_t diffConfig(const Config& from, const Config& to);
     std::string loginTypeToString(LoginType type);
     LoginType stringToLoginType(const std::string& str);
     std::string languageToString(Language lang);
     std::string uiModeToString(UiMode mode);
     std::string orientationModeToString(OrientationMode mode);
+    std::string lifecycleStateToString(LifecycleState state);
 }
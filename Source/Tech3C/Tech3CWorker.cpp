@@ -0,0 +1,191 @@
+#include "Tech3CWorker.h"
+#include "Tech3CTrace.h"
+
+using namespace tech3c;
+
+//========================================================================
+// WorkerPool
+
+WorkerPool::WorkerPool(const char* name, size_t threadCount)
+        : m_name(name)
+        , m_threadCount(threadCount > 0 ? threadCount : 1)
+        , m_stopping(false) {
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::schedule(Worker* worker) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready.push_back(worker);
+        // Started on first use, a host whose sessions never call the bridge costs no threads
+        if (m_threads.empty()) {
+            m_threads.reserve(m_threadCount);
+            for (size_t i = 0; i < m_threadCount; ++i) {
+                m_threads.emplace_back(&WorkerPool::run, this);
+            }
+        }
+    }
+    m_condition.notify_one();
+}
+
+void WorkerPool::run() {
+    Tracer::getInstance().setThreadName(m_name);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_condition.wait(lock, [this]() { return m_stopping || !m_ready.empty(); });
+        if (m_ready.empty()) {
+            break;
+        }
+
+        Worker* worker = m_ready.front();
+        m_ready.pop_front();
+        lock.unlock();
+
+        worker->runQueued();
+
+        lock.lock();
+    }
+}
+
+//========================================================================
+// Worker
+
+Worker::Worker(const char* name, WorkerPool* pool)
+        : m_name(name)
+        , m_pool(pool)
+        , m_threadId(std::thread::id())
+        , m_running(false)
+        , m_stopRequested(false)
+        , m_scheduled(false)
+        , m_posted(0)
+        , m_completed(0) {
+}
+
+Worker::~Worker() {
+    stop();
+}
+
+void Worker::post(Task task) {
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+        ++m_posted;
+        if (m_pool) {
+            schedule = !m_scheduled;
+            m_scheduled = true;
+        } else if (!m_running) {
+            m_running = true;
+            m_stopRequested = false;
+            m_thread = std::thread(&Worker::run, this);
+            m_threadId.store(m_thread.get_id(), std::memory_order_relaxed);
+        }
+    }
+    if (schedule) {
+        m_pool->schedule(this);
+    } else if (!m_pool) {
+        m_condition.notify_one();
+    }
+}
+
+void Worker::flush() {
+    if (isWorkerThread()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const uint64_t target = m_posted;
+    m_doneCondition.wait(lock, [this, target]() { return m_completed >= target; });
+}
+
+void Worker::stop() {
+    if (m_pool) {
+        // The pool keeps running queued tasks; once the Worker is off the pool it may be destroyed
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this]() { return !m_scheduled; });
+        return;
+    }
+
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+        thread = std::move(m_thread);
+    }
+    m_condition.notify_one();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+size_t Worker::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<size_t>(m_posted - m_completed);
+}
+
+void Worker::run() {
+    Tracer::getInstance().setThreadName(m_name);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_condition.wait(lock, [this]() { return m_stopRequested || !m_tasks.empty(); });
+        if (m_tasks.empty()) {
+            // The next post() starts a new thread
+            m_running = false;
+            m_threadId.store(std::thread::id(), std::memory_order_relaxed);
+            break;
+        }
+
+        // Queued tasks still run on stop() so a final logout reaches the SDK
+        Task task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        lock.unlock();
+
+        task();
+
+        lock.lock();
+        ++m_completed;
+        m_doneCondition.notify_all();
+    }
+}
+
+void Worker::runQueued() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_threadId.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    for (size_t i = 0; i < POOL_BATCH && !m_tasks.empty(); ++i) {
+        Task task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        lock.unlock();
+
+        {
+            TECH3C_TRACE_SCOPE("worker", m_name);
+            task();
+        }
+        task = nullptr;
+
+        lock.lock();
+        ++m_completed;
+        m_doneCondition.notify_all();
+    }
+    m_threadId.store(std::thread::id(), std::memory_order_relaxed);
+
+    if (!m_tasks.empty()) {
+        // Still scheduled, so stop() keeps waiting; back of the line behind the other Workers
+        lock.unlock();
+        m_pool->schedule(this);
+        return;
+    }
+    // The Worker may be destroyed as soon as the lock is released
+    m_scheduled = false;
+    m_doneCondition.notify_all();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tech3c {
+
+    class Worker;
+
+    // Fixed set of threads shared by many Workers, so thousands of sessions do not each hold their
+    // own threads. Threads start with the first task. A Worker runs on one pool thread at a time and
+    // gives its thread up after a few tasks, so a busy Worker cannot starve the others.
+    class WorkerPool {
+    public:
+        // name labels the threads in traces, a string literal
+        WorkerPool(const char* name, size_t threadCount);
+        // Every Worker using the pool must be gone by now
+        ~WorkerPool();
+
+        size_t getThreadCount() const { return m_threadCount; }
+
+    private:
+        friend class Worker;
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // Queues a Worker that has tasks and is not queued or running yet
+        void schedule(Worker* worker);
+        void run();
+
+        const char* m_name;
+        const size_t m_threadCount;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<Worker*> m_ready;
+        std::vector<std::thread> m_threads;
+        bool m_stopping;
+    };
+
+    // Runs posted tasks in FIFO order, one at a time. Without a pool it has its own thread, started
+    // with the first post() and joined by stop(); posting after stop() starts it again. With a pool
+    // its tasks run on the pool threads instead, still in order and never two at once.
+    class Worker {
+    public:
+        using Task = std::function<void()>;
+
+        // name labels the thread in traces, a string literal; pool must outlive the Worker
+        explicit Worker(const char* name, WorkerPool* pool = nullptr);
+        ~Worker();
+
+        void post(Task task);
+        // Blocks until every task posted before the call has run. Runs nothing and returns right
+        // away on the worker thread itself, a task cannot wait for the ones queued behind it.
+        void flush();
+        // Runs what is still queued, including tasks posted meanwhile, then joins the thread (with
+        // a pool, waits until no pool thread runs this Worker); never call from a task
+        void stop();
+
+        bool isWorkerThread() const { return std::this_thread::get_id() == m_threadId.load(std::memory_order_relaxed); }
+        size_t getPendingCount() const;
+
+    private:
+        friend class WorkerPool;
+
+        Worker(const Worker&) = delete;
+        Worker& operator=(const Worker&) = delete;
+
+        void run();
+        // Pool thread: runs a batch of tasks, then queues the Worker again if more are waiting
+        void runQueued();
+
+        static constexpr size_t POOL_BATCH = 8;
+
+        const char* m_name;
+        WorkerPool* m_pool;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::condition_variable m_doneCondition;
+        std::deque<Task> m_tasks;
+        std::thread m_thread;
+        std::atomic<std::thread::id> m_threadId;
+        bool m_running;         // A thread is taking tasks
+        bool m_stopRequested;   // It exits once the queue is empty
+        bool m_scheduled;       // Pool only: queued on or running on a pool thread
+
+        // Tasks are numbered as posted; flush() waits until m_completed reaches its number
+        uint64_t m_posted;
+        uint64_t m_completed;
+    };
+}
@@ -0,0 +1,145 @@
+// tech3c_channel_layout_test: the event records native code reads are byte for byte the ones
+// Tech3CChannel.java writes. Both sides are checked against Tech3CChannelRecords.txt: here with
+// ChannelWriter / ChannelReader, in Java by Tech3CChannelTest on a desktop JVM
+// (proj.android: gradlew :app:testDebugUnitTest).
+//
+//   tech3c_channel_layout_test path/to/Tech3CChannelRecords.txt
+//
+// Exits 1 on failure.
+
+#include "Tech3C/Tech3CBridgeChannel.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace tech3c;
+
+namespace {
+
+    // The records of Tech3CChannelRecords.txt, in file order; Tech3CChannelTest posts the same
+    struct EventRecord {
+        const char* name;
+        ChannelRecord type;
+        std::vector<std::string_view> strings;
+        std::vector<int64_t> longs;
+    };
+
+    const EventRecord RECORDS[] = {
+        { "LOGIN_SUCCESS", ChannelRecord::LOGIN_SUCCESS, { "user-1", "access", "refresh" }, { 2, 1700000000000 } },
+        { "REGISTER_SUCCESS", ChannelRecord::REGISTER_SUCCESS, { "user-2", "a", "" }, { -1 } },
+        // "Lỗi é ✓ 😀": 3, 2, 3 and 4 byte sequences
+        { "AUTH_ERROR", ChannelRecord::AUTH_ERROR, { "L\xe1\xbb\x97i \xc3\xa9 \xe2\x9c\x93 \xf0\x9f\x98\x80" }, {} },
+        { "AUTH_CANCELLED", ChannelRecord::AUTH_CANCELLED, {}, {} },
+        { "AUTH_SCREEN_OPENED", ChannelRecord::AUTH_SCREEN_OPENED, {}, {} },
+    };
+
+    // One record per line as hex bytes, whitespace ignored, # starts a comment line
+    bool loadGolden(const char* path, std::vector<std::vector<uint8_t>>& records) {
+        std::ifstream file(path);
+        if (!file) {
+            std::fprintf(stderr, "cannot open %s\n", path);
+            return false;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::vector<uint8_t> bytes;
+            std::string digits;
+            for (char c : line) {
+                if (c != ' ' && c != '\t' && c != '\r') {
+                    digits += c;
+                }
+            }
+            if (digits.size() % 2 != 0) {
+                std::fprintf(stderr, "odd number of hex digits in %s\n", path);
+                return false;
+            }
+            for (size_t i = 0; i < digits.size(); i += 2) {
+                bytes.push_back(static_cast<uint8_t>(std::stoul(digits.substr(i, 2), nullptr, 16)));
+            }
+            records.push_back(std::move(bytes));
+        }
+        return true;
+    }
+
+    // Writes record into an empty ring, compares it with golden and reads it back
+    bool checkRecord(const EventRecord& record, const std::vector<uint8_t>& golden) {
+        const size_t ringBytes = 1024;
+        std::vector<uint64_t> ring(ringBytes / sizeof(uint64_t), ~uint64_t(0));
+        ChannelWriter writer;
+        ChannelReader reader;
+        writer.attach(ring.data(), ringBytes);
+        reader.attach(ring.data(), ringBytes);
+
+        size_t payload = record.longs.size() * CHANNEL_LONG_BYTES;
+        for (std::string_view value : record.strings) {
+            payload += channelStringBytes(value);
+        }
+        if (!writer.begin(record.type, payload)) {
+            std::fprintf(stderr, "%s: begin failed\n", record.name);
+            return false;
+        }
+        for (std::string_view value : record.strings) {
+            writer.putString(value);
+        }
+        for (int64_t value : record.longs) {
+            writer.putLong(value);
+        }
+        const uint64_t tail = writer.commit();
+
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(ring.data());
+        if (tail != golden.size() || !std::equal(golden.begin(), golden.end(), bytes)) {
+            std::fprintf(stderr, "%s: differs from Tech3CChannelRecords.txt (%llu bytes written, %zu expected)\n",
+                         record.name, (unsigned long long)tail, golden.size());
+            return false;
+        }
+
+        size_t seen = 0;
+        bool fieldsMatch = true;
+        const uint64_t head = reader.read(tail, [&](ChannelFields& fields) {
+            ++seen;
+            fieldsMatch &= fields.getType() == record.type;
+            for (std::string_view expected : record.strings) {
+                std::string_view value;
+                fieldsMatch &= fields.getString(value) && value == expected;
+            }
+            for (int64_t expected : record.longs) {
+                int64_t value = 0;
+                fieldsMatch &= fields.getLong(value) && value == expected;
+            }
+        });
+        if (head != tail || seen != 1 || !fieldsMatch) {
+            std::fprintf(stderr, "%s: read back %zu records, fields %s\n", record.name, seen,
+                         fieldsMatch ? "match" : "differ");
+            return false;
+        }
+        std::printf("%s: ok\n", record.name);
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: %s Tech3CChannelRecords.txt\n", argv[0]);
+        return 2;
+    }
+    std::vector<std::vector<uint8_t>> golden;
+    if (!loadGolden(argv[1], golden)) {
+        return 1;
+    }
+    const size_t recordCount = sizeof(RECORDS) / sizeof(RECORDS[0]);
+    if (golden.size() != recordCount) {
+        std::fprintf(stderr, "%s has %zu records, expected %zu\n", argv[1], golden.size(), recordCount);
+        return 1;
+    }
+
+    bool passed = true;
+    for (size_t i = 0; i < recordCount; ++i) {
+        passed &= checkRecord(RECORDS[i], golden[i]);
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+// tech3c_dispatch_alloc_test: SDK events reach their callbacks without a heap allocation on the
+// dispatching thread. Events come off the ring by move and the callbacks are stored inline
+// (InplaceFunction), a regression in either shows up as a non-zero count.
+//
+// Runs a session of its own, dispatched by hand (dispatchOnFrame off) and never persisted, so
+// neither the scheduler nor the game's saved session is touched. Exits 1 on failure.
+
+#include "Tech3C/Tech3CSession.h"
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+
+using namespace tech3c;
+
+//------------------------------------------------------------------------
+// Allocation counting: every allocation goes through these, only the thread inside an
+// AllocationCounter scope is counted so SDK threads do not add noise
+
+namespace {
+    thread_local bool t_countAllocations = false;
+    thread_local uint64_t t_allocations = 0;
+
+    void* countedAlloc(size_t size) {
+        if (t_countAllocations) {
+            ++t_allocations;
+        }
+        if (void* p = std::malloc(size ? size : 1)) {
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+    const char* CLIENT_ID = "3cgame";
+    const char* CLIENT_SECRET = "test-secret";
+
+    // Token sizes in the range the SDK hands back for real accounts
+    const std::string TEST_USER_ID = "test-user-0000000001";
+    const std::string TEST_ACCESS_TOKEN(900, 'a');
+    const std::string TEST_REFRESH_TOKEN(300, 'r');
+
+    // Allocations made by the calling thread while alive
+    class AllocationCounter {
+    public:
+        AllocationCounter() : m_start(t_allocations) { t_countAllocations = true; }
+        ~AllocationCounter() { t_countAllocations = false; }
+        uint64_t count() const { return t_allocations - m_start; }
+
+    private:
+        uint64_t m_start;
+    };
+
+    struct EventCase {
+        const char* name;
+        std::function<void(Tech3CSession*)> post;
+    };
+
+    // Posts rounds of events outside the count and dispatches them inside it
+    bool checkEvent(const EventCase& eventCase) {
+        SessionOptions options;
+        options.dispatchOnFrame = false;
+        Tech3CSession session(options);
+        session.applyConfig(ConfigBuilder().debugMode(false).enableMaintenanceCheck(false).build());
+        if (!session.initialize(CLIENT_ID, CLIENT_SECRET)) {
+            std::fprintf(stderr, "%s: initialize failed\n", eventCase.name);
+            return false;
+        }
+
+        size_t delivered = 0;
+        session.setLoginSuccessCallback([&delivered](const UserInfo& user) { delivered += !user.userId.empty(); });
+        session.setRegisterSuccessCallback([&delivered](const UserInfo& user) { delivered += !user.userId.empty(); });
+        session.setErrorCallback([&delivered](const ErrorInfo& error) { delivered += error.code != 0; });
+        session.setCancelCallback([&delivered]() { ++delivered; });
+        session.setAuthScreenOpenedCallback([&delivered]() { ++delivered; });
+        session.setEventDispatchBudget(std::chrono::seconds(1));
+
+        const size_t rounds = 50;
+        const size_t eventsPerRound = 64;
+        uint64_t allocations = 0;
+        for (size_t round = 0; round < rounds; ++round) {
+            for (size_t i = 0; i < eventsPerRound; ++i) {
+                eventCase.post(&session);
+            }
+
+            AllocationCounter counter;
+            session.dispatchPendingEvents();
+            allocations += counter.count();
+        }
+        session.cleanup();
+
+        // A count of 0 means nothing when the events never arrived
+        if (delivered != rounds * eventsPerRound) {
+            std::fprintf(stderr, "%s: delivered %zu of %zu events\n", eventCase.name, delivered, rounds * eventsPerRound);
+            return false;
+        }
+        if (allocations != 0) {
+            std::fprintf(stderr, "%s: %llu allocations dispatching %zu events\n", eventCase.name,
+                         (unsigned long long)allocations, delivered);
+            return false;
+        }
+        std::printf("%s: ok\n", eventCase.name);
+        return true;
+    }
+}
+
+int main() {
+    const EventCase cases[] = {
+        { "loginSuccess", [](Tech3CSession* s) {
+            s->onLoginSuccess(TEST_USER_ID, TEST_ACCESS_TOKEN, TEST_REFRESH_TOKEN, (int)LoginType::ACCOUNT, 0);
+        } },
+        { "registerSuccess", [](Tech3CSession* s) {
+            s->onRegisterSuccess(TEST_USER_ID, TEST_ACCESS_TOKEN, TEST_REFRESH_TOKEN, 0);
+        } },
+        { "error", [](Tech3CSession* s) {
+            s->onError("test: the authentication server answered with an unexpected status");
+        } },
+        { "cancelled", [](Tech3CSession* s) { s->onAuthCancelled(); } },
+        { "screenOpened", [](Tech3CSession* s) { s->onAuthScreenOpened(); } },
+    };
+
+#if TECH3C_DESKTOP_BACKEND
+    // The sessions initialize against the in-process auth server unless TECH3C_AUTH_URL is set
+    SessionHost::setStandInServerEnabled(true);
+#endif
+
+    bool passed = true;
+    for (const EventCase& eventCase : cases) {
+        passed &= checkEvent(eventCase);
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,321 @@
+package dev.axmol.lib;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.CharBuffer;
+import java.nio.charset.CharsetEncoder;
+import java.nio.charset.CodingErrorAction;
+import java.nio.charset.StandardCharsets;
+
+/**
+ * Byte rings shared with native code through direct ByteBuffers, one per direction, so SDK
+ * callbacks reach C++ without a jstring per token and bridge calls arrive without one per field.
+ * The record layout is described in Tech3CBridgeChannel.h; keep both in sync.
+ *
+ * Posting an event makes no native call: the record is published through the volatile sEventTail
+ * and native code picks it up on its next frame (or on flush()), writing back sEventHead.
+ *
+ * Plain java.nio only, no Android classes, so it also runs on a desktop JVM (Tech3CChannelTest).
+ */
+public final class Tech3CChannel {
+    // Record types, see tech3c::ChannelRecord
+    static final int RECORD_PAD = 0;
+    static final int RECORD_LOGIN_SUCCESS = 1;
+    static final int RECORD_REGISTER_SUCCESS = 2;
+    static final int RECORD_AUTH_ERROR = 3;
+    static final int RECORD_AUTH_CANCELLED = 4;
+    static final int RECORD_AUTH_SCREEN_OPENED = 5;
+    static final int RECORD_SHOW_AUTH = 32;
+    static final int RECORD_LOGOUT = 33;
+    static final int RECORD_APPLY_CONFIG = 34;
+
+    private static final int HEADER_BYTES = 8;
+    private static final int LONG_BYTES = 8;
+    // Powers of two; an event that does not fit goes through the per-event native methods
+    private static final int EVENT_CAPACITY = 16 * 1024;
+    private static final int COMMAND_CAPACITY = 4 * 1024;
+
+    private static final ByteBuffer sEvents =
+            ByteBuffer.allocateDirect(EVENT_CAPACITY).order(ByteOrder.nativeOrder());
+    private static final ByteBuffer sCommands =
+            ByteBuffer.allocateDirect(COMMAND_CAPACITY).order(ByteOrder.nativeOrder());
+
+    // Event producer state, guarded by the class lock like every write to sEvents. Native code
+    // reads sEventTail and writes sEventHead through JNI, which keeps their volatile semantics:
+    // the tail is stored after the record bytes, the head after native code is done with them.
+    static volatile boolean sAttached = false;
+    static volatile long sEventHead = 0;
+    static volatile long sEventTail = 0;
+    private static int sCursor = 0;
+    private static int sRecordEnd = 0;
+    private static int sRecordSize = 0;
+
+    // Strings of the record being posted, encoded up front so its size is known before begin()
+    // and copied into the ring in one bulk put each; grows for unusually long values
+    private static final CharsetEncoder sEncoder = StandardCharsets.UTF_8.newEncoder()
+            .onMalformedInput(CodingErrorAction.REPLACE)
+            .onUnmappableCharacter(CodingErrorAction.REPLACE);
+    private static ByteBuffer sScratch = ByteBuffer.allocate(4 * 1024);
+    private static int sScratchRead = 0;
+
+    // Command consumer state, onCommands() only runs on the native SDK worker thread
+    private static long sCommandHead = 0;
+
+    private static native boolean nativeAttach(ByteBuffer events, ByteBuffer commands);
+    // Reads the events published so far, instead of waiting for the next frame
+    private static native void nativeFlushEvents();
+
+    private Tech3CChannel() {
+    }
+
+    /**
+     * Hand the buffers to native code, once per process and before Tech3CHelper.initialize().
+     * @return false if native code rejected them; the per-event native methods keep working
+     */
+    public static synchronized boolean attach() {
+        if (!sAttached) {
+            sAttached = nativeAttach(sEvents, sCommands);
+        }
+        return sAttached;
+    }
+
+    // Tech3CChannelTest stands in for native code: an empty ring it reads and moves sEventHead of
+    static synchronized ByteBuffer attachForTest() {
+        sAttached = true;
+        sEventHead = 0;
+        sEventTail = 0;
+        return sEvents;
+    }
+
+    /**
+     * Let native code read the events posted so far right away. Call it before a per-event
+     * Tech3CHelper.nativeOn* method, so that event does not overtake the ones still in the ring.
+     * Not synchronized: native code reads under a lock of its own.
+     */
+    public static void flush() {
+        if (sAttached && sEventHead != sEventTail) {
+            nativeFlushEvents();
+        }
+    }
+
+    // Events. Each returns false when the channel is not attached or the ring has no room;
+    // the caller then flush()es and uses the matching Tech3CHelper.nativeOn* method.
+
+    public static synchronized boolean postLoginSuccess(String userId, String accessToken, String refreshToken,
+                                                        int loginType, long expiryTime) {
+        if (!sAttached) {
+            return false;
+        }
+        sScratch.clear();
+        sScratchRead = 0;
+        final int userIdBytes = encode(userId);
+        final int accessTokenBytes = encode(accessToken);
+        final int refreshTokenBytes = encode(refreshToken);
+        if (!begin(RECORD_LOGIN_SUCCESS, stringBytes(userIdBytes) + stringBytes(accessTokenBytes)
+                + stringBytes(refreshTokenBytes) + 2 * LONG_BYTES)) {
+            return false;
+        }
+        putString(userIdBytes);
+        putString(accessTokenBytes);
+        putString(refreshTokenBytes);
+        putLong(loginType);
+        putLong(expiryTime);
+        commit();
+        return true;
+    }
+
+    public static synchronized boolean postRegisterSuccess(String userId, String accessToken, String refreshToken,
+                                                           long expiryTime) {
+        if (!sAttached) {
+            return false;
+        }
+        sScratch.clear();
+        sScratchRead = 0;
+        final int userIdBytes = encode(userId);
+        final int accessTokenBytes = encode(accessToken);
+        final int refreshTokenBytes = encode(refreshToken);
+        if (!begin(RECORD_REGISTER_SUCCESS, stringBytes(userIdBytes) + stringBytes(accessTokenBytes)
+                + stringBytes(refreshTokenBytes) + LONG_BYTES)) {
+            return false;
+        }
+        putString(userIdBytes);
+        putString(accessTokenBytes);
+        putString(refreshTokenBytes);
+        putLong(expiryTime);
+        commit();
+        return true;
+    }
+
+    public static synchronized boolean postError(String message) {
+        if (!sAttached) {
+            return false;
+        }
+        sScratch.clear();
+        sScratchRead = 0;
+        final int messageBytes = encode(message);
+        if (!begin(RECORD_AUTH_ERROR, stringBytes(messageBytes))) {
+            return false;
+        }
+        putString(messageBytes);
+        commit();
+        return true;
+    }
+
+    public static synchronized boolean postAuthCancelled() {
+        if (!begin(RECORD_AUTH_CANCELLED, 0)) {
+            return false;
+        }
+        commit();
+        return true;
+    }
+
+    public static synchronized boolean postAuthScreenOpened() {
+        if (!begin(RECORD_AUTH_SCREEN_OPENED, 0)) {
+            return false;
+        }
+        commit();
+        return true;
+    }
+
+    /**
+     * Called by native code on its SDK worker thread with the commands written before tail.
+     * Every record up to tail counts as read when this returns, even if a command throws.
+     */
+    static void onCommands(long tail) {
+        try {
+            while (sCommandHead < tail) {
+                final int offset = (int) (sCommandHead & (COMMAND_CAPACITY - 1));
+                final int size = sCommands.getInt(offset);
+                final int type = sCommands.getShort(offset + 4);
+                if (size < HEADER_BYTES || size > COMMAND_CAPACITY - offset) {
+                    break;
+                }
+                runCommand(type, offset + HEADER_BYTES);
+                sCommandHead += size;
+            }
+        } finally {
+            sCommandHead = tail;
+        }
+    }
+
+    private static void runCommand(int type, int position) {
+        switch (type) {
+            case RECORD_SHOW_AUTH:
+                Tech3CHelper.showAuth();
+                break;
+            case RECORD_LOGOUT:
+                Tech3CHelper.logout();
+                break;
+            case RECORD_APPLY_CONFIG: {
+                final int mask = (int) sCommands.getLong(position);
+                final boolean debug = sCommands.getLong(position + 8) != 0;
+                final int uiMode = (int) sCommands.getLong(position + 16);
+                final int language = (int) sCommands.getLong(position + 24);
+                final int orientation = (int) sCommands.getLong(position + 32);
+                final boolean enableGuestLogin = sCommands.getLong(position + 40) != 0;
+                final boolean disableExitLogin = sCommands.getLong(position + 48) != 0;
+                final boolean requireOtp = sCommands.getLong(position + 56) != 0;
+                final boolean enableMaintenanceCheck = sCommands.getLong(position + 64) != 0;
+                final int ipBytes = sCommands.getInt(position + 72);
+                final String ip = ipBytes > 0 ? readString(position + 76, ipBytes) : "";
+                final boolean enableRequireBOD = sCommands.getLong(position + 76 + ipBytes) != 0;
+                Tech3CHelper.applyConfig(mask, debug, uiMode, language, orientation, enableGuestLogin,
+                        disableExitLogin, requireOtp, enableMaintenanceCheck, ip, enableRequireBOD);
+                break;
+            }
+            default:
+                // A newer native side's command, skipped
+                break;
+        }
+    }
+
+    private static String readString(int position, int length) {
+        final byte[] bytes = new byte[length];
+        sCommands.position(position);
+        sCommands.get(bytes);
+        return new String(bytes, StandardCharsets.UTF_8);
+    }
+
+    // Event ring writer, caller holds the class lock
+
+    private static int stringBytes(int utf8Bytes) {
+        return 4 + utf8Bytes;
+    }
+
+    private static boolean begin(int type, int payloadBytes) {
+        if (!sAttached) {
+            return false;
+        }
+        final int size = (HEADER_BYTES + payloadBytes + HEADER_BYTES - 1) & ~(HEADER_BYTES - 1);
+        if (size > EVENT_CAPACITY) {
+            return false;
+        }
+        final long free = EVENT_CAPACITY - (sEventTail - sEventHead);
+        int offset = (int) (sEventTail & (EVENT_CAPACITY - 1));
+        final int contiguous = EVENT_CAPACITY - offset;
+        if (size > contiguous) {
+            if (contiguous + size > free) {
+                return false;
+            }
+            writeHeader(offset, contiguous, RECORD_PAD);
+            sEventTail += contiguous;
+            offset = 0;
+        } else if (size > free) {
+            return false;
+        }
+        writeHeader(offset, size, type);
+        sCursor = offset + HEADER_BYTES;
+        sRecordEnd = offset + size;
+        sRecordSize = size;
+        return true;
+    }
+
+    private static void commit() {
+        while (sCursor < sRecordEnd) {
+            sEvents.put(sCursor++, (byte) 0);
+        }
+        // Publishes the record, native code never reads past sEventTail
+        sEventTail += sRecordSize;
+    }
+
+    private static void writeHeader(int offset, int size, int type) {
+        sEvents.putInt(offset, size);
+        sEvents.putShort(offset + 4, (short) type);
+        sEvents.putShort(offset + 6, (short) 0);
+    }
+
+    private static void putLong(long value) {
+        sEvents.putLong(sCursor, value);
+        sCursor += LONG_BYTES;
+    }
+
+    // Copies the next string encode() left in sScratch
+    private static void putString(int utf8Bytes) {
+        sEvents.putInt(sCursor, utf8Bytes);
+        sCursor += 4;
+        sEvents.position(sCursor);
+        sEvents.put(sScratch.array(), sScratchRead, utf8Bytes);
+        sScratchRead += utf8Bytes;
+        sCursor += utf8Bytes;
+    }
+
+    // Appends value as UTF-8 to sScratch and returns its byte count, null is written as empty.
+    // Unpaired surrogates become '?', like String.getBytes(UTF_8).
+    private static int encode(String value) {
+        if (value == null || value.isEmpty()) {
+            return 0;
+        }
+        final int start = sScratch.position();
+        final int maxBytes = (int) (value.length() * sEncoder.maxBytesPerChar());
+        if (sScratch.remaining() < maxBytes) {
+            final ByteBuffer grown = ByteBuffer.allocate(Math.max(2 * sScratch.capacity(), start + maxBytes));
+            sScratch.flip();
+            grown.put(sScratch);
+            sScratch = grown;
+        }
+        sEncoder.reset();
+        sEncoder.encode(CharBuffer.wrap(value), sScratch, true);
+        sEncoder.flush(sScratch);
+        return sScratch.position() - start;
+    }
+}
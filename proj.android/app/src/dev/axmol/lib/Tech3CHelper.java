@@ -20,7 +20,7 @@ public class Tech3CHelper {
     private static WeakReference<Activity> sCurrentActivityRef;
     private static boolean sIsInitialized = false;
 
-    // Native callback methods
+    // Native callback methods, for events that do not fit the Tech3CChannel ring
     public static native void nativeOnLoginSuccess(String userId, String accessToken, String refreshToken, int loginType, long expiryTime);
     public static native void nativeOnRegisterSuccess(String userId, String accessToken, String refreshToken, long expiryTime);
     public static native void nativeOnError(String error);
@@ -37,10 +37,16 @@ public class Tech3CHelper {
             sAppContext = activity.getApplicationContext();
             Log.d(TAG, "Application context set from activity: " + activity.getClass().getSimpleName());
         }
+        // Native code is loaded by now and holds none of its locks
+        if (activity != null && !Tech3CChannel.attach()) {
+            Log.w(TAG, "Tech3CChannel not attached, using per-event native calls");
+        }
     }
 
     /**
-     * Initialize Tech3C SDK
+     * Initialize Tech3C SDK. Its own errors skip Tech3CChannel, whose records native code only
+     * reads on its next frame, so that native initialize() sees them before this returns.
+     * A failure is reported through nativeOnError before returning, which fails native initialize().
      * @param clientId Client ID
      * @param clientSecret Client Secret
      */
@@ -76,31 +82,43 @@ public class Tech3CHelper {
                     @Override
                     public void onLoginSuccess(String userId, String accessToken, String refreshToken, LoginType loginType, long expiryTime) {
                         Log.d(TAG, "Login success: " + userId + ", loginType: " + loginType);
-                        nativeOnLoginSuccess(userId, accessToken, refreshToken, loginType.ordinal(), expiryTime);
+                        if (!Tech3CChannel.postLoginSuccess(userId, accessToken, refreshToken, loginType.ordinal(), expiryTime)) {
+                            Tech3CChannel.flush();
+                            nativeOnLoginSuccess(userId, accessToken, refreshToken, loginType.ordinal(), expiryTime);
+                        }
                     }
 
                     @Override
                     public void onRegisterSuccess(String accessToken, String refreshToken, String userId, long expiryTime) {
                         Log.d(TAG, "Register success: " + userId);
-                        nativeOnRegisterSuccess(userId, accessToken, refreshToken, expiryTime);
+                        if (!Tech3CChannel.postRegisterSuccess(userId, accessToken, refreshToken, expiryTime)) {
+                            Tech3CChannel.flush();
+                            nativeOnRegisterSuccess(userId, accessToken, refreshToken, expiryTime);
+                        }
                     }
 
                     @Override
                     public void onAuthCancelled() {
                         Log.d(TAG, "Auth cancelled by user");
-                        nativeOnAuthCancelled();
+                        if (!Tech3CChannel.postAuthCancelled()) {
+                            Tech3CChannel.flush();
+                            nativeOnAuthCancelled();
+                        }
                     }
 
                     @Override
                     public void onAuthScreenOpened() {
                         Log.d(TAG, "Auth screen opened");
-                        nativeOnAuthScreenOpened();
+                        if (!Tech3CChannel.postAuthScreenOpened()) {
+                            Tech3CChannel.flush();
+                            nativeOnAuthScreenOpened();
+                        }
                     }
 
                     @Override
                     public void onError(Tech3CIdException exception) {
                         Log.e(TAG, "Auth error: " + exception.getMessage(), exception);
-                        nativeOnError(exception.getMessage() != null ? exception.getMessage() : "Unknown error");
+                        reportError(exception.getMessage() != null ? exception.getMessage() : "Unknown error");
                     }
                 });
 
@@ -114,6 +132,17 @@ public class Tech3CHelper {
         }
     }
 
+    /**
+     * Report an error to native code, through Tech3CChannel when it has room
+     * @param error Error message
+     */
+    private static void reportError(String error) {
+        if (!Tech3CChannel.postError(error)) {
+            Tech3CChannel.flush();
+            nativeOnError(error);
+        }
+    }
+
     /**
      * Get current activity safely
      * @return Current activity or null if not available
@@ -128,14 +157,14 @@ public class Tech3CHelper {
     public static void showAuth() {
         if (!sIsInitialized) {
             Log.e(TAG, "SDK not initialized, cannot show auth");
-            nativeOnError("SDK not initialized");
+            reportError("SDK not initialized");
             return;
         }
 
         Activity currentActivity = getCurrentActivity();
         if (currentActivity == null) {
             Log.e(TAG, "Current activity is null, cannot show auth");
-            nativeOnError("Current activity is null");
+            reportError("Current activity is null");
             return;
         }
 
@@ -144,7 +173,7 @@ public class Tech3CHelper {
             Tech3CIdController.shared().showAuth(currentActivity);
         } catch (Exception e) {
             Log.e(TAG, "Failed to show auth", e);
-            nativeOnError("Failed to show auth: " + (e.getMessage() != null ? e.getMessage() : "Unknown error"));
+            reportError("Failed to show auth: " + (e.getMessage() != null ? e.getMessage() : "Unknown error"));
         }
     }
 
@@ -213,7 +242,7 @@ public class Tech3CHelper {
         }
 
         try {
-            UiMode mode = uiMode == 1 ? UiMode.FULLSCREEN : UiMode.DIALOG;
+            UiMode mode = toUiMode(uiMode);
             Tech3CIdController.shared().setUiMode(mode);
             Log.d(TAG, "UI mode set to: " + mode);
         } catch (Exception e) {
@@ -232,13 +261,7 @@ public class Tech3CHelper {
         }
 
         try {
-            OrientationMode orientationMode;
-            switch (orientation) {
-                case 1: orientationMode = OrientationMode.PORTRAIT; break;
-                case 2: orientationMode = OrientationMode.LANDSCAPE; break;
-                default: orientationMode = OrientationMode.AUTO; break;
-            }
-
+            OrientationMode orientationMode = toOrientationMode(orientation);
             Tech3CIdController.shared().setOrientation(orientationMode);
             Log.d(TAG, "Orientation set to: " + orientationMode);
         } catch (Exception e) {
@@ -257,16 +280,7 @@ public class Tech3CHelper {
         }
 
         try {
-            Language lang;
-            switch (language) {
-                case 1: lang = Language.VIETNAMESE; break;
-                case 2: lang = Language.CHINESE; break;
-                case 3: lang = Language.KHMER; break;
-                case 4: lang = Language.LAO; break;
-                case 5: lang = Language.THAI; break;
-                default: lang = Language.ENGLISH; break;
-            }
-
+            Language lang = toLanguage(language);
             Tech3CIdController.shared().setLanguageDisplay(lang);
             Log.d(TAG, "Language set to: " + lang);
         } catch (Exception e) {
@@ -328,13 +342,85 @@ public class Tech3CHelper {
         }
     }
 
+    // Config field bits, keep in sync with tech3c::ConfigField
+    private static final int CONFIG_DEBUG_MODE = 1 << 0;
+    private static final int CONFIG_UI_MODE = 1 << 1;
+    private static final int CONFIG_LANGUAGE = 1 << 2;
+    private static final int CONFIG_ORIENTATION = 1 << 3;
+    private static final int CONFIG_GUEST_LOGIN = 1 << 4;
+    private static final int CONFIG_DISABLE_EXIT_LOGIN = 1 << 5;
+    private static final int CONFIG_REQUIRE_OTP = 1 << 6;
+    private static final int CONFIG_MAINTENANCE_CHECK = 1 << 7;
+    private static final int CONFIG_IP_MAINTENANCE_CHECK = 1 << 8;
+
+    /**
+     * Apply several configuration values in a single bridge call
+     * @param mask Bit mask of the fields to apply (see tech3c::ConfigField)
+     * @param debug Debug mode enabled
+     * @param uiMode UI mode (0 = Dialog, 1 = Fullscreen)
+     * @param language Language code (0=EN, 1=VI, 2=CN, 3=KH, 4=LA, 5=TH)
+     * @param orientation Orientation mode (0 = Auto, 1 = Portrait, 2 = Landscape)
+     * @param enableGuestLogin Enable guest login
+     * @param disableExitLogin Disable exit login
+     * @param requireOtp Require OTP
+     * @param enableMaintenanceCheck Enable maintenance check
+     * @param ipMaintenanceCheck IP address for maintenance check
+     * @param enableRequireBOD Require BOD, not supported by the Android SDK yet
+     * @throws IllegalStateException if the SDK is not initialized. Exceptions from the SDK propagate
+     *         too: native code reports them as error 1025 and sends the fields again with the next push.
+     */
+    public static void applyConfig(int mask, boolean debug, int uiMode, int language, int orientation,
+                                   boolean enableGuestLogin, boolean disableExitLogin, boolean requireOtp,
+                                   boolean enableMaintenanceCheck, String ipMaintenanceCheck, boolean enableRequireBOD) {
+        if (!sIsInitialized) {
+            throw new IllegalStateException("SDK not initialized");
+        }
+
+        Tech3CIdController controller = Tech3CIdController.shared();
+        if ((mask & CONFIG_DEBUG_MODE) != 0) controller.setDebug(debug);
+        if ((mask & CONFIG_UI_MODE) != 0) controller.setUiMode(toUiMode(uiMode));
+        if ((mask & CONFIG_LANGUAGE) != 0) controller.setLanguageDisplay(toLanguage(language));
+        if ((mask & CONFIG_ORIENTATION) != 0) controller.setOrientation(toOrientationMode(orientation));
+        if ((mask & CONFIG_GUEST_LOGIN) != 0) controller.setEnableGuestLogin(enableGuestLogin);
+        if ((mask & CONFIG_DISABLE_EXIT_LOGIN) != 0) controller.setDisableExitLogin(disableExitLogin);
+        if ((mask & CONFIG_REQUIRE_OTP) != 0) controller.setIsRequireOtp(requireOtp);
+        if ((mask & CONFIG_MAINTENANCE_CHECK) != 0) controller.setEnableMaintenanceCheck(enableMaintenanceCheck);
+        if ((mask & CONFIG_IP_MAINTENANCE_CHECK) != 0) {
+            controller.setIpMaintenanceCheck(ipMaintenanceCheck != null ? ipMaintenanceCheck : "");
+        }
+        Log.d(TAG, "Config applied, mask: 0x" + Integer.toHexString(mask));
+    }
+
+    private static UiMode toUiMode(int uiMode) {
+        return uiMode == 1 ? UiMode.FULLSCREEN : UiMode.DIALOG;
+    }
+
+    private static OrientationMode toOrientationMode(int orientation) {
+        switch (orientation) {
+            case 1: return OrientationMode.PORTRAIT;
+            case 2: return OrientationMode.LANDSCAPE;
+            default: return OrientationMode.AUTO;
+        }
+    }
+
+    private static Language toLanguage(int language) {
+        switch (language) {
+            case 1: return Language.VIETNAMESE;
+            case 2: return Language.CHINESE;
+            case 3: return Language.KHMER;
+            case 4: return Language.LAO;
+            case 5: return Language.THAI;
+            default: return Language.ENGLISH;
+        }
+    }
+
     /**
      * Logout user
      */
     public static void logout() {
         if (!sIsInitialized) {
             Log.e(TAG, "SDK not initialized, cannot logout");
-            nativeOnError("SDK not initialized");
+            reportError("SDK not initialized");
             return;
         }
 
@@ -346,7 +432,7 @@ public class Tech3CHelper {
 
         } catch (Exception e) {
             Log.e(TAG, "Failed to logout", e);
-            nativeOnError("Failed to logout: " + (e.getMessage() != null ? e.getMessage() : "Unknown error"));
+            reportError("Failed to logout: " + (e.getMessage() != null ? e.getMessage() : "Unknown error"));
         }
     }
 
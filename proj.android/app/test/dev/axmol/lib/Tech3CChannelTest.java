@@ -0,0 +1,178 @@
+package dev.axmol.lib;
+
+import static org.junit.Assert.assertArrayEquals;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertTrue;
+import static org.junit.Assume.assumeTrue;
+
+import org.junit.Before;
+import org.junit.Test;
+
+import java.io.File;
+import java.io.IOException;
+import java.lang.reflect.Field;
+import java.lang.reflect.Modifier;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+/**
+ * Tech3CChannel's event records against the native side, on a desktop JVM (no native library,
+ * the test reads the ring itself). Record types and sizes come from Tech3CBridgeChannel.h, the
+ * bytes from Tests/Tech3CChannelRecords.txt, which Tech3CChannelLayoutTest.cpp checks
+ * ChannelWriter / ChannelReader against.
+ */
+public class Tech3CChannelTest {
+    // Repo root, relative to the app module gradle runs unit tests in
+    private static final File ROOT = new File(System.getProperty("tech3c.root", "../.."));
+
+    private ByteBuffer mEvents;
+
+    @Before
+    public void setUp() {
+        mEvents = Tech3CChannel.attachForTest();
+    }
+
+    @Test
+    public void constantsMatchHeader() throws Exception {
+        final String header = read("Source/Tech3C/Tech3CBridgeChannel.h");
+        final Matcher body = Pattern.compile("enum class ChannelRecord[^{]*\\{([^}]*)\\}").matcher(header);
+        assertTrue("tech3c::ChannelRecord not found", body.find());
+
+        final Matcher entry = Pattern.compile("(\\w+)\\s*=\\s*(\\d+)").matcher(body.group(1));
+        int entries = 0;
+        while (entry.find()) {
+            assertEquals(entry.group(1), Integer.parseInt(entry.group(2)), constant("RECORD_" + entry.group(1)));
+            ++entries;
+        }
+        int recordConstants = 0;
+        for (Field field : Tech3CChannel.class.getDeclaredFields()) {
+            if (field.getName().startsWith("RECORD_") && Modifier.isStatic(field.getModifiers())) {
+                ++recordConstants;
+            }
+        }
+        assertEquals("record types in Tech3CChannel and tech3c::ChannelRecord", recordConstants, entries);
+
+        assertEquals(headerConstant(header, "CHANNEL_RECORD_HEADER_BYTES"), constant("HEADER_BYTES"));
+        assertEquals(headerConstant(header, "CHANNEL_LONG_BYTES"), constant("LONG_BYTES"));
+    }
+
+    @Test
+    public void recordsMatchNativeLayout() throws Exception {
+        assumeTrue("Tech3CChannelRecords.txt is little-endian", ByteOrder.nativeOrder() == ByteOrder.LITTLE_ENDIAN);
+        final List<byte[]> records = readRecords("Tests/Tech3CChannelRecords.txt");
+        assertEquals(5, records.size());
+
+        assertTrue(Tech3CChannel.postLoginSuccess("user-1", "access", "refresh", 2, 1700000000000L));
+        assertNextRecord(records.get(0));
+        assertTrue(Tech3CChannel.postRegisterSuccess("user-2", "a", null, -1));
+        assertNextRecord(records.get(1));
+        assertTrue(Tech3CChannel.postError("L\u1ed7i \u00e9 \u2713 \ud83d\ude00"));
+        assertNextRecord(records.get(2));
+        assertTrue(Tech3CChannel.postAuthCancelled());
+        assertNextRecord(records.get(3));
+        assertTrue(Tech3CChannel.postAuthScreenOpened());
+        assertNextRecord(records.get(4));
+    }
+
+    @Test
+    public void unpairedSurrogateBecomesQuestionMark() {
+        assertTrue(Tech3CChannel.postError("a\ud800b"));
+        assertEquals(3, mEvents.getInt(8));
+        assertEquals('a', mEvents.get(12));
+        assertEquals('?', mEvents.get(13));
+        assertEquals('b', mEvents.get(14));
+    }
+
+    @Test
+    public void longStringIsWrittenWhole() {
+        final StringBuilder message = new StringBuilder();
+        for (int i = 0; i < 3000; ++i) {
+            message.append('\u00e9');
+        }
+        assertTrue(Tech3CChannel.postError(message.toString()));
+        assertEquals(6000, mEvents.getInt(8));
+        assertEquals((byte) 0xc3, mEvents.get(12));
+        assertEquals((byte) 0xa9, mEvents.get(12 + 5999));
+    }
+
+    @Test
+    public void recordAtTheEndWrapsAfterPad() {
+        final int capacity = mEvents.capacity();
+        while (Tech3CChannel.sEventTail < capacity - 8) {
+            assertTrue(Tech3CChannel.postAuthCancelled());
+        }
+        Tech3CChannel.sEventHead = Tech3CChannel.sEventTail;
+
+        assertTrue(Tech3CChannel.postError("more than the 8 bytes left"));
+        assertEquals(8, mEvents.getInt(capacity - 8));
+        assertEquals(Tech3CChannel.RECORD_PAD, mEvents.getShort(capacity - 4));
+        assertEquals(Tech3CChannel.RECORD_AUTH_ERROR, mEvents.getShort(4));
+        assertEquals(capacity + mEvents.getInt(0), Tech3CChannel.sEventTail);
+    }
+
+    @Test
+    public void fullRingRejectsUntilRead() {
+        final int capacity = mEvents.capacity();
+        int posted = 0;
+        while (Tech3CChannel.postAuthScreenOpened()) {
+            ++posted;
+        }
+        assertEquals(capacity / 8, posted);
+        assertFalse(Tech3CChannel.postAuthCancelled());
+
+        Tech3CChannel.sEventHead = Tech3CChannel.sEventTail;
+        assertTrue(Tech3CChannel.postAuthCancelled());
+    }
+
+    // Compares the record after sEventHead with expected and consumes it, like native code would
+    private void assertNextRecord(byte[] expected) {
+        final long head = Tech3CChannel.sEventHead;
+        final long tail = Tech3CChannel.sEventTail;
+        final byte[] actual = new byte[(int) (tail - head)];
+        for (int i = 0; i < actual.length; ++i) {
+            actual[i] = mEvents.get((int) ((head + i) & (mEvents.capacity() - 1)));
+        }
+        assertArrayEquals(expected, actual);
+        Tech3CChannel.sEventHead = tail;
+    }
+
+    private static int constant(String name) throws ReflectiveOperationException {
+        final Field field = Tech3CChannel.class.getDeclaredField(name);
+        field.setAccessible(true);
+        return field.getInt(null);
+    }
+
+    private static int headerConstant(String header, String name) {
+        final Matcher matcher = Pattern.compile(name + "\\s*=\\s*(\\d+)").matcher(header);
+        assertTrue(name + " not found", matcher.find());
+        return Integer.parseInt(matcher.group(1));
+    }
+
+    private static String read(String path) throws IOException {
+        return new String(Files.readAllBytes(new File(ROOT, path).toPath()), StandardCharsets.UTF_8);
+    }
+
+    // One record per line as hex bytes, whitespace ignored, # starts a comment line
+    private static List<byte[]> readRecords(String path) throws IOException {
+        final List<byte[]> records = new ArrayList<>();
+        for (String line : read(path).split("\n")) {
+            final String digits = line.replaceAll("\\s", "");
+            if (digits.isEmpty() || digits.startsWith("#")) {
+                continue;
+            }
+            final byte[] bytes = new byte[digits.length() / 2];
+            for (int i = 0; i < bytes.length; ++i) {
+                bytes[i] = (byte) Integer.parseInt(digits.substring(2 * i, 2 * i + 2), 16);
+            }
+            records.add(bytes);
+        }
+        return records;
+    }
+}